@@ -0,0 +1,17 @@
+[[cpp4r::init]] void arrow_init(DllInfo* dll) { cpp4r::arrow::init(dll, "cpp4rtest"); }
+
+// Export `x` and import it back, as a consumer in another library would
+[[cpp4r::register]] SEXP cpp4r_arrow_roundtrip_(SEXP x) {
+  ArrowSchema schema;
+  ArrowArray array;
+  if (Rf_inherits(x, "data.frame")) {
+    cpp4r::arrow::export_data_frame(x, &schema, &array);
+    cpp4r::writable::data_frame out = cpp4r::arrow::import_data_frame(&schema, &array);
+    schema.release(&schema);
+    return out;
+  }
+  cpp4r::arrow::export_array(x, &schema, &array);
+  cpp4r::sexp out = cpp4r::arrow::import_array(&schema, &array);
+  schema.release(&schema);
+  return out;
+}
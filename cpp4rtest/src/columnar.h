@@ -0,0 +1,13 @@
+[[cpp4r::register]] void cpp4r_write_columnar_(cpp4r::data_frame df, std::string path) {
+  cpp4r::write_columnar(df, path);
+}
+
+[[cpp4r::register]] SEXP cpp4r_read_columnar_(std::string path, cpp4r::strings columns,
+                                              double begin, double end, bool copy) {
+  std::vector<std::string> names;
+  for (const auto& column : columns) {
+    names.push_back(column);
+  }
+  return cpp4r::read_columnar(path, names, static_cast<R_xlen_t>(begin),
+                              static_cast<R_xlen_t>(end), copy);
+}
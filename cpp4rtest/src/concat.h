@@ -0,0 +1,7 @@
+[[cpp4r::register]] SEXP cpp4r_concat_(cpp4r::list_of<cpp4r::doubles> pieces) {
+  return cpp4r::concat(pieces);
+}
+
+[[cpp4r::register]] SEXP cpp4r_rbind_(cpp4r::list_of<cpp4r::data_frame> frames) {
+  return cpp4r::rbind(frames);
+}
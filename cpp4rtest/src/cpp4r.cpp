@@ -14,6 +14,188 @@ extern "C" SEXP _cpp4rtest_cpp4r_add_vec_for_(SEXP x, SEXP num) {
     return cpp4r::as_sexp(cpp4r_add_vec_for_(cpp4r::as_cpp<cpp4r::decay_t<cpp4r::writable::doubles>>(x), cpp4r::as_cpp<cpp4r::decay_t<double>>(num)));
   END_CPP4R
 }
+// arrow.h
+SEXP cpp4r_arrow_roundtrip_(SEXP x);
+extern "C" SEXP _cpp4rtest_cpp4r_arrow_roundtrip_(SEXP x) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(cpp4r_arrow_roundtrip_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(x)));
+  END_CPP4R
+}
+// columnar.h
+void cpp4r_write_columnar_(cpp4r::data_frame df, std::string path);
+extern "C" SEXP _cpp4rtest_cpp4r_write_columnar_(SEXP df, SEXP path) {
+  BEGIN_CPP4R
+    cpp4r_write_columnar_(cpp4r::as_cpp<cpp4r::decay_t<cpp4r::data_frame>>(df), cpp4r::as_cpp<cpp4r::decay_t<std::string>>(path));
+    return R_NilValue;
+  END_CPP4R
+}
+// columnar.h
+SEXP cpp4r_read_columnar_(std::string path, cpp4r::strings columns, double begin, double end, bool copy);
+extern "C" SEXP _cpp4rtest_cpp4r_read_columnar_(SEXP path, SEXP columns, SEXP begin, SEXP end, SEXP copy) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(cpp4r_read_columnar_(cpp4r::as_cpp<cpp4r::decay_t<std::string>>(path), cpp4r::as_cpp<cpp4r::decay_t<cpp4r::strings>>(columns), cpp4r::as_cpp<cpp4r::decay_t<double>>(begin), cpp4r::as_cpp<cpp4r::decay_t<double>>(end), cpp4r::as_cpp<cpp4r::decay_t<bool>>(copy)));
+  END_CPP4R
+}
+// concat.h
+SEXP cpp4r_concat_(cpp4r::list_of<cpp4r::doubles> pieces);
+extern "C" SEXP _cpp4rtest_cpp4r_concat_(SEXP pieces) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(cpp4r_concat_(cpp4r::as_cpp<cpp4r::decay_t<cpp4r::list_of<cpp4r::doubles>>>(pieces)));
+  END_CPP4R
+}
+// concat.h
+SEXP cpp4r_rbind_(cpp4r::list_of<cpp4r::data_frame> frames);
+extern "C" SEXP _cpp4rtest_cpp4r_rbind_(SEXP frames) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(cpp4r_rbind_(cpp4r::as_cpp<cpp4r::decay_t<cpp4r::list_of<cpp4r::data_frame>>>(frames)));
+  END_CPP4R
+}
+// cpp4rtest/src/interrupt.h
+double interruptible_sum_(int n, int interval_ms);
+extern "C" SEXP _cpp4rtest_interruptible_sum_(SEXP n, SEXP interval_ms) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(interruptible_sum_(cpp4r::as_cpp<cpp4r::decay_t<int>>(n), cpp4r::as_cpp<cpp4r::decay_t<int>>(interval_ms)));
+  END_CPP4R
+}
+// cpp4rtest/src/interrupt.h
+double interruptible_parallel_sum_(int n, int threads);
+extern "C" SEXP _cpp4rtest_interruptible_parallel_sum_(SEXP n, SEXP threads) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(interruptible_parallel_sum_(cpp4r::as_cpp<cpp4r::decay_t<int>>(n), cpp4r::as_cpp<cpp4r::decay_t<int>>(threads)));
+  END_CPP4R
+}
+// cpp4rtest/src/map_batched.h
+cpp4r::writable::doubles map_batched_(SEXP fn, cpp4r::doubles x, R_xlen_t batch_size);
+extern "C" SEXP _cpp4rtest_map_batched_(SEXP fn, SEXP x, SEXP batch_size) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(map_batched_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(fn), cpp4r::as_cpp<cpp4r::decay_t<cpp4r::doubles>>(x), cpp4r::as_cpp<cpp4r::decay_t<R_xlen_t>>(batch_size)));
+  END_CPP4R
+}
+// cpp4rtest/src/map_batched.h
+cpp4r::writable::doubles map_elements_(SEXP fn, cpp4r::doubles x);
+extern "C" SEXP _cpp4rtest_map_elements_(SEXP fn, SEXP x) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(map_elements_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(fn), cpp4r::as_cpp<cpp4r::decay_t<cpp4r::doubles>>(x)));
+  END_CPP4R
+}
+// cpp4rtest/src/nothrow.h
+void noop_();
+extern "C" SEXP _cpp4rtest_noop_() {
+  BEGIN_CPP4R
+    noop_();
+    return R_NilValue;
+  END_CPP4R
+}
+// cpp4rtest/src/nothrow.h
+void noop_nothrow_();
+extern "C" SEXP _cpp4rtest_noop_nothrow_() {
+  noop_nothrow_();
+  return R_NilValue;
+}
+// cpp4rtest/src/nothrow.h
+double add_one_(double x);
+extern "C" SEXP _cpp4rtest_add_one_(SEXP x) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(add_one_(cpp4r::as_cpp<cpp4r::decay_t<double>>(x)));
+  END_CPP4R
+}
+// cpp4rtest/src/nothrow.h
+double add_one_nothrow_(double x);
+extern "C" SEXP _cpp4rtest_add_one_nothrow_(SEXP x) {
+  if ((TYPEOF(x) != REALSXP && TYPEOF(x) != INTSXP) || Rf_xlength(x) != 1) {
+    Rf_error("Expected single double value for `x`");
+  }
+  return Rf_ScalarReal(add_one_nothrow_(Rf_asReal(x)));
+}
+// cpp4rtest/src/package.h
+double package_qnorm_loop_(int n, double p, bool invalidate);
+extern "C" SEXP _cpp4rtest_package_qnorm_loop_(SEXP n, SEXP p, SEXP invalidate) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(package_qnorm_loop_(cpp4r::as_cpp<cpp4r::decay_t<int>>(n), cpp4r::as_cpp<cpp4r::decay_t<double>>(p), cpp4r::as_cpp<cpp4r::decay_t<bool>>(invalidate)));
+  END_CPP4R
+}
+// cpp4rtest/src/package.h
+void package_invalidate_(std::string name);
+extern "C" SEXP _cpp4rtest_package_invalidate_(SEXP name) {
+  BEGIN_CPP4R
+    package_invalidate_(cpp4r::as_cpp<cpp4r::decay_t<std::string>>(name));
+    return R_NilValue;
+  END_CPP4R
+}
+// cpp4rtest/src/prepared_call.h
+double function_call_sum_(SEXP fn, int n);
+extern "C" SEXP _cpp4rtest_function_call_sum_(SEXP fn, SEXP n) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(function_call_sum_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(fn), cpp4r::as_cpp<cpp4r::decay_t<int>>(n)));
+  END_CPP4R
+}
+// cpp4rtest/src/prepared_call.h
+double prepared_call_sum_(SEXP fn, int n);
+extern "C" SEXP _cpp4rtest_prepared_call_sum_(SEXP fn, SEXP n) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(prepared_call_sum_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(fn), cpp4r::as_cpp<cpp4r::decay_t<int>>(n)));
+  END_CPP4R
+}
+// cpp4rtest/src/progress.h
+void logger_threads_(int n, int threads);
+extern "C" SEXP _cpp4rtest_logger_threads_(SEXP n, SEXP threads) {
+  BEGIN_CPP4R
+    logger_threads_(cpp4r::as_cpp<cpp4r::decay_t<int>>(n), cpp4r::as_cpp<cpp4r::decay_t<int>>(threads));
+    return R_NilValue;
+  END_CPP4R
+}
+// cpp4rtest/src/progress.h
+void message_loop_(int n, double flush_interval);
+extern "C" SEXP _cpp4rtest_message_loop_(SEXP n, SEXP flush_interval) {
+  BEGIN_CPP4R
+    message_loop_(cpp4r::as_cpp<cpp4r::decay_t<int>>(n), cpp4r::as_cpp<cpp4r::decay_t<double>>(flush_interval));
+    return R_NilValue;
+  END_CPP4R
+}
+// cpp4rtest/src/progress.h
+int progress_loop_(int n);
+extern "C" SEXP _cpp4rtest_progress_loop_(SEXP n) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(progress_loop_(cpp4r::as_cpp<cpp4r::decay_t<int>>(n)));
+  END_CPP4R
+}
+// cpp4rtest/src/symbol.h
+cpp4r::sexp set_attrs_string_(int n);
+extern "C" SEXP _cpp4rtest_set_attrs_string_(SEXP n) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(set_attrs_string_(cpp4r::as_cpp<cpp4r::decay_t<int>>(n)));
+  END_CPP4R
+}
+// cpp4rtest/src/symbol.h
+cpp4r::sexp set_attrs_symbol_(int n);
+extern "C" SEXP _cpp4rtest_set_attrs_symbol_(SEXP n) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(set_attrs_symbol_(cpp4r::as_cpp<cpp4r::decay_t<int>>(n)));
+  END_CPP4R
+}
+// cpp4rtest/src/warning_collector.h
+cpp4r::writable::integers truncate_doubles_(cpp4r::doubles x, bool collect);
+extern "C" SEXP _cpp4rtest_truncate_doubles_(SEXP x, SEXP collect) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(truncate_doubles_(cpp4r::as_cpp<cpp4r::decay_t<cpp4r::doubles>>(x), cpp4r::as_cpp<cpp4r::decay_t<bool>>(collect)));
+  END_CPP4R
+}
+// cpp4rtest/src/warning_collector.h
+void warn_then_stop_();
+extern "C" SEXP _cpp4rtest_warn_then_stop_() {
+  BEGIN_CPP4R
+    warn_then_stop_();
+    return R_NilValue;
+  END_CPP4R
+}
+// cpp4rtest/src/warning_collector.h
+void warn_caught_();
+extern "C" SEXP _cpp4rtest_warn_caught_() {
+  BEGIN_CPP4R
+    warn_caught_();
+    return R_NilValue;
+  END_CPP4R
+}
 // data_frame.h
 SEXP data_frame_();
 extern "C" SEXP _cpp4rtest_data_frame_() {
@@ -117,6 +299,20 @@ extern "C" SEXP _cpp4rtest_my_message_n1(SEXP mystring) {
     return R_NilValue;
   END_CPP4R
 }
+// factor.h
+SEXP cpp4r_as_factor_(SEXP x, bool sorted);
+extern "C" SEXP _cpp4rtest_cpp4r_as_factor_(SEXP x, SEXP sorted) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(cpp4r_as_factor_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(x), cpp4r::as_cpp<cpp4r::decay_t<bool>>(sorted)));
+  END_CPP4R
+}
+// factor.h
+int cpp4r_factor_count_na_(SEXP x);
+extern "C" SEXP _cpp4rtest_cpp4r_factor_count_na_(SEXP x) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(cpp4r_factor_count_na_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(x)));
+  END_CPP4R
+}
 // find-intervals.h
 SEXP remove_altrep(SEXP x);
 extern "C" SEXP _cpp4rtest_remove_altrep(SEXP x) {
@@ -173,6 +369,13 @@ extern "C" SEXP _cpp4rtest_grow_cplx_(SEXP n) {
     return cpp4r::as_sexp(grow_cplx_(cpp4r::as_cpp<cpp4r::decay_t<R_xlen_t>>(n)));
   END_CPP4R
 }
+// grow.h
+cpp4r::writable::list grow_named_(R_xlen_t n);
+extern "C" SEXP _cpp4rtest_grow_named_(SEXP n) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(grow_named_(cpp4r::as_cpp<cpp4r::decay_t<R_xlen_t>>(n)));
+  END_CPP4R
+}
 // insert.h
 SEXP cpp4r_insert_(SEXP num_sxp);
 extern "C" SEXP _cpp4rtest_cpp4r_insert_(SEXP num_sxp) {
@@ -180,6 +383,21 @@ extern "C" SEXP _cpp4rtest_cpp4r_insert_(SEXP num_sxp) {
     return cpp4r::as_sexp(cpp4r_insert_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(num_sxp)));
   END_CPP4R
 }
+// json.h
+void cpp4r_write_json_(SEXP x, std::string path, bool ndjson);
+extern "C" SEXP _cpp4rtest_cpp4r_write_json_(SEXP x, SEXP path, SEXP ndjson) {
+  BEGIN_CPP4R
+    cpp4r_write_json_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(x), cpp4r::as_cpp<cpp4r::decay_t<std::string>>(path), cpp4r::as_cpp<cpp4r::decay_t<bool>>(ndjson));
+    return R_NilValue;
+  END_CPP4R
+}
+// json.h
+SEXP cpp4r_to_json_(SEXP x, bool auto_unbox);
+extern "C" SEXP _cpp4rtest_cpp4r_to_json_(SEXP x, SEXP auto_unbox) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(cpp4r_to_json_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(x), cpp4r::as_cpp<cpp4r::decay_t<bool>>(auto_unbox)));
+  END_CPP4R
+}
 // lists.h
 list cpp4r_named_list_push_back_();
 extern "C" SEXP _cpp4rtest_cpp4r_named_list_push_back_() {
@@ -208,6 +426,13 @@ extern "C" SEXP _cpp4rtest_unordered_map_to_list_(SEXP x) {
     return cpp4r::as_sexp(unordered_map_to_list_(cpp4r::as_cpp<cpp4r::decay_t<cpp4r::doubles>>(x)));
   END_CPP4R
 }
+// map.h
+SEXP unordered_map_to_data_frame_(cpp4r::doubles x);
+extern "C" SEXP _cpp4rtest_unordered_map_to_data_frame_(SEXP x) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(unordered_map_to_data_frame_(cpp4r::as_cpp<cpp4r::decay_t<cpp4r::doubles>>(x)));
+  END_CPP4R
+}
 // matrix.h
 SEXP gibbs_cpp(int N, int thin);
 extern "C" SEXP _cpp4rtest_gibbs_cpp(SEXP N, SEXP thin) {
@@ -343,6 +568,27 @@ extern "C" SEXP _cpp4rtest_protect_many_Rcpp_(SEXP n) {
     return R_NilValue;
   END_CPP4R
 }
+// ragged.h
+cpp4r::doubles cpp4r_ragged_means_(cpp4r::ragged<double> x);
+extern "C" SEXP _cpp4rtest_cpp4r_ragged_means_(SEXP x) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(cpp4r_ragged_means_(cpp4r::as_cpp<cpp4r::decay_t<cpp4r::ragged<double>>>(x)));
+  END_CPP4R
+}
+// ragged.h
+std::vector<std::vector<int>> cpp4r_ragged_reverse_(std::vector<std::vector<int>> x);
+extern "C" SEXP _cpp4rtest_cpp4r_ragged_reverse_(SEXP x) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(cpp4r_ragged_reverse_(cpp4r::as_cpp<cpp4r::decay_t<std::vector<std::vector<int>>>>(x)));
+  END_CPP4R
+}
+// read_delim.h
+SEXP cpp4r_read_delim_(std::string path, std::string types, std::string delim);
+extern "C" SEXP _cpp4rtest_cpp4r_read_delim_(SEXP path, SEXP types, SEXP delim) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(cpp4r_read_delim_(cpp4r::as_cpp<cpp4r::decay_t<std::string>>(path), cpp4r::as_cpp<cpp4r::decay_t<std::string>>(types), cpp4r::as_cpp<cpp4r::decay_t<std::string>>(delim)));
+  END_CPP4R
+}
 // release.h
 void cpp4r_release_(int n);
 extern "C" SEXP _cpp4rtest_cpp4r_release_(SEXP n) {
@@ -415,6 +661,20 @@ extern "C" SEXP _cpp4rtest_cpp4r_safe_(SEXP x_sxp) {
     return cpp4r::as_sexp(cpp4r_safe_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(x_sxp)));
   END_CPP4R
 }
+// split.h
+SEXP cpp4r_split_(SEXP x, cpp4r::integers group_ids, int n_groups);
+extern "C" SEXP _cpp4rtest_cpp4r_split_(SEXP x, SEXP group_ids, SEXP n_groups) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(cpp4r_split_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(x), cpp4r::as_cpp<cpp4r::decay_t<cpp4r::integers>>(group_ids), cpp4r::as_cpp<cpp4r::decay_t<int>>(n_groups)));
+  END_CPP4R
+}
+// split.h
+SEXP cpp4r_split_index_(cpp4r::integers group_ids, int n_groups);
+extern "C" SEXP _cpp4rtest_cpp4r_split_index_(SEXP group_ids, SEXP n_groups) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(cpp4r_split_index_(cpp4r::as_cpp<cpp4r::decay_t<cpp4r::integers>>(group_ids), cpp4r::as_cpp<cpp4r::decay_t<int>>(n_groups)));
+  END_CPP4R
+}
 // strings.h
 cpp4r::writable::strings string_proxy_assignment_();
 extern "C" SEXP _cpp4rtest_string_proxy_assignment_() {
@@ -576,6 +836,27 @@ extern "C" SEXP _cpp4rtest_sum_cplx_for2_(SEXP x_sxp) {
     return cpp4r::as_sexp(sum_cplx_for2_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(x_sxp)));
   END_CPP4R
 }
+// sum.h
+double sum_list_of_(cpp4r::list_of<cpp4r::doubles> x);
+extern "C" SEXP _cpp4rtest_sum_list_of_(SEXP x) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(sum_list_of_(cpp4r::as_cpp<cpp4r::decay_t<cpp4r::list_of<cpp4r::doubles>>>(x)));
+  END_CPP4R
+}
+// sum.h
+double sum_list_of_view_(cpp4r::list_of<cpp4r::doubles> x);
+extern "C" SEXP _cpp4rtest_sum_list_of_view_(SEXP x) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(sum_list_of_view_(cpp4r::as_cpp<cpp4r::decay_t<cpp4r::list_of<cpp4r::doubles>>>(x)));
+  END_CPP4R
+}
+// sum.h
+double sum_list_raw_(SEXP x);
+extern "C" SEXP _cpp4rtest_sum_list_raw_(SEXP x) {
+  BEGIN_CPP4R
+    return cpp4r::as_sexp(sum_list_raw_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(x)));
+  END_CPP4R
+}
 // sum_Rcpp.h
 SEXP Rcpp_sum_dbl_for_(SEXP x_sxp);
 extern "C" SEXP _cpp4rtest_Rcpp_sum_dbl_for_(SEXP x_sxp) {
@@ -683,112 +964,163 @@ extern "C" SEXP _cpp4rtest_cpp4r_push_and_truncate_(SEXP size_sexp) {
     return cpp4r::as_sexp(cpp4r_push_and_truncate_(cpp4r::as_cpp<cpp4r::decay_t<SEXP>>(size_sexp)));
   END_CPP4R
 }
+// write_delim.h
+void cpp4r_write_delim_(cpp4r::data_frame df, std::string path, std::string delim);
+extern "C" SEXP _cpp4rtest_cpp4r_write_delim_(SEXP df, SEXP path, SEXP delim) {
+  BEGIN_CPP4R
+    cpp4r_write_delim_(cpp4r::as_cpp<cpp4r::decay_t<cpp4r::data_frame>>(df), cpp4r::as_cpp<cpp4r::decay_t<std::string>>(path), cpp4r::as_cpp<cpp4r::decay_t<std::string>>(delim));
+    return R_NilValue;
+  END_CPP4R
+}
 
 extern "C" {
 /* .Call calls */
 extern SEXP run_testthat_tests(SEXP);
 
 static const R_CallMethodDef CallEntries[] = {
-    {"_cpp4rtest_Rcpp_grow_",                  (DL_FUNC) &_cpp4rtest_Rcpp_grow_,                  1},
-    {"_cpp4rtest_Rcpp_push_and_truncate_",     (DL_FUNC) &_cpp4rtest_Rcpp_push_and_truncate_,     1},
-    {"_cpp4rtest_Rcpp_release_",               (DL_FUNC) &_cpp4rtest_Rcpp_release_,               1},
-    {"_cpp4rtest_Rcpp_sum_dbl_accumulate_",    (DL_FUNC) &_cpp4rtest_Rcpp_sum_dbl_accumulate_,    1},
-    {"_cpp4rtest_Rcpp_sum_dbl_for_",           (DL_FUNC) &_cpp4rtest_Rcpp_sum_dbl_for_,           1},
-    {"_cpp4rtest_Rcpp_sum_dbl_foreach_",       (DL_FUNC) &_cpp4rtest_Rcpp_sum_dbl_foreach_,       1},
-    {"_cpp4rtest_Rcpp_sum_int_for_",           (DL_FUNC) &_cpp4rtest_Rcpp_sum_int_for_,           1},
-    {"_cpp4rtest_assign_Rcpp_",                (DL_FUNC) &_cpp4rtest_assign_Rcpp_,                2},
-    {"_cpp4rtest_assign_cpp4r_",               (DL_FUNC) &_cpp4rtest_assign_cpp4r_,               2},
-    {"_cpp4rtest_col_sums",                    (DL_FUNC) &_cpp4rtest_col_sums,                    1},
-    {"_cpp4rtest_cpp4r_add_vec_for_",          (DL_FUNC) &_cpp4rtest_cpp4r_add_vec_for_,          2},
-    {"_cpp4rtest_cpp4r_insert_",               (DL_FUNC) &_cpp4rtest_cpp4r_insert_,               1},
-    {"_cpp4rtest_cpp4r_named_list_c_style_",   (DL_FUNC) &_cpp4rtest_cpp4r_named_list_c_style_,   0},
-    {"_cpp4rtest_cpp4r_named_list_push_back_", (DL_FUNC) &_cpp4rtest_cpp4r_named_list_push_back_, 0},
-    {"_cpp4rtest_cpp4r_push_and_truncate_",    (DL_FUNC) &_cpp4rtest_cpp4r_push_and_truncate_,    1},
-    {"_cpp4rtest_cpp4r_release_",              (DL_FUNC) &_cpp4rtest_cpp4r_release_,              1},
-    {"_cpp4rtest_cpp4r_safe_",                 (DL_FUNC) &_cpp4rtest_cpp4r_safe_,                 1},
-    {"_cpp4rtest_data_frame_",                 (DL_FUNC) &_cpp4rtest_data_frame_,                 0},
-    {"_cpp4rtest_findInterval2",               (DL_FUNC) &_cpp4rtest_findInterval2,               2},
-    {"_cpp4rtest_findInterval2_5",             (DL_FUNC) &_cpp4rtest_findInterval2_5,             2},
-    {"_cpp4rtest_findInterval3",               (DL_FUNC) &_cpp4rtest_findInterval3,               2},
-    {"_cpp4rtest_findInterval4",               (DL_FUNC) &_cpp4rtest_findInterval4,               2},
-    {"_cpp4rtest_gibbs_Rcpp",                  (DL_FUNC) &_cpp4rtest_gibbs_Rcpp,                  2},
-    {"_cpp4rtest_gibbs_Rcpp2",                 (DL_FUNC) &_cpp4rtest_gibbs_Rcpp2,                 2},
-    {"_cpp4rtest_gibbs_cpp",                   (DL_FUNC) &_cpp4rtest_gibbs_cpp,                   2},
-    {"_cpp4rtest_gibbs_cpp2",                  (DL_FUNC) &_cpp4rtest_gibbs_cpp2,                  2},
-    {"_cpp4rtest_grow_",                       (DL_FUNC) &_cpp4rtest_grow_,                       1},
-    {"_cpp4rtest_grow_cplx_",                  (DL_FUNC) &_cpp4rtest_grow_cplx_,                  1},
-    {"_cpp4rtest_grow_strings_Rcpp_",          (DL_FUNC) &_cpp4rtest_grow_strings_Rcpp_,          2},
-    {"_cpp4rtest_grow_strings_cpp4r_",         (DL_FUNC) &_cpp4rtest_grow_strings_cpp4r_,         2},
-    {"_cpp4rtest_grow_strings_manual_",        (DL_FUNC) &_cpp4rtest_grow_strings_manual_,        2},
-    {"_cpp4rtest_mat_mat_copy_dimnames",       (DL_FUNC) &_cpp4rtest_mat_mat_copy_dimnames,       1},
-    {"_cpp4rtest_mat_mat_create_dimnames",     (DL_FUNC) &_cpp4rtest_mat_mat_create_dimnames,     0},
-    {"_cpp4rtest_mat_sexp_copy_dimnames",      (DL_FUNC) &_cpp4rtest_mat_sexp_copy_dimnames,      1},
-    {"_cpp4rtest_my_message",                  (DL_FUNC) &_cpp4rtest_my_message,                  2},
-    {"_cpp4rtest_my_message_n1",               (DL_FUNC) &_cpp4rtest_my_message_n1,               1},
-    {"_cpp4rtest_my_message_n1fmt",            (DL_FUNC) &_cpp4rtest_my_message_n1fmt,            1},
-    {"_cpp4rtest_my_message_n2fmt",            (DL_FUNC) &_cpp4rtest_my_message_n2fmt,            2},
-    {"_cpp4rtest_my_stop",                     (DL_FUNC) &_cpp4rtest_my_stop,                     2},
-    {"_cpp4rtest_my_stop_n1",                  (DL_FUNC) &_cpp4rtest_my_stop_n1,                  1},
-    {"_cpp4rtest_my_stop_n1fmt",               (DL_FUNC) &_cpp4rtest_my_stop_n1fmt,               1},
-    {"_cpp4rtest_my_stop_n2fmt",               (DL_FUNC) &_cpp4rtest_my_stop_n2fmt,               2},
-    {"_cpp4rtest_my_warning",                  (DL_FUNC) &_cpp4rtest_my_warning,                  2},
-    {"_cpp4rtest_my_warning_n1",               (DL_FUNC) &_cpp4rtest_my_warning_n1,               1},
-    {"_cpp4rtest_my_warning_n1fmt",            (DL_FUNC) &_cpp4rtest_my_warning_n1fmt,            1},
-    {"_cpp4rtest_my_warning_n2fmt",            (DL_FUNC) &_cpp4rtest_my_warning_n2fmt,            2},
-    {"_cpp4rtest_notroxcpp1_",                 (DL_FUNC) &_cpp4rtest_notroxcpp1_,                 1},
-    {"_cpp4rtest_notroxcpp6_",                 (DL_FUNC) &_cpp4rtest_notroxcpp6_,                 1},
-    {"_cpp4rtest_nullable_extptr_1",           (DL_FUNC) &_cpp4rtest_nullable_extptr_1,           0},
-    {"_cpp4rtest_nullable_extptr_2",           (DL_FUNC) &_cpp4rtest_nullable_extptr_2,           0},
-    {"_cpp4rtest_ordered_map_to_list_",        (DL_FUNC) &_cpp4rtest_ordered_map_to_list_,        1},
-    {"_cpp4rtest_protect_many_",               (DL_FUNC) &_cpp4rtest_protect_many_,               1},
-    {"_cpp4rtest_protect_many_Rcpp_",          (DL_FUNC) &_cpp4rtest_protect_many_Rcpp_,          1},
-    {"_cpp4rtest_protect_many_cpp4r_",         (DL_FUNC) &_cpp4rtest_protect_many_cpp4r_,         1},
-    {"_cpp4rtest_protect_many_preserve_",      (DL_FUNC) &_cpp4rtest_protect_many_preserve_,      1},
-    {"_cpp4rtest_protect_many_sexp_",          (DL_FUNC) &_cpp4rtest_protect_many_sexp_,          1},
-    {"_cpp4rtest_protect_one_",                (DL_FUNC) &_cpp4rtest_protect_one_,                2},
-    {"_cpp4rtest_protect_one_cpp4r_",          (DL_FUNC) &_cpp4rtest_protect_one_cpp4r_,          2},
-    {"_cpp4rtest_protect_one_preserve_",       (DL_FUNC) &_cpp4rtest_protect_one_preserve_,       2},
-    {"_cpp4rtest_protect_one_sexp_",           (DL_FUNC) &_cpp4rtest_protect_one_sexp_,           2},
-    {"_cpp4rtest_remove_altrep",               (DL_FUNC) &_cpp4rtest_remove_altrep,               1},
-    {"_cpp4rtest_row_sums",                    (DL_FUNC) &_cpp4rtest_row_sums,                    1},
-    {"_cpp4rtest_roxcpp2",                     (DL_FUNC) &_cpp4rtest_roxcpp2,                     1},
-    {"_cpp4rtest_roxcpp3",                     (DL_FUNC) &_cpp4rtest_roxcpp3,                     1},
-    {"_cpp4rtest_roxcpp4",                     (DL_FUNC) &_cpp4rtest_roxcpp4,                     1},
-    {"_cpp4rtest_roxcpp5",                     (DL_FUNC) &_cpp4rtest_roxcpp5,                     1},
-    {"_cpp4rtest_roxcpp7",                     (DL_FUNC) &_cpp4rtest_roxcpp7,                     1},
-    {"_cpp4rtest_string_proxy_assignment_",    (DL_FUNC) &_cpp4rtest_string_proxy_assignment_,    0},
-    {"_cpp4rtest_string_push_back_",           (DL_FUNC) &_cpp4rtest_string_push_back_,           0},
-    {"_cpp4rtest_sum_cplx_accumulate_",        (DL_FUNC) &_cpp4rtest_sum_cplx_accumulate_,        1},
-    {"_cpp4rtest_sum_cplx_for2_",              (DL_FUNC) &_cpp4rtest_sum_cplx_for2_,              1},
-    {"_cpp4rtest_sum_cplx_for_",               (DL_FUNC) &_cpp4rtest_sum_cplx_for_,               1},
-    {"_cpp4rtest_sum_cplx_for_2_",             (DL_FUNC) &_cpp4rtest_sum_cplx_for_2_,             1},
-    {"_cpp4rtest_sum_cplx_for_3_",             (DL_FUNC) &_cpp4rtest_sum_cplx_for_3_,             1},
-    {"_cpp4rtest_sum_cplx_for_4_",             (DL_FUNC) &_cpp4rtest_sum_cplx_for_4_,             1},
-    {"_cpp4rtest_sum_cplx_for_5_",             (DL_FUNC) &_cpp4rtest_sum_cplx_for_5_,             1},
-    {"_cpp4rtest_sum_cplx_for_6_",             (DL_FUNC) &_cpp4rtest_sum_cplx_for_6_,             1},
-    {"_cpp4rtest_sum_cplx_foreach_",           (DL_FUNC) &_cpp4rtest_sum_cplx_foreach_,           1},
-    {"_cpp4rtest_sum_dbl_accumulate2_",        (DL_FUNC) &_cpp4rtest_sum_dbl_accumulate2_,        1},
-    {"_cpp4rtest_sum_dbl_accumulate_",         (DL_FUNC) &_cpp4rtest_sum_dbl_accumulate_,         1},
-    {"_cpp4rtest_sum_dbl_for2_",               (DL_FUNC) &_cpp4rtest_sum_dbl_for2_,               1},
-    {"_cpp4rtest_sum_dbl_for3_",               (DL_FUNC) &_cpp4rtest_sum_dbl_for3_,               1},
-    {"_cpp4rtest_sum_dbl_for_",                (DL_FUNC) &_cpp4rtest_sum_dbl_for_,                1},
-    {"_cpp4rtest_sum_dbl_foreach2_",           (DL_FUNC) &_cpp4rtest_sum_dbl_foreach2_,           1},
-    {"_cpp4rtest_sum_dbl_foreach_",            (DL_FUNC) &_cpp4rtest_sum_dbl_foreach_,            1},
-    {"_cpp4rtest_sum_int_accumulate_",         (DL_FUNC) &_cpp4rtest_sum_int_accumulate_,         1},
-    {"_cpp4rtest_sum_int_for2_",               (DL_FUNC) &_cpp4rtest_sum_int_for2_,               1},
-    {"_cpp4rtest_sum_int_for_",                (DL_FUNC) &_cpp4rtest_sum_int_for_,                1},
-    {"_cpp4rtest_sum_int_foreach_",            (DL_FUNC) &_cpp4rtest_sum_int_foreach_,            1},
-    {"_cpp4rtest_test_destruction_inner",      (DL_FUNC) &_cpp4rtest_test_destruction_inner,      0},
-    {"_cpp4rtest_test_destruction_outer",      (DL_FUNC) &_cpp4rtest_test_destruction_outer,      0},
-    {"_cpp4rtest_unordered_map_to_list_",      (DL_FUNC) &_cpp4rtest_unordered_map_to_list_,      1},
-    {"_cpp4rtest_upper_bound",                 (DL_FUNC) &_cpp4rtest_upper_bound,                 2},
-    {"run_testthat_tests",                     (DL_FUNC) &run_testthat_tests,                     1},
+    {"_cpp4rtest_Rcpp_grow_",                   (DL_FUNC) &_cpp4rtest_Rcpp_grow_,                   1},
+    {"_cpp4rtest_Rcpp_push_and_truncate_",      (DL_FUNC) &_cpp4rtest_Rcpp_push_and_truncate_,      1},
+    {"_cpp4rtest_Rcpp_release_",                (DL_FUNC) &_cpp4rtest_Rcpp_release_,                1},
+    {"_cpp4rtest_Rcpp_sum_dbl_accumulate_",     (DL_FUNC) &_cpp4rtest_Rcpp_sum_dbl_accumulate_,     1},
+    {"_cpp4rtest_Rcpp_sum_dbl_for_",            (DL_FUNC) &_cpp4rtest_Rcpp_sum_dbl_for_,            1},
+    {"_cpp4rtest_Rcpp_sum_dbl_foreach_",        (DL_FUNC) &_cpp4rtest_Rcpp_sum_dbl_foreach_,        1},
+    {"_cpp4rtest_Rcpp_sum_int_for_",            (DL_FUNC) &_cpp4rtest_Rcpp_sum_int_for_,            1},
+    {"_cpp4rtest_add_one_",                     (DL_FUNC) &_cpp4rtest_add_one_,                     1},
+    {"_cpp4rtest_add_one_nothrow_",             (DL_FUNC) &_cpp4rtest_add_one_nothrow_,             1},
+    {"_cpp4rtest_assign_Rcpp_",                 (DL_FUNC) &_cpp4rtest_assign_Rcpp_,                 2},
+    {"_cpp4rtest_assign_cpp4r_",                (DL_FUNC) &_cpp4rtest_assign_cpp4r_,                2},
+    {"_cpp4rtest_col_sums",                     (DL_FUNC) &_cpp4rtest_col_sums,                     1},
+    {"_cpp4rtest_cpp4r_add_vec_for_",           (DL_FUNC) &_cpp4rtest_cpp4r_add_vec_for_,           2},
+    {"_cpp4rtest_cpp4r_arrow_roundtrip_",       (DL_FUNC) &_cpp4rtest_cpp4r_arrow_roundtrip_,       1},
+    {"_cpp4rtest_cpp4r_as_factor_",             (DL_FUNC) &_cpp4rtest_cpp4r_as_factor_,             2},
+    {"_cpp4rtest_cpp4r_concat_",                (DL_FUNC) &_cpp4rtest_cpp4r_concat_,                1},
+    {"_cpp4rtest_cpp4r_factor_count_na_",       (DL_FUNC) &_cpp4rtest_cpp4r_factor_count_na_,       1},
+    {"_cpp4rtest_cpp4r_insert_",                (DL_FUNC) &_cpp4rtest_cpp4r_insert_,                1},
+    {"_cpp4rtest_cpp4r_named_list_c_style_",    (DL_FUNC) &_cpp4rtest_cpp4r_named_list_c_style_,    0},
+    {"_cpp4rtest_cpp4r_named_list_push_back_",  (DL_FUNC) &_cpp4rtest_cpp4r_named_list_push_back_,  0},
+    {"_cpp4rtest_cpp4r_push_and_truncate_",     (DL_FUNC) &_cpp4rtest_cpp4r_push_and_truncate_,     1},
+    {"_cpp4rtest_cpp4r_ragged_means_",          (DL_FUNC) &_cpp4rtest_cpp4r_ragged_means_,          1},
+    {"_cpp4rtest_cpp4r_ragged_reverse_",        (DL_FUNC) &_cpp4rtest_cpp4r_ragged_reverse_,        1},
+    {"_cpp4rtest_cpp4r_rbind_",                 (DL_FUNC) &_cpp4rtest_cpp4r_rbind_,                 1},
+    {"_cpp4rtest_cpp4r_read_columnar_",         (DL_FUNC) &_cpp4rtest_cpp4r_read_columnar_,         5},
+    {"_cpp4rtest_cpp4r_read_delim_",            (DL_FUNC) &_cpp4rtest_cpp4r_read_delim_,            3},
+    {"_cpp4rtest_cpp4r_release_",               (DL_FUNC) &_cpp4rtest_cpp4r_release_,               1},
+    {"_cpp4rtest_cpp4r_safe_",                  (DL_FUNC) &_cpp4rtest_cpp4r_safe_,                  1},
+    {"_cpp4rtest_cpp4r_split_",                 (DL_FUNC) &_cpp4rtest_cpp4r_split_,                 3},
+    {"_cpp4rtest_cpp4r_split_index_",           (DL_FUNC) &_cpp4rtest_cpp4r_split_index_,           2},
+    {"_cpp4rtest_cpp4r_to_json_",               (DL_FUNC) &_cpp4rtest_cpp4r_to_json_,               2},
+    {"_cpp4rtest_cpp4r_write_columnar_",        (DL_FUNC) &_cpp4rtest_cpp4r_write_columnar_,        2},
+    {"_cpp4rtest_cpp4r_write_delim_",           (DL_FUNC) &_cpp4rtest_cpp4r_write_delim_,           3},
+    {"_cpp4rtest_cpp4r_write_json_",            (DL_FUNC) &_cpp4rtest_cpp4r_write_json_,            3},
+    {"_cpp4rtest_data_frame_",                  (DL_FUNC) &_cpp4rtest_data_frame_,                  0},
+    {"_cpp4rtest_findInterval2",                (DL_FUNC) &_cpp4rtest_findInterval2,                2},
+    {"_cpp4rtest_findInterval2_5",              (DL_FUNC) &_cpp4rtest_findInterval2_5,              2},
+    {"_cpp4rtest_findInterval3",                (DL_FUNC) &_cpp4rtest_findInterval3,                2},
+    {"_cpp4rtest_findInterval4",                (DL_FUNC) &_cpp4rtest_findInterval4,                2},
+    {"_cpp4rtest_function_call_sum_",           (DL_FUNC) &_cpp4rtest_function_call_sum_,           2},
+    {"_cpp4rtest_gibbs_Rcpp",                   (DL_FUNC) &_cpp4rtest_gibbs_Rcpp,                   2},
+    {"_cpp4rtest_gibbs_Rcpp2",                  (DL_FUNC) &_cpp4rtest_gibbs_Rcpp2,                  2},
+    {"_cpp4rtest_gibbs_cpp",                    (DL_FUNC) &_cpp4rtest_gibbs_cpp,                    2},
+    {"_cpp4rtest_gibbs_cpp2",                   (DL_FUNC) &_cpp4rtest_gibbs_cpp2,                   2},
+    {"_cpp4rtest_grow_",                        (DL_FUNC) &_cpp4rtest_grow_,                        1},
+    {"_cpp4rtest_grow_cplx_",                   (DL_FUNC) &_cpp4rtest_grow_cplx_,                   1},
+    {"_cpp4rtest_grow_named_",                  (DL_FUNC) &_cpp4rtest_grow_named_,                  1},
+    {"_cpp4rtest_grow_strings_Rcpp_",           (DL_FUNC) &_cpp4rtest_grow_strings_Rcpp_,           2},
+    {"_cpp4rtest_grow_strings_cpp4r_",          (DL_FUNC) &_cpp4rtest_grow_strings_cpp4r_,          2},
+    {"_cpp4rtest_grow_strings_manual_",         (DL_FUNC) &_cpp4rtest_grow_strings_manual_,         2},
+    {"_cpp4rtest_interruptible_parallel_sum_",  (DL_FUNC) &_cpp4rtest_interruptible_parallel_sum_,  2},
+    {"_cpp4rtest_interruptible_sum_",           (DL_FUNC) &_cpp4rtest_interruptible_sum_,           2},
+    {"_cpp4rtest_logger_threads_",              (DL_FUNC) &_cpp4rtest_logger_threads_,              2},
+    {"_cpp4rtest_map_batched_",                 (DL_FUNC) &_cpp4rtest_map_batched_,                 3},
+    {"_cpp4rtest_map_elements_",                (DL_FUNC) &_cpp4rtest_map_elements_,                2},
+    {"_cpp4rtest_mat_mat_copy_dimnames",        (DL_FUNC) &_cpp4rtest_mat_mat_copy_dimnames,        1},
+    {"_cpp4rtest_mat_mat_create_dimnames",      (DL_FUNC) &_cpp4rtest_mat_mat_create_dimnames,      0},
+    {"_cpp4rtest_mat_sexp_copy_dimnames",       (DL_FUNC) &_cpp4rtest_mat_sexp_copy_dimnames,       1},
+    {"_cpp4rtest_message_loop_",                (DL_FUNC) &_cpp4rtest_message_loop_,                2},
+    {"_cpp4rtest_my_message",                   (DL_FUNC) &_cpp4rtest_my_message,                   2},
+    {"_cpp4rtest_my_message_n1",                (DL_FUNC) &_cpp4rtest_my_message_n1,                1},
+    {"_cpp4rtest_my_message_n1fmt",             (DL_FUNC) &_cpp4rtest_my_message_n1fmt,             1},
+    {"_cpp4rtest_my_message_n2fmt",             (DL_FUNC) &_cpp4rtest_my_message_n2fmt,             2},
+    {"_cpp4rtest_my_stop",                      (DL_FUNC) &_cpp4rtest_my_stop,                      2},
+    {"_cpp4rtest_my_stop_n1",                   (DL_FUNC) &_cpp4rtest_my_stop_n1,                   1},
+    {"_cpp4rtest_my_stop_n1fmt",                (DL_FUNC) &_cpp4rtest_my_stop_n1fmt,                1},
+    {"_cpp4rtest_my_stop_n2fmt",                (DL_FUNC) &_cpp4rtest_my_stop_n2fmt,                2},
+    {"_cpp4rtest_my_warning",                   (DL_FUNC) &_cpp4rtest_my_warning,                   2},
+    {"_cpp4rtest_my_warning_n1",                (DL_FUNC) &_cpp4rtest_my_warning_n1,                1},
+    {"_cpp4rtest_my_warning_n1fmt",             (DL_FUNC) &_cpp4rtest_my_warning_n1fmt,             1},
+    {"_cpp4rtest_my_warning_n2fmt",             (DL_FUNC) &_cpp4rtest_my_warning_n2fmt,             2},
+    {"_cpp4rtest_noop_",                        (DL_FUNC) &_cpp4rtest_noop_,                        0},
+    {"_cpp4rtest_noop_nothrow_",                (DL_FUNC) &_cpp4rtest_noop_nothrow_,                0},
+    {"_cpp4rtest_notroxcpp1_",                  (DL_FUNC) &_cpp4rtest_notroxcpp1_,                  1},
+    {"_cpp4rtest_notroxcpp6_",                  (DL_FUNC) &_cpp4rtest_notroxcpp6_,                  1},
+    {"_cpp4rtest_nullable_extptr_1",            (DL_FUNC) &_cpp4rtest_nullable_extptr_1,            0},
+    {"_cpp4rtest_nullable_extptr_2",            (DL_FUNC) &_cpp4rtest_nullable_extptr_2,            0},
+    {"_cpp4rtest_ordered_map_to_list_",         (DL_FUNC) &_cpp4rtest_ordered_map_to_list_,         1},
+    {"_cpp4rtest_package_invalidate_",          (DL_FUNC) &_cpp4rtest_package_invalidate_,          1},
+    {"_cpp4rtest_package_qnorm_loop_",          (DL_FUNC) &_cpp4rtest_package_qnorm_loop_,          3},
+    {"_cpp4rtest_prepared_call_sum_",           (DL_FUNC) &_cpp4rtest_prepared_call_sum_,           2},
+    {"_cpp4rtest_progress_loop_",               (DL_FUNC) &_cpp4rtest_progress_loop_,               1},
+    {"_cpp4rtest_protect_many_",                (DL_FUNC) &_cpp4rtest_protect_many_,                1},
+    {"_cpp4rtest_protect_many_Rcpp_",           (DL_FUNC) &_cpp4rtest_protect_many_Rcpp_,           1},
+    {"_cpp4rtest_protect_many_cpp4r_",          (DL_FUNC) &_cpp4rtest_protect_many_cpp4r_,          1},
+    {"_cpp4rtest_protect_many_preserve_",       (DL_FUNC) &_cpp4rtest_protect_many_preserve_,       1},
+    {"_cpp4rtest_protect_many_sexp_",           (DL_FUNC) &_cpp4rtest_protect_many_sexp_,           1},
+    {"_cpp4rtest_protect_one_",                 (DL_FUNC) &_cpp4rtest_protect_one_,                 2},
+    {"_cpp4rtest_protect_one_cpp4r_",           (DL_FUNC) &_cpp4rtest_protect_one_cpp4r_,           2},
+    {"_cpp4rtest_protect_one_preserve_",        (DL_FUNC) &_cpp4rtest_protect_one_preserve_,        2},
+    {"_cpp4rtest_protect_one_sexp_",            (DL_FUNC) &_cpp4rtest_protect_one_sexp_,            2},
+    {"_cpp4rtest_remove_altrep",                (DL_FUNC) &_cpp4rtest_remove_altrep,                1},
+    {"_cpp4rtest_row_sums",                     (DL_FUNC) &_cpp4rtest_row_sums,                     1},
+    {"_cpp4rtest_roxcpp2",                      (DL_FUNC) &_cpp4rtest_roxcpp2,                      1},
+    {"_cpp4rtest_roxcpp3",                      (DL_FUNC) &_cpp4rtest_roxcpp3,                      1},
+    {"_cpp4rtest_roxcpp4",                      (DL_FUNC) &_cpp4rtest_roxcpp4,                      1},
+    {"_cpp4rtest_roxcpp5",                      (DL_FUNC) &_cpp4rtest_roxcpp5,                      1},
+    {"_cpp4rtest_roxcpp7",                      (DL_FUNC) &_cpp4rtest_roxcpp7,                      1},
+    {"_cpp4rtest_set_attrs_string_",            (DL_FUNC) &_cpp4rtest_set_attrs_string_,            1},
+    {"_cpp4rtest_set_attrs_symbol_",            (DL_FUNC) &_cpp4rtest_set_attrs_symbol_,            1},
+    {"_cpp4rtest_string_proxy_assignment_",     (DL_FUNC) &_cpp4rtest_string_proxy_assignment_,     0},
+    {"_cpp4rtest_string_push_back_",            (DL_FUNC) &_cpp4rtest_string_push_back_,            0},
+    {"_cpp4rtest_sum_cplx_accumulate_",         (DL_FUNC) &_cpp4rtest_sum_cplx_accumulate_,         1},
+    {"_cpp4rtest_sum_cplx_for2_",               (DL_FUNC) &_cpp4rtest_sum_cplx_for2_,               1},
+    {"_cpp4rtest_sum_cplx_for_",                (DL_FUNC) &_cpp4rtest_sum_cplx_for_,                1},
+    {"_cpp4rtest_sum_cplx_for_2_",              (DL_FUNC) &_cpp4rtest_sum_cplx_for_2_,              1},
+    {"_cpp4rtest_sum_cplx_for_3_",              (DL_FUNC) &_cpp4rtest_sum_cplx_for_3_,              1},
+    {"_cpp4rtest_sum_cplx_for_4_",              (DL_FUNC) &_cpp4rtest_sum_cplx_for_4_,              1},
+    {"_cpp4rtest_sum_cplx_for_5_",              (DL_FUNC) &_cpp4rtest_sum_cplx_for_5_,              1},
+    {"_cpp4rtest_sum_cplx_for_6_",              (DL_FUNC) &_cpp4rtest_sum_cplx_for_6_,              1},
+    {"_cpp4rtest_sum_cplx_foreach_",            (DL_FUNC) &_cpp4rtest_sum_cplx_foreach_,            1},
+    {"_cpp4rtest_sum_dbl_accumulate2_",         (DL_FUNC) &_cpp4rtest_sum_dbl_accumulate2_,         1},
+    {"_cpp4rtest_sum_dbl_accumulate_",          (DL_FUNC) &_cpp4rtest_sum_dbl_accumulate_,          1},
+    {"_cpp4rtest_sum_dbl_for2_",                (DL_FUNC) &_cpp4rtest_sum_dbl_for2_,                1},
+    {"_cpp4rtest_sum_dbl_for3_",                (DL_FUNC) &_cpp4rtest_sum_dbl_for3_,                1},
+    {"_cpp4rtest_sum_dbl_for_",                 (DL_FUNC) &_cpp4rtest_sum_dbl_for_,                 1},
+    {"_cpp4rtest_sum_dbl_foreach2_",            (DL_FUNC) &_cpp4rtest_sum_dbl_foreach2_,            1},
+    {"_cpp4rtest_sum_dbl_foreach_",             (DL_FUNC) &_cpp4rtest_sum_dbl_foreach_,             1},
+    {"_cpp4rtest_sum_int_accumulate_",          (DL_FUNC) &_cpp4rtest_sum_int_accumulate_,          1},
+    {"_cpp4rtest_sum_int_for2_",                (DL_FUNC) &_cpp4rtest_sum_int_for2_,                1},
+    {"_cpp4rtest_sum_int_for_",                 (DL_FUNC) &_cpp4rtest_sum_int_for_,                 1},
+    {"_cpp4rtest_sum_int_foreach_",             (DL_FUNC) &_cpp4rtest_sum_int_foreach_,             1},
+    {"_cpp4rtest_sum_list_of_",                 (DL_FUNC) &_cpp4rtest_sum_list_of_,                 1},
+    {"_cpp4rtest_sum_list_of_view_",            (DL_FUNC) &_cpp4rtest_sum_list_of_view_,            1},
+    {"_cpp4rtest_sum_list_raw_",                (DL_FUNC) &_cpp4rtest_sum_list_raw_,                1},
+    {"_cpp4rtest_test_destruction_inner",       (DL_FUNC) &_cpp4rtest_test_destruction_inner,       0},
+    {"_cpp4rtest_test_destruction_outer",       (DL_FUNC) &_cpp4rtest_test_destruction_outer,       0},
+    {"_cpp4rtest_truncate_doubles_",            (DL_FUNC) &_cpp4rtest_truncate_doubles_,            2},
+    {"_cpp4rtest_unordered_map_to_data_frame_", (DL_FUNC) &_cpp4rtest_unordered_map_to_data_frame_, 1},
+    {"_cpp4rtest_unordered_map_to_list_",       (DL_FUNC) &_cpp4rtest_unordered_map_to_list_,       1},
+    {"_cpp4rtest_upper_bound",                  (DL_FUNC) &_cpp4rtest_upper_bound,                  2},
+    {"_cpp4rtest_warn_caught_",                 (DL_FUNC) &_cpp4rtest_warn_caught_,                 0},
+    {"_cpp4rtest_warn_then_stop_",              (DL_FUNC) &_cpp4rtest_warn_then_stop_,              0},
+    {"run_testthat_tests",                      (DL_FUNC) &run_testthat_tests,                      1},
     {NULL, NULL, 0}
 };
 }
 
+void arrow_init(DllInfo* dll);
+
 extern "C" attribute_visible void R_init_cpp4rtest(DllInfo* dll){
   R_registerRoutines(dll, NULL, CallEntries, NULL, NULL);
   R_useDynamicSymbols(dll, FALSE);
+  arrow_init(dll);
   R_forceSymbols(dll, TRUE);
 }
@@ -0,0 +1,11 @@
+[[cpp4r::register]] SEXP cpp4r_as_factor_(SEXP x, bool sorted) {
+  return cpp4r::as_factor(x, sorted);
+}
+
+[[cpp4r::register]] int cpp4r_factor_count_na_(SEXP x) {
+  int n = 0;
+  for (auto el : cpp4r::factor(x)) {
+    n += el.is_na();
+  }
+  return n;
+}
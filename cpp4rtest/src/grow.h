@@ -18,3 +18,14 @@
 
   return x;
 }
+
+[[cpp4r::register]] cpp4r::writable::list grow_named_(R_xlen_t n) {
+  cpp4r::writable::list x;
+  R_xlen_t i = 0;
+  while (i < n) {
+    const std::string name = "n" + std::to_string(i);
+    x.push_back(cpp4r::named_arg(name.c_str(), static_cast<double>(i++)));
+  }
+
+  return x;
+}
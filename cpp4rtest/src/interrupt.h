@@ -0,0 +1,50 @@
+#include <thread>
+
+// Sum of `1:n`, checking for interrupts on every iteration, or through an
+// `interrupt_checker` polling at most every `interval_ms` if it is not negative
+[[cpp4r::register]] double interruptible_sum_(int n, int interval_ms) {
+  double out = 0;
+  if (interval_ms < 0) {
+    for (int i = 1; i <= n; ++i) {
+      cpp4r::check_user_interrupt();
+      out += i;
+    }
+    return out;
+  }
+  cpp4r::interrupt_checker checker(interval_ms);
+  for (int i = 1; i <= n && !checker.check(); ++i) {
+    out += i;
+  }
+  checker.unwind_if_interrupted();
+  return out;
+}
+
+// Sum of `1:n` split over `threads` workers, which stop early if interrupted
+[[cpp4r::register]] double interruptible_parallel_sum_(int n, int threads) {
+  cpp4r::interrupt_checker checker(50);
+  std::vector<double> sums(threads, 0);
+  std::atomic<int> finished{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&checker, &sums, &finished, n, t, threads] {
+      for (int i = t + 1; i <= n && !checker.cancelled(); i += threads) {
+        sums[t] += i;
+      }
+      ++finished;
+    });
+  }
+  // Only the main thread can poll R, so it does while the workers run
+  while (finished < threads && !checker.check()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  checker.unwind_if_interrupted();
+
+  double out = 0;
+  for (double sum : sums) {
+    out += sum;
+  }
+  return out;
+}
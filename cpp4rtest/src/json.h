@@ -0,0 +1,13 @@
+[[cpp4r::register]] void cpp4r_write_json_(SEXP x, std::string path, bool ndjson) {
+  if (ndjson) {
+    cpp4r::write_ndjson(cpp4r::data_frame(x), path);
+  } else {
+    cpp4r::write_json(x, path);
+  }
+}
+
+[[cpp4r::register]] SEXP cpp4r_to_json_(SEXP x, bool auto_unbox) {
+  cpp4r::json_options options;
+  options.auto_unbox = auto_unbox;
+  return cpp4r::to_json(x, options);
+}
@@ -15,46 +15,81 @@
 using namespace cpp4r;
 
 #include "add.h"
+#include "arrow.h"
+#include "columnar.h"
+#include "concat.h"
 #include "data_frame.h"
 #include "errors_fmt.h"
 #include "errors.h"
+#include "factor.h"
 #include "find-intervals.h"
 #include "grow.h"
 #include "insert.h"
+#include "interrupt.h"
+#include "json.h"
 #include "map.h"
+#include "map_batched.h"
 #include "matrix.h"
+#include "nothrow.h"
+#include "package.h"
+#include "prepared_call.h"
+#include "progress.h"
 #include "protect.h"
+#include "ragged.h"
+#include "read_delim.h"
 #include "release.h"
 #include "roxygen1.h"
 #include "roxygen2.h"
 #include "roxygen3.h"
 #include "safe.h"
+#include "split.h"
 #include "strings.h"
 #include "sum.h"
 #include "sum_int.h"
 #include "sum_Rcpp.h"
+#include "symbol.h"
 #include "truncate.h"
+#include "warning_collector.h"
+#include "write_delim.h"
 #include "lists.h"
 
 #include "test-runner.h"
+#include "test-arrow.h"
 #include "test-as.h"
+#include "test-columnar.h"
 #include "test-complex.h"
+#include "test-concat.h"
 #include "test-data_frame.h"
+#include "test-data_frame_builder.h"
 #include "test-doubles.h"
 #include "test-environment.h"
 #include "test-external_pointer.h"
+#include "test-factor.h"
 #include "test-function.h"
+#include "test-group_by.h"
 #include "test-integers.h"
+#include "test-interrupt.h"
+#include "test-join.h"
+#include "test-json.h"
 #include "test-list.h"
 #include "test-list_of.h"
 #include "test-logicals.h"
+#include "test-map_batched.h"
 #include "test-matrix.h"
 #include "test-nas.h"
+#include "test-progress.h"
 #include "test-protect.h"
 #include "test-protect-nested.h"
+#include "test-ragged.h"
 #include "test-raws.h"
+#include "test-read_delim.h"
+#include "test-record.h"
 #include "test-r_complex.h"
 #include "test-r_vector.h"
 #include "test-sexp.h"
+#include "test-split.h"
 #include "test-string.h"
 #include "test-strings.h"
+#include "test-symbol.h"
+#include "test-warning_collector.h"
+#include "test-write_delim.h"
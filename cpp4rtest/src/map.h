@@ -15,3 +15,14 @@
   }
   return cpp4r::as_sexp(counts);
 }
+
+[[cpp4r::register]] SEXP unordered_map_to_data_frame_(cpp4r::doubles x) {
+  std::unordered_map<double, int> counts;
+  for (double value : x) {
+    counts[value]++;
+  }
+  cpp4r::map_options options;
+  options.data_frame = true;
+  options.sort = true;
+  return cpp4r::as_sexp(counts, options);
+}
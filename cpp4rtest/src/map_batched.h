@@ -0,0 +1,14 @@
+[[cpp4r::register]] cpp4r::writable::doubles map_batched_(SEXP fn, cpp4r::doubles x,
+                                                          R_xlen_t batch_size) {
+  return cpp4r::map_batched(fn, x, batch_size);
+}
+
+// `fn` called once per element of `x`, for comparison
+[[cpp4r::register]] cpp4r::writable::doubles map_elements_(SEXP fn, cpp4r::doubles x) {
+  cpp4r::function f(fn);
+  cpp4r::writable::doubles out(x.size());
+  for (R_xlen_t i = 0; i < x.size(); ++i) {
+    out[i] = cpp4r::as_cpp<double>(f(x[i]));
+  }
+  return out;
+}
@@ -0,0 +1,9 @@
+// A no-op through the default wrapper, with its error handling
+[[cpp4r::register]] void noop_() {}
+
+// A no-op through the lean wrapper of `nothrow` functions
+[[cpp4r::register(nothrow)]] void noop_nothrow_() {}
+
+[[cpp4r::register]] double add_one_(double x) { return x + 1; }
+
+[[cpp4r::register(nothrow)]] double add_one_nothrow_(double x) { return x + 1; }
@@ -0,0 +1,16 @@
+// Sum of `stats::qnorm(p)` over `n` calls, looking the function up in every iteration.
+// With `invalidate`, the cache is dropped each time, as if lookups were not cached.
+[[cpp4r::register]] double package_qnorm_loop_(int n, double p, bool invalidate) {
+  double out = 0;
+  for (int i = 0; i < n; ++i) {
+    if (invalidate) {
+      cpp4r::package::invalidate("stats");
+    }
+    out += cpp4r::as_cpp<double>(cpp4r::package("stats")["qnorm"](p));
+  }
+  return out;
+}
+
+[[cpp4r::register]] void package_invalidate_(std::string name) {
+  cpp4r::package::invalidate(name);
+}
@@ -0,0 +1,22 @@
+// Sum of `fn(i)` over `i` in `1:n`, with a new call on every iteration
+[[cpp4r::register]] double function_call_sum_(SEXP fn, int n) {
+  cpp4r::function f(fn);
+  double out = 0;
+  for (int i = 1; i <= n; ++i) {
+    out += cpp4r::as_cpp<double>(f(static_cast<double>(i)));
+  }
+  return out;
+}
+
+// Sum of `fn(i)` over `i` in `1:n`, reusing one call and overwriting its argument
+[[cpp4r::register]] double prepared_call_sum_(SEXP fn, int n) {
+  cpp4r::writable::doubles x(1);
+  cpp4r::prepared_call call(fn, x);
+  double* p = REAL(x.data());
+  double out = 0;
+  for (int i = 1; i <= n; ++i) {
+    *p = i;
+    out += cpp4r::as_cpp<double>(call());
+  }
+  return out;
+}
@@ -0,0 +1,41 @@
+#include <thread>
+
+// Log `n` messages from each of `threads` worker threads, shown as one message
+[[cpp4r::register]] void logger_threads_(int n, int threads) {
+  cpp4r::logger log(0);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&log, n, t] {
+      for (int i = 0; i < n; ++i) {
+        log.log("thread %d message %d", t, i);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+// Show `n` messages, one `message()` each, or through a logger flushing every
+// `flush_interval` seconds if it is positive
+[[cpp4r::register]] void message_loop_(int n, double flush_interval) {
+  if (flush_interval <= 0) {
+    for (int i = 0; i < n; ++i) {
+      cpp4r::message("message %d", i);
+    }
+    return;
+  }
+  cpp4r::logger log(flush_interval);
+  for (int i = 0; i < n; ++i) {
+    log.log("message %d", i);
+  }
+}
+
+// Tick a progress report `n` times, updating the console at most 10 times a second
+[[cpp4r::register]] int progress_loop_(int n) {
+  cpp4r::progress p(n);
+  for (int i = 0; i < n; ++i) {
+    p.tick();
+  }
+  return static_cast<int>(p.current());
+}
@@ -0,0 +1,19 @@
+[[cpp4r::register]] cpp4r::doubles cpp4r_ragged_means_(cpp4r::ragged<double> x) {
+  cpp4r::writable::doubles out(x.size());
+  for (R_xlen_t i = 0; i < x.size(); ++i) {
+    double sum = 0;
+    for (double value : x[i]) {
+      sum += value;
+    }
+    out[i] = x[i].empty() ? NA_REAL : sum / x[i].size();
+  }
+  return out;
+}
+
+[[cpp4r::register]] std::vector<std::vector<int>> cpp4r_ragged_reverse_(
+    std::vector<std::vector<int>> x) {
+  for (std::vector<int>& row : x) {
+    std::reverse(row.begin(), row.end());
+  }
+  return x;
+}
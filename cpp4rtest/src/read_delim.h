@@ -0,0 +1,30 @@
+// `types` has one letter per column: "d"ouble, "i"nteger, "l"ogical, "c"haracter,
+// "?" to guess or "_" to skip. An empty string guesses all columns.
+[[cpp4r::register]] SEXP cpp4r_read_delim_(std::string path, std::string types,
+                                           std::string delim) {
+  std::vector<cpp4r::column_type> schema;
+  for (char type : types) {
+    switch (type) {
+      case 'd':
+        schema.push_back(cpp4r::column_type::real);
+        break;
+      case 'i':
+        schema.push_back(cpp4r::column_type::integer);
+        break;
+      case 'l':
+        schema.push_back(cpp4r::column_type::logical);
+        break;
+      case 'c':
+        schema.push_back(cpp4r::column_type::string);
+        break;
+      case '_':
+        schema.push_back(cpp4r::column_type::skip);
+        break;
+      default:
+        schema.push_back(cpp4r::column_type::guess);
+    }
+  }
+  cpp4r::delim_options options;
+  options.delim = delim[0];
+  return cpp4r::read_delim(path, schema, options);
+}
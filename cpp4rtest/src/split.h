@@ -0,0 +1,9 @@
+[[cpp4r::register]] SEXP cpp4r_split_(SEXP x, cpp4r::integers group_ids, int n_groups) {
+  return cpp4r::split(x, group_ids, n_groups);
+}
+
+[[cpp4r::register]] SEXP cpp4r_split_index_(cpp4r::integers group_ids, int n_groups) {
+  std::pair<cpp4r::integers, cpp4r::integers> index =
+      cpp4r::split_index(group_ids, n_groups);
+  return cpp4r::writable::list({index.first, index.second});
+}
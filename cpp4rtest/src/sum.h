@@ -163,3 +163,34 @@
 
   return sum;
 }
+
+[[cpp4r::register]] double sum_list_of_(cpp4r::list_of<cpp4r::doubles> x) {
+  double sum = 0.;
+  R_xlen_t n = x.size();
+  for (R_xlen_t i = 0; i < n; ++i) {
+    cpp4r::doubles elt = x[i];
+    sum += elt.empty() ? 0. : elt[0];
+  }
+
+  return sum;
+}
+
+[[cpp4r::register]] double sum_list_of_view_(cpp4r::list_of<cpp4r::doubles> x) {
+  double sum = 0.;
+  for (auto elt : x.views()) {
+    sum += elt.empty() ? 0. : elt[0];
+  }
+
+  return sum;
+}
+
+[[cpp4r::register]] double sum_list_raw_(SEXP x) {
+  double sum = 0.;
+  R_xlen_t n = Rf_xlength(x);
+  for (R_xlen_t i = 0; i < n; ++i) {
+    SEXP elt = VECTOR_ELT(x, i);
+    sum += Rf_xlength(elt) == 0 ? 0. : REAL(elt)[0];
+  }
+
+  return sum;
+}
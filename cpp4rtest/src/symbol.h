@@ -0,0 +1,25 @@
+// Set the `dim` and `class` attributes of `n` new vectors, looking the names up each time
+[[cpp4r::register]] cpp4r::sexp set_attrs_string_(int n) {
+  cpp4r::writable::list out(n);
+  for (int i = 0; i < n; ++i) {
+    cpp4r::writable::integers x({1, 2, 3, 4});
+    x.attr("dim") = {2, 2};
+    x.attr("class") = "foo";
+    out[i] = x;
+  }
+  return out;
+}
+
+// Set the same attributes through `_sym` literals, which resolve each name once
+[[cpp4r::register]] cpp4r::sexp set_attrs_symbol_(int n) {
+  using namespace cpp4r::literals;
+
+  cpp4r::writable::list out(n);
+  for (int i = 0; i < n; ++i) {
+    cpp4r::writable::integers x({1, 2, 3, 4});
+    x.attr("dim"_sym) = {2, 2};
+    x.attr("class"_sym) = "foo";
+    out[i] = x;
+  }
+  return out;
+}
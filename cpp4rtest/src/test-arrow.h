@@ -0,0 +1,176 @@
+#include <testthat.h>
+
+// A minimal producer of float64 arrays, standing in for another library
+struct arrow_test_producer {
+  std::vector<double> values;
+  std::vector<uint8_t> validity;
+  std::vector<const void*> buffers;
+  bool* released;
+};
+
+static void arrow_test_release(ArrowArray* array) {
+  auto* producer = static_cast<arrow_test_producer*>(array->private_data);
+  *producer->released = true;
+  delete producer;
+  array->release = nullptr;
+}
+
+static void arrow_test_float64(ArrowArray* array, std::vector<double> values,
+                               std::vector<uint8_t> validity, int64_t null_count,
+                               bool* released) {
+  auto* producer = new arrow_test_producer{std::move(values), std::move(validity), {},
+                                           released};
+  producer->buffers = {producer->validity.empty() ? nullptr : producer->validity.data(),
+                       producer->values.data()};
+  *array = ArrowArray();
+  array->length = static_cast<int64_t>(producer->values.size());
+  array->null_count = null_count;
+  array->n_buffers = 2;
+  array->buffers = producer->buffers.data();
+  array->release = arrow_test_release;
+  array->private_data = producer;
+}
+
+context("arrow-C++") {
+  test_that("export_array() shares the data of numeric vectors") {
+    cpp4r::writable::doubles x({1., 2., 3.});
+    R_xlen_t protected_before = cpp4r::detail::store::count();
+
+    ArrowSchema schema;
+    ArrowArray array;
+    cpp4r::arrow::export_array(x, &schema, &array);
+    expect_true(std::string(schema.format) == "g");
+    expect_true(array.length == 3);
+    expect_true(array.null_count == 0);
+    expect_true(array.buffers[0] == nullptr);
+    expect_true(array.buffers[1] == REAL(x.data()));
+    expect_true(cpp4r::detail::store::count() == protected_before + 1);
+
+    array.release(&array);
+    schema.release(&schema);
+    expect_true(array.release == nullptr);
+    expect_true(schema.release == nullptr);
+    expect_true(cpp4r::detail::store::count() == protected_before);
+  }
+
+  test_that("export_array() turns NA into nulls") {
+    cpp4r::writable::integers x({1, NA_INTEGER, 3});
+    ArrowSchema schema;
+    ArrowArray array;
+    cpp4r::arrow::export_array(x, &schema, &array);
+    expect_true(std::string(schema.format) == "i");
+    expect_true(array.null_count == 1);
+    expect_true(static_cast<const uint8_t*>(array.buffers[0])[0] == 5);
+    array.release(&array);
+    schema.release(&schema);
+
+    cpp4r::writable::logicals lgl({TRUE, NA_LOGICAL, FALSE});
+    cpp4r::arrow::export_array(lgl, &schema, &array);
+    expect_true(std::string(schema.format) == "b");
+    expect_true(array.null_count == 1);
+    expect_true(static_cast<const uint8_t*>(array.buffers[0])[0] == 5);
+    expect_true(static_cast<const uint8_t*>(array.buffers[1])[0] == 1);
+    array.release(&array);
+    schema.release(&schema);
+
+    cpp4r::writable::strings str({"ab", NA_STRING, "c"});
+    cpp4r::arrow::export_array(str, &schema, &array);
+    expect_true(std::string(schema.format) == "u");
+    expect_true(array.null_count == 1);
+    const int32_t* offsets = static_cast<const int32_t*>(array.buffers[1]);
+    expect_true(offsets[1] == 2 && offsets[2] == 2 && offsets[3] == 3);
+    expect_true(std::memcmp(array.buffers[2], "abc", 3) == 0);
+    array.release(&array);
+    schema.release(&schema);
+  }
+
+  test_that("export_array() rejects unsupported vectors") {
+    ArrowSchema schema;
+    ArrowArray array;
+    schema.release = nullptr;
+    array.release = nullptr;
+    cpp4r::writable::list x({cpp4r::writable::doubles({1.})});
+    expect_error(cpp4r::arrow::export_array(x, &schema, &array));
+    cpp4r::factor f = cpp4r::as_factor(cpp4r::writable::strings({"a"}));
+    expect_error(cpp4r::arrow::export_array(f, &schema, &array));
+    expect_true(schema.release == nullptr);
+    expect_true(array.release == nullptr);
+  }
+
+  test_that("import_array() reads a foreign float64 array") {
+    bool released = false;
+    ArrowArray array;
+    arrow_test_float64(&array, {1.5, 2.5, 3.5, 4.5}, {0x0d}, 1, &released);
+    ArrowSchema schema = ArrowSchema();
+    schema.format = "g";
+
+    cpp4r::doubles x(cpp4r::arrow::import_array(&schema, &array));
+    expect_true(array.release == nullptr);
+    expect_true(x.size() == 4);
+    expect_true(x[0] == 1.5);
+    expect_true(ISNA(x[1]));
+    expect_true(x[3] == 4.5);
+    // Copies release the foreign array right away, ALTREP views when collected
+    expect_true(released != static_cast<bool>(ALTREP(x.data())));
+  }
+
+  test_that("import_array() honours the array offset") {
+    bool released = false;
+    ArrowArray array;
+    arrow_test_float64(&array, {1., 2., 3., 4.}, {0x0b}, 1, &released);
+    array.offset = 1;
+    array.length = 3;
+    ArrowSchema schema = ArrowSchema();
+    schema.format = "g";
+
+    cpp4r::doubles x(cpp4r::arrow::import_array(&schema, &array));
+    expect_true(x.size() == 3);
+    expect_true(x[0] == 2.);
+    expect_true(ISNA(x[1]));
+    expect_true(x[2] == 4.);
+  }
+
+  test_that("import_array() leaves the array to the caller on error") {
+    bool released = false;
+    ArrowArray array;
+    arrow_test_float64(&array, {1.}, {}, 0, &released);
+    ArrowSchema schema = ArrowSchema();
+    schema.format = "e";
+    expect_error(cpp4r::arrow::import_array(&schema, &array));
+    expect_true(array.release != nullptr);
+    array.release(&array);
+    expect_true(released);
+  }
+
+  test_that("data frames round trip through the C data interface") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::strings str({"a", "b", NA_STRING});
+    cpp4r::writable::logicals flag({TRUE, NA_LOGICAL, FALSE});
+    cpp4r::writable::data_frame df({"x"_nm = {1.5, NA_REAL, 3.5},
+                                    "n"_nm = {1, 2, NA_INTEGER}, "s"_nm = str,
+                                    "f"_nm = flag});
+
+    ArrowSchema schema;
+    ArrowArray array;
+    cpp4r::arrow::export_data_frame(df, &schema, &array);
+    expect_true(std::string(schema.format) == "+s");
+    expect_true(schema.n_children == 4);
+    expect_true(std::string(schema.children[2]->name) == "s");
+    expect_true(array.length == 3);
+
+    cpp4r::data_frame out(cpp4r::arrow::import_data_frame(&schema, &array));
+    schema.release(&schema);
+    expect_true(array.release == nullptr);
+
+    expect_true(out.nrow() == 3);
+    expect_true(out.ncol() == 4);
+    cpp4r::doubles x = out.column<cpp4r::doubles>("x");
+    expect_true(x[0] == 1.5 && ISNA(x[1]) && x[2] == 3.5);
+    cpp4r::integers n = out.column<cpp4r::integers>("n");
+    expect_true(n[0] == 1 && n[1] == 2 && n[2] == NA_INTEGER);
+    cpp4r::strings s = out.column<cpp4r::strings>("s");
+    expect_true(s[0] == "a" && s[2] == NA_STRING);
+    cpp4r::logicals f = out.column<cpp4r::logicals>("f");
+    expect_true(f[0] == TRUE && f[1] == NA_LOGICAL && f[2] == FALSE);
+  }
+}
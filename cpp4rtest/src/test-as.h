@@ -468,4 +468,54 @@ context("as_cpp-C++") {
 
     UNPROTECT(1);
   }
+
+  test_that("as_sexp(std::map) returns typed named vectors") {
+    std::map<std::string, double> prices = {{"b", 2.5}, {"a", 1.5}};
+    SEXP x = PROTECT(cpp4r::as_sexp(prices));
+    expect_true(TYPEOF(x) == REALSXP && Rf_xlength(x) == 2);
+    expect_true(REAL(x)[0] == 1.5 && REAL(x)[1] == 2.5);
+    SEXP names = Rf_getAttrib(x, R_NamesSymbol);
+    expect_true(strcmp(CHAR(STRING_ELT(names, 0)), "a") == 0);
+
+    std::map<double, int> counts = {{0.1, 2}, {-1, 1}};
+    SEXP y = PROTECT(cpp4r::as_sexp(counts));
+    expect_true(TYPEOF(y) == INTSXP && INTEGER(y)[0] == 1 && INTEGER(y)[1] == 2);
+    SEXP y_names = Rf_getAttrib(y, R_NamesSymbol);
+    expect_true(strcmp(CHAR(STRING_ELT(y_names, 0)), "-1") == 0);
+    expect_true(strcmp(CHAR(STRING_ELT(y_names, 1)), "0.1") == 0);
+
+    std::map<int, std::string> labels = {{1, "one"}};
+    SEXP z = PROTECT(cpp4r::as_sexp(labels));
+    expect_true(TYPEOF(z) == STRSXP && strcmp(CHAR(STRING_ELT(z, 0)), "one") == 0);
+
+    std::map<std::string, SEXP> values = {{"x", R_NilValue}};
+    SEXP l = PROTECT(cpp4r::as_sexp(values));
+    expect_true(TYPEOF(l) == VECSXP && VECTOR_ELT(l, 0) == R_NilValue);
+
+    UNPROTECT(4);
+  }
+
+  test_that("as_sexp(std::unordered_map) can sort and return data frames") {
+    std::unordered_map<int, bool> flags;
+    for (int i = 100; i > 0; --i) {
+      flags[i] = i % 2 == 0;
+    }
+    cpp4r::map_options options;
+    options.sort = true;
+    options.data_frame = true;
+
+    SEXP x = PROTECT(cpp4r::as_sexp(flags, options));
+    expect_true(Rf_inherits(x, "data.frame") && Rf_xlength(x) == 2);
+    SEXP keys = VECTOR_ELT(x, 0);
+    SEXP values = VECTOR_ELT(x, 1);
+    expect_true(TYPEOF(keys) == INTSXP && TYPEOF(values) == LGLSXP);
+    expect_true(Rf_xlength(keys) == 100);
+    bool sorted = true;
+    for (int i = 0; i < 100; ++i) {
+      sorted = sorted && INTEGER(keys)[i] == i + 1 && LOGICAL(values)[i] == (i % 2 == 1);
+    }
+    expect_true(sorted);
+
+    UNPROTECT(1);
+  }
 }
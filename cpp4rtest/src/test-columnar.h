@@ -0,0 +1,101 @@
+#include <testthat.h>
+
+// A path in the session's temporary directory
+static std::string columnar_test_path() {
+  const char* dir = std::getenv("R_SESSION_TMPDIR");
+  char* name = R_tmpnam("cpp4r", dir == nullptr ? "." : dir);
+  std::string path(name);
+  R_free_tmpnam(name);
+  return path;
+}
+
+context("columnar-C++") {
+  test_that("data frames round trip through columnar files") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::strings s({"a", NA_STRING, "", "a"});
+    cpp4r::writable::logicals l({TRUE, NA_LOGICAL, FALSE, TRUE});
+    cpp4r::writable::strings codes({"b", "a", NA_STRING, "b"});
+    cpp4r::factor f = cpp4r::as_factor(codes);
+    cpp4r::writable::data_frame df({"x"_nm = {1.5, NA_REAL, -3., R_NaN},
+                                    "n"_nm = {1, 2, NA_INTEGER, 4}, "s"_nm = s,
+                                    "l"_nm = l, "f"_nm = f});
+    std::string path = columnar_test_path();
+    cpp4r::write_columnar(df, path);
+
+    cpp4r::data_frame out = cpp4r::read_columnar(path);
+    expect_true(out.nrow() == 4);
+    expect_true(out.ncol() == 5);
+    cpp4r::doubles x = out.column<cpp4r::doubles>("x");
+    expect_true(x[0] == 1.5 && ISNA(x[1]) && x[2] == -3. && ISNAN(x[3]));
+    cpp4r::integers n = out.column<cpp4r::integers>("n");
+    expect_true(n[0] == 1 && n[2] == NA_INTEGER && n[3] == 4);
+    cpp4r::strings s2 = out.column<cpp4r::strings>("s");
+    expect_true(s2[0] == "a" && s2[1] == NA_STRING && s2[2] == "" && s2[3] == "a");
+    cpp4r::logicals l2 = out.column<cpp4r::logicals>("l");
+    expect_true(l2[0] == TRUE && l2[1] == NA_LOGICAL && l2[2] == FALSE);
+    SEXP f2 = VECTOR_ELT(out, 4);
+    expect_true(Rf_inherits(f2, "factor"));
+    cpp4r::strings levels(Rf_getAttrib(f2, R_LevelsSymbol));
+    expect_true(levels.size() == 2 && levels[0] == "b" && levels[1] == "a");
+    expect_true(INTEGER(f2)[0] == 1 && INTEGER(f2)[1] == 2);
+    expect_true(INTEGER(f2)[2] == NA_INTEGER);
+    std::remove(path.c_str());
+  }
+
+  test_that("columnar files project columns and rows") {
+    using namespace cpp4r::literals;
+    const int n = 1000;
+    cpp4r::writable::integers id(n);
+    cpp4r::writable::doubles value(n);
+    cpp4r::writable::strings label(n);
+    for (int i = 0; i < n; ++i) {
+      id[i] = i;
+      value[i] = i % 10 == 0 ? NA_REAL : i / 2.;
+      label[i] = "row" + std::to_string(i % 3);
+    }
+    cpp4r::writable::data_frame df(
+        {"id"_nm = id, "value"_nm = value, "label"_nm = label});
+    std::string path = columnar_test_path();
+    cpp4r::columnar_options options;
+    options.block_rows = 300;
+    cpp4r::write_columnar(df, path, options);
+
+    cpp4r::columnar_file file(path);
+    expect_true(file.nrow() == n && file.ncol() == 3 && file.block_rows() == 300);
+    expect_true(file.find("label") == 2 && file.find("nope") == -1);
+    const std::vector<cpp4r::columnar_stats>& stats = file.stats(1);
+    expect_true(stats.size() == 4);
+    expect_true(stats[0].min == 0.5 && stats[0].max == 149.5);
+    expect_true(stats[0].na_count == 30);
+    expect_true(stats[3].min == 450.5 && stats[3].max == 499.5);
+    expect_true(stats[3].na_count == 10);
+    expect_true(file.stats(2)[1].na_count == 0 && ISNA(file.stats(2)[1].min));
+
+    cpp4r::data_frame part = file.read({"label", "id"}, 250, 260, true);
+    expect_true(part.nrow() == 10 && part.ncol() == 2);
+    cpp4r::integers id2 = part.column<cpp4r::integers>("id");
+    cpp4r::strings label2 = part.column<cpp4r::strings>("label");
+    expect_true(id2[0] == 250 && id2[9] == 259);
+    expect_true(label2[0] == "row1" && label2[9] == "row1");
+    expect_error(file.read({"nope"}));
+    expect_error(file.read({}, 10, 5));
+    expect_error(file.read({}, 0, n + 1));
+    std::remove(path.c_str());
+  }
+
+  test_that("columnar_file rejects other files") {
+    std::string path = columnar_test_path();
+    expect_error(cpp4r::columnar_file{path});
+    FILE* file = std::fopen(path.c_str(), "wb");
+    std::fputs("x,y\n1,2\n this is not a columnar file", file);
+    std::fclose(file);
+    expect_error(cpp4r::columnar_file{path});
+    std::remove(path.c_str());
+
+    using namespace cpp4r::literals;
+    cpp4r::writable::list x({cpp4r::writable::doubles({1.})});
+    cpp4r::writable::data_frame df({"x"_nm = x});
+    expect_error(cpp4r::write_columnar(df, path));
+    std::remove(path.c_str());
+  }
+}
@@ -0,0 +1,125 @@
+#include <testthat.h>
+
+context("concat-C++") {
+  test_that("concat() joins a list of vectors") {
+    cpp4r::writable::list pieces(
+        {cpp4r::writable::doubles({1., 2.}), cpp4r::writable::doubles(R_xlen_t(0)),
+         cpp4r::writable::doubles({3.})});
+    cpp4r::doubles x = cpp4r::concat(cpp4r::list_of<cpp4r::doubles>(pieces));
+    expect_true(x.size() == 3);
+    expect_true(x[0] == 1. && x[1] == 2. && x[2] == 3.);
+    expect_true(Rf_getAttrib(x, R_NamesSymbol) == R_NilValue);
+
+    cpp4r::writable::list strings(
+        {cpp4r::writable::strings({"a", NA_STRING}), cpp4r::writable::strings({"b"})});
+    cpp4r::strings s = cpp4r::concat(cpp4r::list_of<cpp4r::strings>(strings));
+    expect_true(s.size() == 3 && s[0] == "a" && s[1] == NA_STRING && s[2] == "b");
+    // The CHARSXPs are shared with the pieces
+    expect_true(STRING_ELT(s, 2) == STRING_ELT(VECTOR_ELT(strings, 1), 0));
+
+    cpp4r::writable::list empty(R_xlen_t(0));
+    cpp4r::logicals none = cpp4r::concat(cpp4r::list_of<cpp4r::logicals>(empty));
+    expect_true(none.size() == 0 && TYPEOF(none) == LGLSXP);
+  }
+
+  test_that("concat() carries names") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::integers named({"a"_nm = 1, "b"_nm = 2});
+    cpp4r::writable::integers unnamed({3});
+    cpp4r::writable::list pieces({named, unnamed});
+
+    cpp4r::integers x = cpp4r::concat(cpp4r::list_of<cpp4r::integers>(pieces));
+    cpp4r::strings names(Rf_getAttrib(x, R_NamesSymbol));
+    expect_true(names.size() == 3);
+    expect_true(names[0] == "a" && names[1] == "b" && names[2] == "");
+
+    cpp4r::concat_options options;
+    options.names = false;
+    cpp4r::integers y = cpp4r::concat(cpp4r::list_of<cpp4r::integers>(pieces), options);
+    expect_true(Rf_getAttrib(y, R_NamesSymbol) == R_NilValue);
+  }
+
+  test_that("concat() takes vectors as arguments") {
+    cpp4r::writable::integers a({1, 2});
+    cpp4r::writable::integers b({3});
+    cpp4r::integers c({4, 5});
+    cpp4r::integers x = cpp4r::concat(a, b, c);
+    expect_true(x.size() == 5 && x[0] == 1 && x[2] == 3 && x[4] == 5);
+
+    cpp4r::writable::doubles d({1.});
+    expect_error(cpp4r::concat(a, b, d));
+  }
+
+  test_that("concat() truncates and names vectors grown with push_back()") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::doubles a;
+    a.push_back(1);
+    a.push_back(2);
+    a.push_back("c"_nm = 3.);
+    cpp4r::writable::doubles b({4.});
+    cpp4r::doubles x = cpp4r::concat(a, b);
+    expect_true(x.size() == 4);
+    expect_true(x[0] == 1 && x[1] == 2 && x[2] == 3 && x[3] == 4);
+    cpp4r::strings names(x.names());
+    expect_true(names[0] == "" && names[2] == "c" && names[3] == "");
+  }
+
+  test_that("concat() copies large totals in pieces") {
+    const int n_pieces = 300;
+    cpp4r::writable::list pieces(n_pieces);
+    for (int k = 0; k < n_pieces; ++k) {
+      cpp4r::writable::doubles piece(5000);
+      for (int i = 0; i < 5000; ++i) {
+        piece[i] = k * 5000. + i;
+      }
+      pieces[k] = piece;
+    }
+    cpp4r::concat_options options;
+    options.num_threads = 4;
+    cpp4r::doubles x = cpp4r::concat(cpp4r::list_of<cpp4r::doubles>(pieces), options);
+    bool ok = x.size() == n_pieces * 5000;
+    for (R_xlen_t i = 0; ok && i < x.size(); ++i) {
+      ok = x[i] == static_cast<double>(i);
+    }
+    expect_true(ok);
+  }
+
+  test_that("rbind() binds data frames with the same columns") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::strings s1({"b", "a"});
+    cpp4r::writable::strings s2({"a"});
+    cpp4r::factor f1 = cpp4r::as_factor(s1);
+    cpp4r::writable::integers codes({2});
+    codes.attr("levels") = Rf_getAttrib(f1, R_LevelsSymbol);
+    codes.attr("class") = "factor";
+    cpp4r::writable::data_frame df1({"x"_nm = {1.5, 2.5}, "s"_nm = s1, "f"_nm = f1});
+    cpp4r::writable::data_frame df2({"x"_nm = {3.5}, "s"_nm = s2, "f"_nm = codes});
+    cpp4r::writable::list frames({df1, df2});
+
+    cpp4r::data_frame out = cpp4r::rbind(cpp4r::list_of<cpp4r::data_frame>(frames));
+    expect_true(out.nrow() == 3 && out.ncol() == 3);
+    cpp4r::doubles x = out.column<cpp4r::doubles>("x");
+    expect_true(x[0] == 1.5 && x[2] == 3.5);
+    cpp4r::strings s = out.column<cpp4r::strings>("s");
+    expect_true(s[0] == "b" && s[2] == "a");
+    SEXP f = VECTOR_ELT(out, 2);
+    expect_true(Rf_inherits(f, "factor"));
+    expect_true(INTEGER(f)[0] == 1 && INTEGER(f)[2] == 2);
+
+    cpp4r::writable::data_frame other({"x"_nm = {1}, "s"_nm = s2, "f"_nm = codes});
+    cpp4r::writable::list mismatched({df1, other});
+    expect_error(cpp4r::rbind(cpp4r::list_of<cpp4r::data_frame>(mismatched)));
+
+    cpp4r::writable::data_frame renamed({"y"_nm = {3.5}, "s"_nm = s2, "f"_nm = codes});
+    cpp4r::writable::list misnamed({df1, renamed});
+    expect_error(cpp4r::rbind(cpp4r::list_of<cpp4r::data_frame>(misnamed)));
+
+    cpp4r::sexp stripped(Rf_shallow_duplicate(df1));
+    Rf_setAttrib(stripped, R_NamesSymbol, R_NilValue);
+    cpp4r::writable::list unnamed({df1, stripped});
+    expect_error(cpp4r::rbind(cpp4r::list_of<cpp4r::data_frame>(unnamed)));
+
+    cpp4r::writable::list none(R_xlen_t(0));
+    expect_true(cpp4r::rbind(cpp4r::list_of<cpp4r::data_frame>(none)).ncol() == 0);
+  }
+}
@@ -121,4 +121,83 @@ context("data_frame-C++") {
 
     expect_true(out.nrow() == 10);
   }
+
+  test_that("data_frame::column() looks up columns by name") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::data_frame df({"x"_nm = {1., 2., 3.}, "y"_nm = {"a", "b", "c"}});
+
+    expect_true(df.column_index("y") == 1);
+    cpp4r::doubles x = df.column<cpp4r::doubles>("x");
+    expect_true(x[2] == 3.);
+    cpp4r::strings y = df.column<cpp4r::strings>("y");
+    expect_true(y[0] == "a");
+
+    expect_error(df.column<cpp4r::doubles>("z"));
+    expect_error(df.column<cpp4r::doubles>("y"));
+
+    df.names() = {"a", "b"};
+    expect_true(df.column_index("b") == 1);
+    expect_error(df.column_index("x"));
+  }
+
+  test_that("data_frame::column_index() sees names edited in place") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::data_frame df({"x"_nm = {1., 2.}, "y"_nm = {3., 4.}});
+    expect_true(df.column_index("x") == 0);
+
+    SEXP names = Rf_getAttrib(df, R_NamesSymbol);
+    SET_STRING_ELT(names, 0, Rf_mkChar("y"));
+    SET_STRING_ELT(names, 1, Rf_mkChar("x"));
+    expect_true(df.column_index("x") == 1);
+    expect_true(df.column_index("y") == 0);
+
+    SET_STRING_ELT(names, 0, Rf_mkChar("z"));
+    expect_true(df.column_index("z") == 0);
+    expect_true(df.column<cpp4r::doubles>("z")[1] == 2.);
+  }
+
+  test_that("data_frame copies look up columns of their own data") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::data_frame x({"a"_nm = {1., 2.}, "b"_nm = {3., 4.}});
+    cpp4r::writable::data_frame y({"b"_nm = {5., 6.}});
+    expect_true(x.column_index("b") == 1);
+
+    cpp4r::data_frame copy(x);
+    expect_true(copy.column_index("b") == 1);
+    copy = y;
+    expect_true(copy.column_index("b") == 0);
+    expect_error(copy.column_index("a"));
+    expect_true(x.column_index("a") == 0);
+  }
+
+  test_that("data_frame::chunks() iterates over blocks of rows") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::data_frame df({"x"_nm = {1., 2., 3., 4., 5.},
+                                    "g"_nm = {1, 2, 1, 2, 1},
+                                    "s"_nm = {"a", "b", "c", "d", "e"}});
+
+    R_xlen_t n_chunks = 0;
+    R_xlen_t n_rows = 0;
+    double sum = 0;
+    for (auto chunk : df.chunks<double, int, cpp4r::r_string>({"x", "g", "s"}, 2)) {
+      const double* x = chunk.get<0>();
+      const int* g = chunk.get<1>();
+      const SEXP* s = chunk.get<2>();
+      expect_true(chunk.offset() == 2 * n_chunks);
+      for (R_xlen_t i = 0; i < chunk.size(); ++i) {
+        sum += x[i] * g[i];
+      }
+      const char* first[] = {"a", "c", "e"};
+      expect_true(cpp4r::r_string(s[0]) == first[n_chunks]);
+      n_rows += chunk.size();
+      ++n_chunks;
+    }
+    expect_true(n_chunks == 3);
+    expect_true(n_rows == 5);
+    expect_true(sum == 1. + 4. + 3. + 8. + 5.);
+
+    expect_error(df.chunks<int>({"x"}));
+    expect_error(df.chunks<double>({"x", "g"}));
+    expect_error(df.chunks<double>({"x"}, 0));
+  }
 }
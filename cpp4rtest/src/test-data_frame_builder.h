@@ -0,0 +1,64 @@
+#include <testthat.h>
+
+context("data_frame_builder-C++") {
+  test_that("data_frame_builder.append_row()") {
+    cpp4r::data_frame_builder<double, int, cpp4r::r_bool, cpp4r::r_string> b(
+        {"x", "g", "l", "s"});
+
+    for (int i = 0; i < 100; ++i) {
+      b.append_row(i / 2., i % 3, i % 2 == 0, std::to_string(i));
+    }
+    expect_true(b.size() == 100);
+    expect_true(b.capacity() == 128);
+
+    cpp4r::writable::data_frame df = b.finish();
+    expect_true(df.nrow() == 100);
+    expect_true(df.ncol() == 4);
+    expect_true(b.size() == 0);
+
+    cpp4r::doubles x(df["x"]);
+    cpp4r::integers g(df["g"]);
+    cpp4r::logicals l(df["l"]);
+    cpp4r::strings s(df["s"]);
+    expect_true(x.size() == 100);
+    expect_true(x[99] == 49.5);
+    expect_true(g[4] == 1);
+    expect_true(l[1] == FALSE);
+    expect_true(s.size() == 100);
+    expect_true(s[42] == "42");
+
+    SEXP row_names = Rf_getAttrib(df, R_RowNamesSymbol);
+    expect_true(Rf_xlength(row_names) == 100);
+    expect_true(Rf_inherits(df, "data.frame"));
+  }
+
+  test_that("data_frame_builder.append_rows()") {
+    cpp4r::data_frame_builder<double, cpp4r::r_string> b({"x", "s"}, 2);
+    b.append_row(NA_REAL, NA_STRING);
+
+    double x[] = {1., 2., 3.};
+    SEXP s[] = {Rf_mkChar("a"), Rf_mkChar("b"), Rf_mkChar("c")};
+    b.append_rows(3, x, s);
+    expect_true(b.size() == 4);
+
+    cpp4r::writable::data_frame df = b.finish();
+    cpp4r::doubles out_x(df["x"]);
+    cpp4r::strings out_s(df["s"]);
+    expect_true(ISNA(out_x[0]));
+    expect_true(out_x[3] == 3.);
+    expect_true(out_s[0] == NA_STRING);
+    expect_true(out_s[3] == "c");
+  }
+
+  test_that("data_frame_builder checks its schema") {
+    expect_error(cpp4r::data_frame_builder<double>({"x", "y"}));
+
+    cpp4r::data_frame_builder<int, cpp4r::r_string> b({"x", "s"});
+    cpp4r::writable::data_frame df = b.finish();
+    expect_true(df.nrow() == 0);
+    expect_true(df.ncol() == 2);
+    expect_true(TYPEOF(df["x"]) == INTSXP);
+    expect_true(TYPEOF(df["s"]) == STRSXP);
+    expect_true(Rf_xlength(df["s"]) == 0);
+  }
+}
@@ -0,0 +1,104 @@
+#include <testthat.h>
+
+context("factor-C++") {
+  test_that("as_factor() uses levels in order of appearance") {
+    cpp4r::writable::strings x({"b", "a", "b", "c", "a"});
+    cpp4r::factor f = cpp4r::as_factor(x);
+
+    expect_true(f.size() == 5);
+    expect_true(f.nlevels() == 3);
+    expect_true(f.levels()[0] == "b");
+    expect_true(f.levels()[1] == "a");
+    expect_true(f.levels()[2] == "c");
+    expect_true(f[0] == 1);
+    expect_true(f[1] == 2);
+    expect_true(f[2] == 1);
+    expect_true(f[3] == 3);
+    expect_true(f[4] == 2);
+    expect_true(Rf_inherits(f, "factor"));
+    expect_true(!f.ordered());
+  }
+
+  test_that("as_factor() can sort levels") {
+    cpp4r::writable::strings x({"b", "a", "b", "c", "a"});
+    cpp4r::factor f = cpp4r::as_factor(x, true);
+
+    expect_true(f.levels()[0] == "a");
+    expect_true(f.levels()[1] == "b");
+    expect_true(f.levels()[2] == "c");
+    expect_true(f[0] == 2);
+    expect_true(f[1] == 1);
+    expect_true(f[3] == 3);
+    expect_true(f.level(4) == "a");
+  }
+
+  test_that("as_factor() keeps NA out of the levels") {
+    cpp4r::writable::strings x({"a", NA_STRING, "a"});
+    cpp4r::factor f = cpp4r::as_factor(x);
+
+    expect_true(f.nlevels() == 1);
+    expect_true(f[1] == NA_INTEGER);
+    expect_true(f.level(1) == NA_STRING);
+  }
+
+  test_that("as_factor() returns factors unchanged and rejects other types") {
+    cpp4r::writable::strings x({"a", "b"});
+    cpp4r::factor f = cpp4r::as_factor(x);
+    cpp4r::factor g = cpp4r::as_factor(f);
+    expect_true(f.data() == g.data());
+
+    expect_error(cpp4r::as_factor(cpp4r::writable::doubles({1., 2.})));
+    expect_error(cpp4r::factor(x.data()));
+  }
+
+  test_that("factor iteration yields codes and levels") {
+    cpp4r::writable::strings x({"x", NA_STRING, "y", "x"});
+    cpp4r::factor f = cpp4r::as_factor(x);
+
+    int i = 0;
+    for (auto el : f) {
+      if (i == 1) {
+        expect_true(el.is_na());
+        expect_true(el.level == NA_STRING);
+      } else {
+        expect_true(el.level == STRING_ELT(x, i));
+      }
+      ++i;
+    }
+    expect_true(i == 4);
+  }
+
+  test_that("writable::factor.push_back()") {
+    cpp4r::writable::factor x;
+    x.push_back("b");
+    x.push_back("a");
+    x.push_back(NA_STRING);
+    x.push_back("b");
+    x.sort_levels();
+
+    expect_true(x.size() == 4);
+    expect_true(x.nlevels() == 2);
+
+    cpp4r::factor f(x);
+    expect_true(f.levels()[0] == "a");
+    expect_true(f[0] == 2);
+    expect_true(f[1] == 1);
+    expect_true(f[2] == NA_INTEGER);
+    expect_true(f[3] == 2);
+  }
+
+  test_that("writable::factor from codes and levels") {
+    cpp4r::writable::factor x(cpp4r::writable::integers({1, 2}),
+                              cpp4r::writable::strings({"lo", "hi"}));
+    x.push_back("hi");
+    x.push_back("mid");
+
+    cpp4r::factor f(x);
+    expect_true(f.nlevels() == 3);
+    expect_true(f[2] == 2);
+    expect_true(f.level(3) == "mid");
+
+    expect_error(cpp4r::writable::factor(cpp4r::writable::integers({1}),
+                                         cpp4r::writable::strings({"a", "a"})));
+  }
+}
@@ -38,4 +38,64 @@ context("function-C++") {
   test_that("unknown packages cause an error (#317)") {
     expect_error_as(cpp4r::package("definitely_not_a_package"), cpp4r::unwind_exception);
   }
+
+  test_that("prepared_call reuses its call and argument slots") {
+    auto sum = cpp4r::package("base")["sum"];
+    cpp4r::writable::doubles x({1., 2.});
+    cpp4r::prepared_call call(sum, x);
+    expect_true(call.size() == 1);
+    expect_true(call.arg(0) == x.data());
+
+    SEXP call_sexp = call.call();
+    expect_true(REAL(call())[0] == 3.);
+
+    // Arguments can be overwritten in place or replaced
+    REAL(x.data())[1] = 10.;
+    expect_true(REAL(call())[0] == 11.);
+    call.set_arg(0, cpp4r::as_sexp({4., 5., 6.}));
+    expect_true(REAL(call())[0] == 15.);
+    expect_true(call.call() == call_sexp);
+
+    expect_error(call.set_arg(1, R_NilValue));
+  }
+
+  test_that("prepared_call evaluates in its environment") {
+    using namespace cpp4r::literals;
+
+    auto sum = cpp4r::package("base")["sum"];
+    auto new_env = cpp4r::package("base")["new.env"];
+    cpp4r::sexp env = new_env();
+    cpp4r::writable::doubles y({1., NA_REAL});
+    Rf_defineVar(Rf_install("y"), y, env);
+
+    cpp4r::prepared_call call(sum, Rf_install("y"), "na.rm"_nm = true);
+    call.set_env(env);
+    expect_true(call.env() == env);
+    expect_true(REAL(call())[0] == 1.);
+  }
+
+  test_that("package lookups are cached until invalidated") {
+    cpp4r::detail::package_cache& cache = cpp4r::detail::package_cache::get();
+
+    cpp4r::package base("base");
+    base.prefetch({"sum", "paste"});
+    SEXP sum = cache.functions[R_BaseEnv][Rf_install("sum")];
+    expect_true(cache.functions[R_BaseEnv].count(Rf_install("paste")) == 1);
+    expect_true(cpp4r::detail::r_typeof(sum) == BUILTINSXP);
+
+    double res = base["sum"](cpp4r::as_sexp({1., 2.}));
+    expect_true(res == 3.);
+    base[cpp4r::symbol("sum")];
+    expect_true(cache.functions[R_BaseEnv][Rf_install("sum")] == sum);
+    expect_true(cache.functions[R_BaseEnv].size() == 2);
+
+    cpp4r::package::invalidate("base");
+    expect_true(cache.functions.count(R_BaseEnv) == 0);
+
+    auto median = cpp4r::package("stats")["median"];
+    expect_true(cache.namespaces.count("stats") == 1);
+    cpp4r::package::invalidate();
+    expect_true(cache.namespaces.empty() && cache.functions.empty());
+    expect_true(cpp4r::as_cpp<double>(median(cpp4r::as_sexp({1., 3.}))) == 2.);
+  }
 }
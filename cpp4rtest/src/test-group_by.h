@@ -0,0 +1,128 @@
+#include <testthat.h>
+
+context("group_by-C++") {
+  test_that("group_by() numbers groups in order of first appearance") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::data_frame df({"k1"_nm = {"b", "a", "b", "a", "c"},
+                                    "k2"_nm = {1, 2, 1, 3, 1},
+                                    "x"_nm = {1., 2., 3., 4., 5.}});
+
+    auto g = cpp4r::group_by(df, {"k1", "k2"});
+    expect_true(g.nrow() == 5);
+    expect_true(g.ngroups() == 4);
+
+    cpp4r::integers ids = g.ids();
+    expect_true(ids[0] == 1);
+    expect_true(ids[1] == 2);
+    expect_true(ids[2] == 1);
+    expect_true(ids[3] == 3);
+    expect_true(ids[4] == 4);
+
+    cpp4r::integers sizes = g.sizes();
+    expect_true(sizes[0] == 2);
+    expect_true(sizes[1] == 1);
+
+    cpp4r::integers order = g.order();
+    expect_true(order[0] == 1);
+    expect_true(order[1] == 3);
+    expect_true(order[2] == 2);
+    expect_true(order[3] == 4);
+    expect_true(order[4] == 5);
+
+    cpp4r::integers first = g.first_rows();
+    expect_true(first[2] == 4);
+  }
+
+  test_that("grouped reductions") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::data_frame df({"g"_nm = {1, 2, 1, 2, 3},
+                                    "x"_nm = {1., 2., 3., NA_REAL, 5.},
+                                    "y"_nm = {10, 20, 30, 40, 50}});
+    auto g = cpp4r::group_by(df, {"g"});
+
+    cpp4r::doubles sum = g.sum(df["x"]);
+    expect_true(sum[0] == 4.);
+    expect_true(ISNA(sum[1]));
+    expect_true(sum[2] == 5.);
+
+    cpp4r::doubles sum_na_rm = g.sum(df["x"], true);
+    expect_true(sum_na_rm[1] == 2.);
+
+    cpp4r::doubles mean = g.mean(df["y"]);
+    expect_true(mean[0] == 20.);
+    expect_true(mean[1] == 30.);
+
+    cpp4r::doubles min = g.min(df["y"]);
+    cpp4r::doubles max = g.max(df["y"]);
+    expect_true(min[1] == 20.);
+    expect_true(max[1] == 40.);
+
+    cpp4r::integers count = g.count();
+    expect_true(count[2] == 1);
+
+    cpp4r::integers first = g.first(df["y"]);
+    expect_true(first[0] == 10);
+    expect_true(first[1] == 20);
+    expect_true(first[2] == 50);
+
+    expect_error(g.sum(cpp4r::writable::doubles({1., 2.})));
+    expect_error(g.sum(cpp4r::writable::strings({"a", "b", "c", "d", "e"})));
+  }
+
+  test_that("group_by() handles doubles, NA and factors") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::strings s({"a", NA_STRING, "a", NA_STRING});
+    cpp4r::writable::data_frame df({"d"_nm = {0., -0., NA_REAL, NA_REAL},
+                                    "f"_nm = cpp4r::as_factor(s)});
+
+    auto by_d = cpp4r::group_by(df, {"d"});
+    expect_true(by_d.ngroups() == 2);
+
+    auto by_f = cpp4r::group_by(df, {"f"});
+    expect_true(by_f.ngroups() == 2);
+    expect_true(by_f.ids()[3] == 2);
+
+    expect_error(cpp4r::group_by(df, {"missing"}));
+  }
+
+  test_that("grouped reductions keep NaN apart from NA and reject factors") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::strings s({"a", "b", "a", "b"});
+    cpp4r::writable::data_frame df({"g"_nm = {1, 1, 2, 2},
+                                    "x"_nm = {R_NaN, 1., R_NaN, NA_REAL},
+                                    "f"_nm = cpp4r::as_factor(s)});
+    auto g = cpp4r::group_by(df, {"g"});
+
+    cpp4r::doubles sum = g.sum(df["x"]);
+    expect_true(ISNAN(sum[0]) && !ISNA(sum[0]));
+    expect_true(ISNA(sum[1]));
+
+    cpp4r::doubles min = g.min(df["x"]);
+    cpp4r::doubles max = g.max(df["x"]);
+    expect_true(ISNAN(min[0]) && !ISNA(min[0]));
+    expect_true(ISNAN(max[0]) && !ISNA(max[0]));
+
+    cpp4r::doubles sum_na_rm = g.sum(df["x"], true);
+    expect_true(sum_na_rm[0] == 1.);
+    expect_true(sum_na_rm[1] == 0.);
+
+    expect_error(g.sum(df["f"]));
+    expect_error(g.mean(df["f"]));
+  }
+
+  test_that("group_by() partitions large inputs") {
+    R_xlen_t n = cpp4r::grouping::partition_threshold + 10;
+    cpp4r::writable::integers k(n);
+    for (R_xlen_t i = 0; i < n; ++i) {
+      k[i] = static_cast<int>((i * 7) % 1000);
+    }
+    cpp4r::grouping g(n, {k});
+
+    expect_true(g.ngroups() == 1000);
+    cpp4r::integers ids = g.ids();
+    expect_true(ids[0] == 1);
+    expect_true(ids[1] == 2);
+    expect_true(ids[1000] == 1);
+    expect_true(g.sizes()[0] == static_cast<int>((n + 999) / 1000));
+  }
+}
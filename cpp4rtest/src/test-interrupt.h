@@ -0,0 +1,41 @@
+#include <testthat.h>
+
+#include <thread>
+#include <vector>
+
+context("interrupt-C++") {
+  test_that("interrupt_checker polls without interrupts") {
+    cpp4r::interrupt_checker checker(0);
+    for (int i = 0; i < 10; ++i) {
+      expect_false(checker.check());
+    }
+    expect_false(checker.interrupted());
+    checker.unwind_if_interrupted();
+  }
+
+  test_that("interrupt_checker shares cancellation with workers") {
+    cpp4r::interrupt_checker checker(0, 4);
+    std::atomic<int> done{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+      workers.emplace_back([&checker, &done, t] {
+        while (!checker.check()) {
+          if (t == 0) {
+            checker.cancel();
+          }
+        }
+        ++done;
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    expect_true(done == 4);
+    expect_true(checker.cancelled() && checker.flag());
+    expect_true(checker.check());
+
+    // Cancellation without a user interrupt does not unwind
+    expect_false(checker.interrupted());
+    checker.unwind_if_interrupted();
+  }
+}
@@ -0,0 +1,95 @@
+#include <testthat.h>
+
+context("join-C++") {
+  using namespace cpp4r::literals;
+
+  test_that("join_indices() inner and left joins") {
+    cpp4r::writable::data_frame left({"k"_nm = {"a", "b", "c", "a"},
+                                      "x"_nm = {1, 2, 3, 4}});
+    cpp4r::writable::data_frame right({"k"_nm = {"a", "c", "a", "d", "e", "f"},
+                                       "y"_nm = {10., 20., 30., 40., 50., 60.}});
+
+    auto inner = cpp4r::join_indices(left, right, {"k"});
+    expect_true(inner.first.size() == 5);
+    int l[] = {1, 1, 3, 4, 4};
+    int r[] = {1, 3, 2, 1, 3};
+    for (int i = 0; i < 5; ++i) {
+      expect_true(inner.first[i] == l[i]);
+      expect_true(inner.second[i] == r[i]);
+    }
+
+    auto left_join = cpp4r::join_indices(left, right, {"k"}, cpp4r::join_type::left);
+    expect_true(left_join.first.size() == 6);
+    expect_true(left_join.first[2] == 2);
+    expect_true(left_join.second[2] == NA_INTEGER);
+
+    cpp4r::data_frame out = cpp4r::join_gather(left, right, {"k"}, left_join);
+    expect_true(out.ncol() == 3);
+    expect_true(out.nrow() == 6);
+    cpp4r::doubles y(out["y"]);
+    expect_true(y[0] == 10.);
+    expect_true(ISNA(y[2]));
+    cpp4r::strings k(out["k"]);
+    expect_true(k[2] == "b");
+  }
+
+  test_that("join_indices() builds on the smaller side") {
+    cpp4r::writable::data_frame left({"k"_nm = {2, 1}});
+    cpp4r::writable::data_frame right({"k"_nm = {1., 2., 1., 3.},
+                                       "k2"_nm = {1, 1, 1, 1}});
+
+    auto inner = cpp4r::join_indices(left, right, {"k"});
+    expect_true(inner.first.size() == 3);
+    expect_true(inner.first[0] == 1);
+    expect_true(inner.second[0] == 2);
+    expect_true(inner.first[1] == 2);
+    expect_true(inner.second[1] == 1);
+    expect_true(inner.first[2] == 2);
+    expect_true(inner.second[2] == 3);
+
+    auto left_join = cpp4r::join_indices(right, left, {"k"}, cpp4r::join_type::left);
+    expect_true(left_join.first.size() == 4);
+    expect_true(left_join.second[0] == 2);
+    expect_true(left_join.second[3] == NA_INTEGER);
+  }
+
+  test_that("join_indices() semi and anti joins") {
+    cpp4r::writable::data_frame left({"k1"_nm = {"a", "a", "b"}, "k2"_nm = {1, 2, 1}});
+    cpp4r::writable::data_frame right({"k1"_nm = {"a", "b", "b"}, "k2"_nm = {2, 1, 1}});
+
+    auto semi = cpp4r::join_indices(left, right, {"k1", "k2"}, cpp4r::join_type::semi);
+    expect_true(semi.first.size() == 2);
+    expect_true(semi.first[0] == 2);
+    expect_true(semi.first[1] == 3);
+    expect_true(semi.second.size() == 0);
+
+    auto anti = cpp4r::join_indices(left, right, {"k1", "k2"}, cpp4r::join_type::anti);
+    expect_true(anti.first.size() == 1);
+    expect_true(anti.first[0] == 1);
+
+    cpp4r::data_frame out =
+        cpp4r::join_gather(left, right, {"k1", "k2"}, anti, cpp4r::join_type::anti);
+    expect_true(out.ncol() == 2);
+    expect_true(out.nrow() == 1);
+  }
+
+  test_that("join_gather() suffixes clashing names") {
+    cpp4r::writable::data_frame left({"k"_nm = {1, 2}, "v"_nm = {1, 2}});
+    cpp4r::writable::data_frame right({"k"_nm = {2, 1}, "v"_nm = {3, 4}});
+
+    auto idx = cpp4r::join_indices(left, right, {"k"});
+    cpp4r::data_frame out = cpp4r::join_gather(left, right, {"k"}, idx);
+    cpp4r::strings names(out.names());
+    expect_true(names.size() == 3);
+    expect_true(names[1] == "v.x");
+    expect_true(names[2] == "v.y");
+    expect_true(cpp4r::integers(out["v.y"])[0] == 4);
+  }
+
+  test_that("join_indices() rejects incompatible keys") {
+    cpp4r::writable::data_frame left({"k"_nm = {"a"}});
+    cpp4r::writable::data_frame right({"k"_nm = {1}});
+    expect_error(cpp4r::join_indices(left, right, {"k"}));
+    expect_error(cpp4r::join_indices(left, right, {"z"}));
+  }
+}
@@ -0,0 +1,109 @@
+#include <testthat.h>
+
+static std::string json_string(
+    SEXP x, const cpp4r::json_options& options = cpp4r::json_options()) {
+  cpp4r::raws out = cpp4r::to_json(x, options);
+  return std::string(reinterpret_cast<const char*>(RAW(out.data())), out.size());
+}
+
+context("json-C++") {
+  test_that("to_json() encodes atomic vectors") {
+    expect_true(json_string(cpp4r::writable::doubles({1.5, NA_REAL, 2})) ==
+                "[1.5,null,2]");
+    expect_true(json_string(cpp4r::writable::integers({1, NA_INTEGER})) == "[1,null]");
+    expect_true(json_string(cpp4r::writable::logicals({TRUE, FALSE, NA_LOGICAL})) ==
+                "[true,false,null]");
+    expect_true(json_string(cpp4r::writable::strings({"a", NA_STRING})) ==
+                "[\"a\",null]");
+    expect_true(json_string(R_NilValue) == "null");
+    expect_true(json_string(cpp4r::writable::doubles({R_PosInf, R_NaN})) ==
+                "[null,null]");
+
+    cpp4r::json_options options;
+    options.auto_unbox = true;
+    expect_true(json_string(cpp4r::as_sexp(0.1), options) == "0.1");
+  }
+
+  test_that("to_json() escapes strings") {
+    cpp4r::writable::strings x({"say \"hi\"\n", "a\\b\tc\x01", "caf\xc3\xa9"});
+    expect_true(json_string(x) ==
+                "[\"say \\\"hi\\\"\\n\",\"a\\\\b\\tc\\u0001\",\"caf\xc3\xa9\"]");
+  }
+
+  test_that("to_json() encodes named lists as objects") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::list inner({cpp4r::as_sexp(1), cpp4r::as_sexp("x")});
+    cpp4r::writable::list x({"a"_nm = {1, 2}, "b"_nm = inner, "c"_nm = R_NilValue});
+    expect_true(json_string(x) == "{\"a\":[1,2],\"b\":[[1],[\"x\"]],\"c\":null}");
+
+    cpp4r::writable::list bad({cpp4r::writable::complexes({{1, 2}})});
+    expect_error(cpp4r::to_json(bad));
+  }
+
+  test_that("to_json() and to_ndjson() encode data frames by row") {
+    using namespace cpp4r::literals;
+    cpp4r::factor f = cpp4r::as_factor(cpp4r::writable::strings({"b", "a"}));
+    cpp4r::writable::logicals l({TRUE, NA_LOGICAL});
+    cpp4r::writable::data_frame df({"x"_nm = {1.5, NA_REAL}, "f"_nm = f, "l"_nm = l});
+
+    const std::string row1 = "{\"x\":1.5,\"f\":\"b\",\"l\":true}";
+    const std::string row2 = "{\"x\":null,\"f\":\"a\",\"l\":null}";
+    expect_true(json_string(df) == "[" + row1 + "," + row2 + "]");
+    cpp4r::raws ndjson = cpp4r::to_ndjson(df);
+    expect_true(std::string(reinterpret_cast<const char*>(RAW(ndjson.data())),
+                            ndjson.size()) == row1 + "\n" + row2 + "\n");
+  }
+
+  test_that("to_json() rejects data frame and matrix columns") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::list cells({cpp4r::as_sexp(1), cpp4r::as_sexp("y")});
+    cpp4r::writable::data_frame lists({"x"_nm = {1.5, 2.5}, "l"_nm = cells});
+    expect_true(json_string(lists) ==
+                "[{\"x\":1.5,\"l\":[1]},{\"x\":2.5,\"l\":[\"y\"]}]");
+
+    cpp4r::writable::data_frame inner({"a"_nm = {1., 2.}, "b"_nm = {3., 4.}});
+    cpp4r::writable::data_frame nested({"x"_nm = {1., 2.}, "inner"_nm = inner});
+    expect_error(cpp4r::to_json(nested));
+    expect_error(cpp4r::to_ndjson(nested));
+
+    cpp4r::writable::doubles m({1., 2., 3., 4.});
+    m.attr("dim") = {2, 2};
+    cpp4r::writable::data_frame matrix({"x"_nm = {1., 2.}, "m"_nm = m});
+    expect_error(cpp4r::to_json(matrix));
+  }
+
+  test_that("the encoder flushes in chunks of the requested size") {
+    using namespace cpp4r::literals;
+    const int n = 10000;
+    cpp4r::writable::integers id(n);
+    std::string expected;
+    for (int i = 0; i < n; ++i) {
+      id[i] = i;
+      expected += "{\"id\":" + std::to_string(i) + "}\n";
+    }
+    cpp4r::writable::data_frame df({"id"_nm = id});
+
+    struct counting_output {
+      std::string value;
+      size_t writes = 0;
+      size_t largest = 0;
+      bool write(const char* data, size_t size) {
+        value.append(data, size);
+        ++writes;
+        largest = size > largest ? size : largest;
+        return true;
+      }
+    } output;
+    cpp4r::json_options options;
+    options.chunk_size = 1024;
+    cpp4r::detail::json_encoder<counting_output> encoder(output, options);
+    encoder.ndjson(df);
+    encoder.finish();
+
+    expect_true(output.value == expected);
+    expect_true(output.writes > 100);
+    expect_true(output.largest < 1100);
+    cpp4r::raws out = cpp4r::to_ndjson(df, options);
+    expect_true(out.size() == static_cast<R_xlen_t>(expected.size()));
+  }
+}
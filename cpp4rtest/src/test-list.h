@@ -159,6 +159,68 @@ context("list-C++") {
     expect_true(x.size() == nms.size());
   }
 
+  test_that("push_back(named_arg) attaches the names once") {
+    using namespace cpp4r::literals;
+
+    cpp4r::writable::list x;
+    for (int i = 0; i < 100; ++i) {
+      if (i % 10 == 0) {
+        x.push_back(cpp4r::as_sexp(i));
+      } else {
+        x.push_back({"n"_nm = i});
+      }
+    }
+    expect_true(x.named());
+
+    cpp4r::writable::list y(x);
+    cpp4r::writable::list z(std::move(x));
+    SEXP out = z;
+    cpp4r::strings nms(Rf_getAttrib(out, R_NamesSymbol));
+    expect_true(nms.size() == 100);
+    expect_true(nms[0] == "" && nms[1] == "n" && nms[10] == "" && nms[99] == "n");
+
+    cpp4r::strings copied(y.names());
+    expect_true(copied.size() == Rf_xlength(y.data()) && copied[1] == "n");
+
+    cpp4r::writable::doubles d;
+    d.push_back({"a"_nm = 1.5});
+    d.push_back({"b"_nm = 2.5});
+    expect_true(d["b"] == 2.5);
+    expect_error(d.push_back({"c"_nm = "x"}));
+
+    cpp4r::writable::strings s;
+    s.push_back({"a"_nm = "x"});
+    expect_true(s["a"] == "x");
+  }
+
+  test_that("buffered names are attached before contains() and data()") {
+    using namespace cpp4r::literals;
+
+    cpp4r::writable::integers x;
+    x.push_back("a"_nm = 1);
+    expect_true(x.contains("a"));
+    expect_false(x.contains("b"));
+
+    cpp4r::writable::integers y;
+    y.push_back(1);
+    y.push_back("b"_nm = 2);
+    SEXP names = Rf_getAttrib(y.data(), R_NamesSymbol);
+    expect_true(names != R_NilValue);
+    expect_true(std::string(CHAR(STRING_ELT(names, 1))) == "b");
+
+    // Names pushed after an attach are attached too
+    y.push_back("c"_nm = 3);
+    expect_true(y.contains("c"));
+    SEXP out = y;
+    cpp4r::strings nms(Rf_getAttrib(out, R_NamesSymbol));
+    expect_true(nms.size() == 3 && nms[0] == "" && nms[1] == "b" && nms[2] == "c");
+
+    cpp4r::writable::strings s;
+    s.push_back({"a"_nm = "x"});
+    expect_true(s.contains("a"));
+    expect_true(Rf_getAttrib(s.data(), R_NamesSymbol) != R_NilValue);
+  }
+
   test_that("list::operator[] and at by name") {
     SEXP x = PROTECT(Rf_allocVector(VECSXP, 1));
 
@@ -42,4 +42,56 @@ context("list_of-C++") {
     res["x"][0] = 4;
     expect_true(REAL(res[0])[0] == 4.);
   }
+
+  test_that("list_of views borrow their elements") {
+    using namespace cpp4r::literals;
+
+    cpp4r::writable::list x({"x"_nm = cpp4r::writable::doubles({1., 2., 3.}),
+                             "y"_nm = cpp4r::writable::doubles({4., 5.})});
+    cpp4r::list_of<cpp4r::doubles> res(x);
+
+    cpp4r::r_vector_view<double> first = res.view(0);
+    expect_true(first.size() == 3 && first[2] == 3.);
+    expect_true(first.data() == VECTOR_ELT(x, 0));
+    expect_true(first.data_ptr() == REAL(VECTOR_ELT(x, 0)));
+
+    double total = 0;
+    R_xlen_t n = 0;
+    for (auto view : res.views()) {
+      for (double value : view) {
+        total += value;
+      }
+      ++n;
+    }
+    expect_true(n == 2 && total == 15.);
+
+    cpp4r::doubles owned = res.view(1).protect();
+    expect_true(owned.size() == 2 && owned[1] == 5.);
+
+    cpp4r::writable::list bad({cpp4r::writable::integers({1})});
+    cpp4r::list_of<cpp4r::doubles> wrong(bad);
+    expect_error(wrong.view(0));
+
+    cpp4r::writable::list s({cpp4r::writable::strings({"a", "b"})});
+    cpp4r::list_of<cpp4r::strings> strings(s);
+    expect_true(strings.view(0)[1] == "b");
+  }
+
+#ifdef CPP4R_DEBUG
+  test_that("list_of views check the lifetime of their list") {
+    cpp4r::writable::list x({cpp4r::writable::doubles({1., 2.})});
+    cpp4r::r_vector_view<double> view(VECTOR_ELT(x, 0));
+    {
+      cpp4r::list_of<cpp4r::doubles> res(x);
+      view = res.view(0);
+      expect_true(view[0] == 1.);
+    }
+    expect_error(view[0]);
+
+    cpp4r::list_of<cpp4r::doubles> res(x);
+    cpp4r::r_vector_view<double> replaced = res.view(0);
+    SET_VECTOR_ELT(x, 0, cpp4r::writable::doubles({3.}));
+    expect_error(replaced[0]);
+  }
+#endif
 }
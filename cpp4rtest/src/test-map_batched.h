@@ -0,0 +1,29 @@
+#include <testthat.h>
+
+context("map_batched-C++") {
+  test_that("map_batched() calls vectorized functions in batches") {
+    auto sqrt = cpp4r::package("base")["sqrt"];
+    std::vector<double> x = {1., 4., 9., 16., 25.};
+
+    std::vector<double> expected = {1., 2., 3., 4., 5.};
+    expect_true(cpp4r::map_batched(sqrt, x, 2) == expected);
+    expect_true(cpp4r::map_batched(sqrt, x, 5) == expected);
+    expect_true(cpp4r::map_batched(sqrt, x, 100) == expected);
+    expect_true(cpp4r::map_batched(sqrt, std::vector<double>()).empty());
+    expect_error(cpp4r::map_batched(sqrt, x, 0));
+
+    // Results are coerced to the type of the output
+    cpp4r::writable::integers y({1, 4, 9});
+    cpp4r::writable::integers out = cpp4r::map_batched(sqrt, cpp4r::integers(y), 2);
+    expect_true(out.size() == 3 && out[0] == 1 && out[2] == 3);
+  }
+
+  test_that("map_batched() falls back to a call per element") {
+    // `sum()` gives a single value for a whole batch
+    auto sum = cpp4r::package("base")["sum"];
+    std::vector<double> x = {1., 2., 3.};
+    std::vector<int> out(3);
+    cpp4r::map_batched(sum, x.data(), 3, out.data(), 2);
+    expect_true(out[0] == 1 && out[1] == 2 && out[2] == 3);
+  }
+}
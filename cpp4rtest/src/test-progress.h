@@ -0,0 +1,38 @@
+#include <testthat.h>
+
+#include <thread>
+#include <vector>
+
+context("progress-C++") {
+  test_that("progress counts ticks from all threads") {
+    cpp4r::progress p(400, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+      workers.emplace_back([&p] {
+        for (int i = 0; i < 100; ++i) {
+          p.tick();
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    p.update();
+    expect_true(p.current() == 400);
+    expect_true(p.total() == 400);
+    p.done();
+    p.done();
+  }
+
+  test_that("rate_limit allows at most one call per interval") {
+    cpp4r::detail::rate_limit never(0);
+    expect_false(never.ready());
+
+    cpp4r::detail::rate_limit slow(1e-6);
+    expect_false(slow.ready());
+
+    cpp4r::detail::rate_limit fast(1e9);
+    std::this_thread::sleep_for(std::chrono::microseconds(10));
+    expect_true(fast.ready());
+  }
+}
@@ -0,0 +1,73 @@
+#include <testthat.h>
+
+context("ragged-C++") {
+  test_that("ragged converts from and to lists of vectors") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::list x({"a"_nm = {1., 2., 3.}, "b"_nm = cpp4r::writable::doubles(),
+                             "c"_nm = {4.}});
+
+    cpp4r::ragged<double> r(x);
+    expect_true(r.size() == 3);
+    expect_true(r.values().size() == 4);
+    expect_true(r.offsets()[0] == 0 && r.offsets()[1] == 3 && r.offsets()[2] == 3 &&
+                r.offsets()[3] == 4);
+    expect_true(r[0].size() == 3 && r[0][2] == 3.);
+    expect_true(r[1].empty());
+    expect_true(r[2][0] == 4.);
+
+    r.row_data(0)[0] = 10.;
+    cpp4r::list_of<cpp4r::doubles> out = r.to_list();
+    expect_true(out.size() == 3);
+    expect_true(out[0][0] == 10. && out[0][1] == 2.);
+    expect_true(out[1].size() == 0 && out[2][0] == 4.);
+    cpp4r::strings names(out.names());
+    expect_true(names[0] == "a" && names[2] == "c");
+
+    cpp4r::writable::list bad({cpp4r::writable::integers({1})});
+    expect_error(cpp4r::ragged<double>{bad});
+  }
+
+  test_that("ragged can be built row by row") {
+    cpp4r::ragged<int> r;
+    expect_true(r.empty());
+    r.push_back({1, 2});
+    r.push_back({});
+    std::vector<int> row = {3, 4, 5};
+    r.push_back(row.begin(), row.end());
+
+    expect_true(r.size() == 3 && r.row_size(2) == 3);
+    R_xlen_t rows = 0;
+    int sum = 0;
+    for (cpp4r::ragged<int>::row values : r) {
+      ++rows;
+      for (int value : values) {
+        sum += value;
+      }
+    }
+    expect_true(rows == 3 && sum == 15);
+    expect_error(r.at(3));
+
+    SEXP out = r;
+    expect_true(Rf_xlength(out) == 3 && TYPEOF(VECTOR_ELT(out, 2)) == INTSXP);
+
+    expect_error(cpp4r::ragged<int>({1, 2}, {0, 3}));
+    expect_error(cpp4r::ragged<int>({1, 2}, {0, 2, 1, 2}));
+  }
+
+  test_that("nested std::vectors convert through as_cpp() and as_sexp()") {
+    std::vector<std::vector<double>> x = {{1.5, 2.5}, {}, {3.5}};
+    SEXP list = PROTECT(cpp4r::as_sexp(x));
+    expect_true(Rf_xlength(list) == 3 && TYPEOF(VECTOR_ELT(list, 0)) == REALSXP);
+    expect_true(REAL(VECTOR_ELT(list, 2))[0] == 3.5);
+
+    auto y = cpp4r::as_cpp<std::vector<std::vector<double>>>(list);
+    expect_true(y == x);
+    UNPROTECT(1);
+
+    std::vector<std::vector<long>> z = {{1, 2}, {3}};
+    SEXP ints = PROTECT(cpp4r::as_sexp(z));
+    expect_true(TYPEOF(VECTOR_ELT(ints, 0)) == INTSXP);
+    expect_true((cpp4r::as_cpp<std::vector<std::vector<long>>>(ints)) == z);
+    UNPROTECT(1);
+  }
+}
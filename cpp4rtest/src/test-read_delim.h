@@ -0,0 +1,108 @@
+#include <testthat.h>
+
+context("read_delim-C++") {
+  test_that("parse_delim() reads typed columns") {
+    using cpp4r::column_type;
+    cpp4r::data_frame df = cpp4r::parse_delim(
+        "x,n,s,l\n1.5,1,a,TRUE\n-2e3,NA,b,F\n,3,,NA\n",
+        {column_type::real, column_type::integer, column_type::string,
+         column_type::logical});
+
+    expect_true(df.nrow() == 3);
+    expect_true(df.ncol() == 4);
+    cpp4r::doubles x = df.column<cpp4r::doubles>("x");
+    expect_true(x[0] == 1.5 && x[1] == -2000 && ISNA(x[2]));
+    cpp4r::integers n = df.column<cpp4r::integers>("n");
+    expect_true(n[0] == 1 && n[1] == NA_INTEGER && n[2] == 3);
+    cpp4r::strings s = df.column<cpp4r::strings>("s");
+    expect_true(s[0] == "a" && s[1] == "b" && s[2] == NA_STRING);
+    cpp4r::logicals l = df.column<cpp4r::logicals>("l");
+    expect_true(l[0] == TRUE && l[1] == FALSE && l[2] == NA_LOGICAL);
+  }
+
+  test_that("parse_delim() guesses column types from the first rows") {
+    cpp4r::data_frame df = cpp4r::parse_delim("a,b,c,d\n1,x,T,NA\n2.5,y,false,NA\n");
+    expect_true(cpp4r::detail::r_typeof(VECTOR_ELT(df, 0)) == REALSXP);
+    expect_true(cpp4r::detail::r_typeof(VECTOR_ELT(df, 1)) == STRSXP);
+    expect_true(cpp4r::detail::r_typeof(VECTOR_ELT(df, 2)) == LGLSXP);
+    expect_true(cpp4r::detail::r_typeof(VECTOR_ELT(df, 3)) == LGLSXP);
+
+    cpp4r::delim_options options;
+    options.guess_rows = 1;
+    expect_error(cpp4r::parse_delim("a\n1\nx\n", {}, options));
+  }
+
+  test_that("parse_delim() handles quoted fields") {
+    cpp4r::data_frame df =
+        cpp4r::parse_delim("\"a,b\",c\r\n\"x,\"\"y\"\"\n\",1\r\n\"\",2\r\n");
+    cpp4r::strings names(Rf_getAttrib(df, R_NamesSymbol));
+    expect_true(names[0] == "a,b");
+    cpp4r::strings s(VECTOR_ELT(df, 0));
+    expect_true(s.size() == 2);
+    expect_true(s[0] == "x,\"y\"\n");
+    // Quoted empty strings are not missing
+    expect_true(s[1] == "");
+    cpp4r::doubles c(VECTOR_ELT(df, 1));
+    expect_true(c[1] == 2);
+  }
+
+  test_that("parse_delim() skips columns and supports other delimiters") {
+    using cpp4r::column_type;
+    cpp4r::delim_options options;
+    options.delim = '\t';
+    options.header = false;
+    cpp4r::data_frame df = cpp4r::parse_delim(
+        "1\tx\t2\n3\ty\t4", {column_type::integer, column_type::skip, column_type::real},
+        options);
+    expect_true(df.ncol() == 2);
+    cpp4r::strings names(Rf_getAttrib(df, R_NamesSymbol));
+    expect_true(names[0] == "X1" && names[1] == "X3");
+    cpp4r::doubles x3(VECTOR_ELT(df, 1));
+    expect_true(x3[1] == 4);
+  }
+
+  test_that("parse_delim() splits large inputs into row aligned chunks") {
+    std::string text = "id,label\n";
+    for (int i = 0; i < 200000; ++i) {
+      text += std::to_string(i) + ",\"row\n" + std::to_string(i % 7) + "\"\n";
+    }
+    cpp4r::delim_options options;
+    options.num_threads = 4;
+    cpp4r::data_frame df = cpp4r::parse_delim(
+        text, {cpp4r::column_type::integer, cpp4r::column_type::string}, options);
+    expect_true(df.nrow() == 200000);
+    cpp4r::integers id(VECTOR_ELT(df, 0));
+    cpp4r::strings label(VECTOR_ELT(df, 1));
+    bool ok = true;
+    for (int i = 0; i < 200000; ++i) {
+      ok = ok && id[i] == i && label[i] == "row\n" + std::to_string(i % 7);
+    }
+    expect_true(ok);
+  }
+
+  test_that("parse_delim() reports malformed rows") {
+    using cpp4r::column_type;
+    expect_error(cpp4r::parse_delim("a,b\n1,2\n3\n"));
+    expect_error(cpp4r::parse_delim("a\n3000000000\n", {column_type::integer}));
+    expect_error(cpp4r::parse_delim("a\n1\n", {column_type::real, column_type::real}));
+    expect_error(cpp4r::read_delim("/nonexistent/cpp4r.csv"));
+  }
+
+  test_that("parse_double() matches strtod()") {
+    const char* numbers[] = {"0",      "-0.5",     "1e10",      "123456789012345678901",
+                             "0.1",    "1.7976931348623157e308", "4.9e-324", "1E-5",
+                             "+3.25",  "0.000001", "9007199254740993"};
+    for (const char* number : numbers) {
+      double value;
+      expect_true(cpp4r::detail::parse_double(number, number + std::strlen(number), value));
+      expect_true(value == std::strtod(number, nullptr));
+    }
+    double value;
+    const char* bad[] = {"", "-", "1e", "1.2.3", "abc", "1,5"};
+    for (const char* number : bad) {
+      expect_false(cpp4r::detail::parse_double(number, number + std::strlen(number), value));
+    }
+    const char* inf = "-Inf";
+    expect_true(cpp4r::detail::parse_double(inf, inf + 4, value) && value == R_NegInf);
+  }
+}
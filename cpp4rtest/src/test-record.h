@@ -0,0 +1,58 @@
+#include <testthat.h>
+
+struct Trade {
+  double price;
+  int qty;
+  std::string sym;
+  bool filled;
+};
+CPP4R_RECORD(Trade, price, qty, sym, filled)
+
+context("record-C++") {
+  test_that("as_cpp<std::vector<record>>() fills fields by column name") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::logicals filled({TRUE, FALSE, NA_LOGICAL});
+    cpp4r::writable::data_frame df({"sym"_nm = {"a", "b", "c"},
+                                    "qty"_nm = {1., 2., 3.},
+                                    "price"_nm = {1.5, 2.5, 3.5},
+                                    "filled"_nm = filled});
+
+    auto trades = cpp4r::as_cpp<std::vector<Trade>>(df);
+    expect_true(trades.size() == 3);
+    expect_true(trades[0].price == 1.5);
+    expect_true(trades[1].qty == 2);
+    expect_true(trades[2].sym == "c");
+    expect_true(trades[0].filled);
+    expect_true(!trades[2].filled);
+  }
+
+  test_that("as_cpp<std::vector<record>>() errors on missing or bad columns") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::data_frame missing({"price"_nm = {1.}, "qty"_nm = {1}});
+    expect_error(cpp4r::as_cpp<std::vector<Trade>>(missing));
+
+    cpp4r::writable::data_frame bad({"price"_nm = {1.}, "qty"_nm = {1.5},
+                                     "sym"_nm = {"a"}, "filled"_nm = {true}});
+    expect_error(cpp4r::as_cpp<std::vector<Trade>>(bad));
+  }
+
+  test_that("as_sexp(std::vector<record>) builds a data frame") {
+    std::vector<Trade> trades = {{1.5, 10, "a", true}, {2.5, 20, "b", false}};
+
+    cpp4r::data_frame df(cpp4r::as_sexp(trades));
+    expect_true(df.nrow() == 2);
+    expect_true(df.ncol() == 4);
+
+    cpp4r::strings names(df.names());
+    expect_true(names[0] == "price");
+    expect_true(names[3] == "filled");
+
+    expect_true(cpp4r::doubles(df["price"])[1] == 2.5);
+    expect_true(cpp4r::integers(df["qty"])[0] == 10);
+    expect_true(cpp4r::strings(df["sym"])[1] == "b");
+    expect_true(cpp4r::logicals(df["filled"])[0] == TRUE);
+
+    auto round_trip = cpp4r::as_cpp<std::vector<Trade>>(df);
+    expect_true(round_trip[1].sym == "b");
+  }
+}
@@ -0,0 +1,74 @@
+#include <testthat.h>
+
+context("split-C++") {
+  test_that("split() divides vectors by group") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::doubles x({"a"_nm = 1., "b"_nm = 2., "c"_nm = 3., "d"_nm = 4.});
+    cpp4r::writable::integers ids({2, 1, NA_INTEGER, 2});
+
+    cpp4r::list out = cpp4r::split(x, ids, 3);
+    expect_true(out.size() == 3);
+    cpp4r::doubles first(out[0]);
+    cpp4r::doubles second(out[1]);
+    cpp4r::doubles third(out[2]);
+    expect_true(first.size() == 1 && first[0] == 2.);
+    expect_true(second.size() == 2 && second[0] == 1. && second[1] == 4.);
+    expect_true(third.size() == 0);
+    cpp4r::strings names(Rf_getAttrib(second, R_NamesSymbol));
+    expect_true(names[0] == "a" && names[1] == "d");
+
+    cpp4r::writable::strings s({"u", "v", "w", "x"});
+    cpp4r::list strings = cpp4r::split(s, ids, 2);
+    // The CHARSXPs are shared with `s`
+    expect_true(STRING_ELT(VECTOR_ELT(strings, 1), 1) == STRING_ELT(s, 3));
+
+    cpp4r::writable::raws r({1, 2, 3, 4});
+    cpp4r::list raws = cpp4r::split(r, ids, 2);
+    expect_true(RAW(VECTOR_ELT(raws, 1))[1] == 4);
+
+    cpp4r::writable::integers bad({1, 3, 1, 1});
+    expect_error(cpp4r::split(x, bad, 2));
+    expect_error(cpp4r::split(x, cpp4r::writable::integers({1}), 1));
+  }
+
+  test_that("split() by a factor names the groups and keeps attributes") {
+    cpp4r::factor f = cpp4r::as_factor(cpp4r::writable::strings({"b", "a", "b"}));
+    cpp4r::factor values = cpp4r::as_factor(cpp4r::writable::strings({"x", "y", "z"}));
+
+    cpp4r::list out = cpp4r::split(values, f);
+    cpp4r::strings names(out.names());
+    expect_true(names.size() == 2 && names[0] == "b" && names[1] == "a");
+    SEXP b = VECTOR_ELT(out, 0);
+    expect_true(Rf_inherits(b, "factor"));
+    expect_true(Rf_xlength(b) == 2 && INTEGER(b)[0] == 1 && INTEGER(b)[1] == 3);
+    expect_true(Rf_xlength(Rf_getAttrib(b, R_LevelsSymbol)) == 3);
+  }
+
+  test_that("split() divides data frames by row") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::data_frame df(
+        {"x"_nm = {1.5, 2.5, 3.5}, "s"_nm = cpp4r::writable::strings({"a", "b", "c"})});
+    cpp4r::writable::integers ids({1, 2, 1});
+
+    cpp4r::list out = cpp4r::split(df, ids, 2);
+    cpp4r::data_frame first(out[0]);
+    expect_true(Rf_inherits(first, "data.frame"));
+    expect_true(first.nrow() == 2 && first.ncol() == 2);
+    cpp4r::doubles x(first["x"]);
+    cpp4r::strings s(first["s"]);
+    expect_true(x[0] == 1.5 && x[1] == 3.5 && s[0] == "a" && s[1] == "c");
+    expect_true(cpp4r::data_frame(out[1]).nrow() == 1);
+  }
+
+  test_that("split_index() returns a permutation and offsets") {
+    cpp4r::writable::integers ids({2, 1, NA_INTEGER, 2, 3});
+    std::pair<cpp4r::integers, cpp4r::integers> index = cpp4r::split_index(ids, 3);
+    const cpp4r::integers& order = index.first;
+    const cpp4r::integers& starts = index.second;
+
+    expect_true(order.size() == 4);
+    expect_true(order[0] == 2 && order[1] == 1 && order[2] == 4 && order[3] == 5);
+    expect_true(starts.size() == 4);
+    expect_true(starts[0] == 0 && starts[1] == 1 && starts[2] == 3 && starts[3] == 4);
+  }
+}
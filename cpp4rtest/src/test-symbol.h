@@ -0,0 +1,50 @@
+#include <testthat.h>
+
+context("symbol-C++") {
+  test_that("symbols wrap installed names") {
+    cpp4r::symbol x("foo");
+    expect_true(x == Rf_install("foo"));
+    expect_true(x == cpp4r::symbol(std::string("foo")));
+    expect_true(x != cpp4r::symbol("bar"));
+    expect_true(x.str() == "foo");
+    expect_true(cpp4r::detail::r_typeof(x) == SYMSXP);
+  }
+
+  test_that("_sym literals resolve each literal once") {
+    using namespace cpp4r::literals;
+
+    SEXP first = R_NilValue;
+    for (int i = 0; i < 3; ++i) {
+      SEXP sym = "dim"_sym;
+      if (i == 0) {
+        first = sym;
+      }
+      expect_true(sym == first);
+    }
+    expect_true("dim"_sym == R_DimSymbol);
+    expect_true("levels"_sym == cpp4r::symbol("levels"));
+  }
+
+  test_that("name taking APIs accept symbols") {
+    using namespace cpp4r::literals;
+
+    cpp4r::writable::integers x({1, 2, 3, 4});
+    x.attr("dim"_sym) = {2, 2};
+    expect_true(Rf_getAttrib(x.data(), R_DimSymbol) != R_NilValue);
+    expect_true(cpp4r::integers(x.attr("dim"_sym))[1] == 2);
+
+    auto new_env = cpp4r::package("base")["new.env"];
+    cpp4r::environment env(new_env());
+    env["foo"_sym] = 1;
+    expect_true(env.exists("foo"_sym));
+    expect_true(cpp4r::as_cpp<int>(env["foo"]) == 1);
+    env.remove("foo"_sym);
+    expect_false(env.exists("foo"));
+
+    cpp4r::named_arg arg("na.rm"_sym, true);
+    expect_true(arg.tag() == Rf_install("na.rm"));
+    expect_true(arg == "na.rm");
+    expect_true(("x"_nm = 1).tag() == Rf_install("x"));
+    expect_true(cpp4r::named_arg("y").tag() == Rf_install("y"));
+  }
+}
@@ -0,0 +1,66 @@
+#include <testthat.h>
+
+context("warning_collector-C++") {
+  test_that("warning_collector summarizes warnings by message") {
+    cpp4r::warning_collector warnings(3);
+    auto lossy = warnings.key("Lossy conversion");
+    auto na = warnings.key("NAs introduced by coercion");
+    expect_true(warnings.key("Lossy conversion") == lossy);
+
+    for (R_xlen_t i = 0; i < 10; ++i) {
+      warnings.add(lossy, i);
+    }
+    warnings.add(na);
+    warnings.add("Out of range", 4);
+    expect_true(warnings.count(lossy) == 10);
+    expect_true(warnings.count(na) == 1);
+
+    std::vector<std::string> out = warnings.summaries();
+    expect_true(out.size() == 3);
+    expect_true(out[0] == "Lossy conversion (10 times, at 1, 2, 3, ...)");
+    expect_true(out[1] == "NAs introduced by coercion");
+    expect_true(out[2] == "Out of range (at 5)");
+
+    // Cleared collectors emit nothing when they go out of scope
+    warnings.clear();
+    expect_true(warnings.empty());
+    expect_true(warnings.summaries().empty());
+  }
+
+  test_that("warnings of collectors destroyed by exceptions are left for END_CPP4R") {
+    std::vector<std::string>& pending = cpp4r::detail::pending_warnings();
+    pending.clear();
+    try {
+      cpp4r::warning_collector warnings;
+      warnings.add("Lossy conversion", 1);
+      warnings.add("Lossy conversion", 2);
+      throw std::runtime_error("error");
+    } catch (const std::runtime_error&) {
+    }
+    expect_true(pending.size() == 1);
+    expect_true(pending[0] == "Lossy conversion (2 times, at 2, 3)");
+    pending.clear();
+  }
+
+  test_that("pending warnings are added to C++ errors and dropped for R errors") {
+    std::vector<std::string>& pending = cpp4r::detail::pending_warnings();
+    pending = {"a (2 times)", "b"};
+    char buf[64] = "failed";
+    cpp4r::detail::finish_pending_warnings(buf, sizeof(buf), R_NilValue);
+    expect_true(std::string(buf) ==
+                "failed\nIn addition: Warning messages:\na (2 times)\nb");
+    expect_true(pending.empty());
+
+    pending = {"a much longer warning that does not fit"};
+    char small[16] = "failed";
+    cpp4r::detail::finish_pending_warnings(small, sizeof(small), R_NilValue);
+    expect_true(std::string(small) == "failed\nIn addit");
+    expect_true(pending.empty());
+
+    pending = {"a"};
+    char empty[16] = "";
+    cpp4r::detail::finish_pending_warnings(empty, sizeof(empty), R_GlobalEnv);
+    expect_true(empty[0] == '\0');
+    expect_true(pending.empty());
+  }
+}
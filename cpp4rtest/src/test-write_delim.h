@@ -0,0 +1,80 @@
+#include <testthat.h>
+
+context("write_delim-C++") {
+  test_that("format_delim() writes typed columns") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::strings s({"a", "b,c", NA_STRING});
+    cpp4r::writable::logicals l({TRUE, FALSE, NA_LOGICAL});
+    cpp4r::writable::data_frame df({"x"_nm = {1.5, NA_REAL, -2.},
+                                    "n"_nm = {1, NA_INTEGER, -30}, "s"_nm = s,
+                                    "l"_nm = l});
+
+    expect_true(cpp4r::format_delim(df) ==
+                "x,n,s,l\n1.5,1,a,TRUE\nNA,NA,\"b,c\",FALSE\n-2,-30,NA,NA\n");
+  }
+
+  test_that("format_delim() quotes strings that need it") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::strings s({"say \"hi\"", "two\nlines", "NA", ""});
+    cpp4r::writable::data_frame df({"a b"_nm = s});
+    expect_true(cpp4r::format_delim(df) ==
+                "a b\n\"say \"\"hi\"\"\"\n\"two\nlines\"\n\"NA\"\n\n");
+
+    cpp4r::write_delim_options options;
+    options.delim = '\t';
+    options.header = false;
+    options.na = "";
+    cpp4r::writable::strings t({"x,y", NA_STRING, "a\tb"});
+    cpp4r::writable::data_frame tsv({"t"_nm = t});
+    expect_true(cpp4r::format_delim(tsv, options) == "x,y\n\n\"a\tb\"\n");
+  }
+
+  test_that("format_delim() writes factor levels") {
+    using namespace cpp4r::literals;
+    cpp4r::factor f = cpp4r::as_factor(cpp4r::writable::strings({"b", "a", NA_STRING}));
+    cpp4r::writable::data_frame df({"f"_nm = f});
+    expect_true(cpp4r::format_delim(df) == "f\nb\na\nNA\n");
+  }
+
+  test_that("format_delim() writes doubles that read back exactly") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::data_frame df(
+        {"x"_nm = {0.1, 1. / 3, 1e300, 123456789012345678., R_PosInf, R_NaN, 5e-324}});
+    std::string out = cpp4r::format_delim(df);
+    expect_true(out.compare(0, 63,
+                            "x\n0.1\n0.3333333333333333\n1e+300\n1.2345678901234568e+17\n"
+                            "Inf\nNaN\n") == 0);
+
+    cpp4r::data_frame back = cpp4r::parse_delim(out, {cpp4r::column_type::real});
+    cpp4r::doubles x = back.column<cpp4r::doubles>("x");
+    cpp4r::doubles y = df.column<cpp4r::doubles>("x");
+    expect_true(x[0] == y[0] && x[1] == y[1] && x[3] == y[3] && x[6] == y[6]);
+  }
+
+  test_that("format_delim() keeps blocks in order") {
+    using namespace cpp4r::literals;
+    const int n = 100000;
+    cpp4r::writable::integers id(n);
+    cpp4r::writable::strings label(n);
+    std::string expected = "id,label\n";
+    for (int i = 0; i < n; ++i) {
+      id[i] = i;
+      label[i] = "row" + std::to_string(i % 13);
+      expected += std::to_string(i) + ",row" + std::to_string(i % 13) + "\n";
+    }
+    cpp4r::writable::data_frame df({"id"_nm = id, "label"_nm = label});
+    cpp4r::write_delim_options options;
+    options.num_threads = 4;
+    expect_true(cpp4r::format_delim(df, options) == expected);
+  }
+
+  test_that("write_delim() reports unsupported columns and files") {
+    using namespace cpp4r::literals;
+    cpp4r::writable::list x({cpp4r::writable::doubles({1.})});
+    cpp4r::writable::data_frame df({"x"_nm = x});
+    expect_error(cpp4r::format_delim(df));
+
+    cpp4r::writable::data_frame ok({"x"_nm = {1.}});
+    expect_error(cpp4r::write_delim(ok, "/nonexistent/cpp4r.csv"));
+  }
+}
@@ -0,0 +1,37 @@
+// `x` truncated to integers, with a warning for each lossy value, or one warning in
+// total if `collect`
+[[cpp4r::register]] cpp4r::writable::integers truncate_doubles_(cpp4r::doubles x,
+                                                                bool collect) {
+  const R_xlen_t n = x.size();
+  cpp4r::writable::integers out(n);
+  cpp4r::warning_collector warnings;
+  auto lossy = warnings.key("Lossy conversion to integer");
+  for (R_xlen_t i = 0; i < n; ++i) {
+    out[i] = static_cast<int>(x[i]);
+    if (out[i] != x[i]) {
+      if (collect) {
+        warnings.add(lossy, i);
+      } else {
+        cpp4r::warning("Lossy conversion to integer at %d", static_cast<int>(i + 1));
+      }
+    }
+  }
+  return out;
+}
+
+// Collect a warning, then fail
+[[cpp4r::register]] void warn_then_stop_() {
+  cpp4r::warning_collector warnings;
+  warnings.add("Collected before the error");
+  throw std::runtime_error("failed");
+}
+
+// Collect a warning in a scope left by an exception that is then caught
+[[cpp4r::register]] void warn_caught_() {
+  try {
+    cpp4r::warning_collector warnings;
+    warnings.add("Collected before a caught error");
+    throw std::runtime_error("caught");
+  } catch (const std::runtime_error&) {
+  }
+}
@@ -0,0 +1,6 @@
+[[cpp4r::register]] void cpp4r_write_delim_(cpp4r::data_frame df, std::string path,
+                                            std::string delim) {
+  cpp4r::write_delim_options options;
+  options.delim = delim[0];
+  cpp4r::write_delim(df, path, options);
+}
@@ -1,24 +1,41 @@
 #pragma once
 
 #include "cpp4r/R.hpp"
+#include "cpp4r/arrow.hpp"
 #include "cpp4r/as.hpp"
 #include "cpp4r/attribute_proxy.hpp"
+#include "cpp4r/columnar.hpp"
 #include "cpp4r/complexes.hpp"
+#include "cpp4r/concat.hpp"
 #include "cpp4r/data_frame.hpp"
+#include "cpp4r/data_frame_builder.hpp"
 #include "cpp4r/doubles.hpp"
 #include "cpp4r/environment.hpp"
 #include "cpp4r/external_pointer.hpp"
+#include "cpp4r/factor.hpp"
 #include "cpp4r/function.hpp"
+#include "cpp4r/group_by.hpp"
 #include "cpp4r/integers.hpp"
+#include "cpp4r/interrupt.hpp"
+#include "cpp4r/join.hpp"
+#include "cpp4r/json.hpp"
 #include "cpp4r/list.hpp"
 #include "cpp4r/list_of.hpp"
 #include "cpp4r/logicals.hpp"
+#include "cpp4r/map_batched.hpp"
 #include "cpp4r/matrix.hpp"
 #include "cpp4r/named_arg.hpp"
+#include "cpp4r/progress.hpp"
 #include "cpp4r/protect.hpp"
 #include "cpp4r/r_bool.hpp"
 #include "cpp4r/r_string.hpp"
 #include "cpp4r/r_vector.hpp"
+#include "cpp4r/ragged.hpp"
 #include "cpp4r/raws.hpp"
+#include "cpp4r/read_delim.hpp"
+#include "cpp4r/record.hpp"
 #include "cpp4r/sexp.hpp"
+#include "cpp4r/split.hpp"
 #include "cpp4r/strings.hpp"
+#include "cpp4r/symbol.hpp"
+#include "cpp4r/write_delim.hpp"
@@ -0,0 +1,659 @@
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for int32_t, int64_t, uint8_t
+
+#include <cstring>    // for memcpy, strcmp, strlen
+#include <memory>     // for unique_ptr
+#include <stdexcept>  // for invalid_argument, length_error
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include "R_ext/Altrep.h"        // for R_altrep_class_t, R_new_altrep, R_altrep_data1
+#include "R_ext/Arith.h"         // for NA_INTEGER, NA_LOGICAL, NA_REAL
+#include "R_ext/Print.h"         // for Rprintf
+#include "R_ext/Rdynload.h"      // for DllInfo
+#include "cpp4r/R.hpp"           // for SEXP, SEXPREC, Rf_allocVector, R_MakeExternalPtr
+#include "cpp4r/data_frame.hpp"  // for data_frame, column_traits
+#include "cpp4r/doubles.hpp"     // for na<double>
+#include "cpp4r/integers.hpp"    // for na<int>
+#include "cpp4r/list.hpp"        // for list
+#include "cpp4r/protect.hpp"     // for safe, store
+#include "cpp4r/sexp.hpp"        // for sexp
+#include "cpp4r/strings.hpp"     // for strings
+
+// The Arrow C data interface, a stable C ABI declared here rather than taken from an
+// Arrow library, guarded so that other definitions of the same ABI can coexist. See
+// https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+  void (*release)(struct ArrowSchema*);
+  void* private_data;
+};
+
+struct ArrowArray {
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+  void (*release)(struct ArrowArray*);
+  void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace cpp4r {
+
+namespace detail {
+
+inline bool arrow_bit(const void* bits, int64_t i) noexcept {
+  return (static_cast<const uint8_t*>(bits)[i >> 3] >> (i & 7)) & 1;
+}
+
+inline void set_arrow_bit(std::vector<uint8_t>& bits, int64_t i) noexcept {
+  bits[i >> 3] |= static_cast<uint8_t>(1 << (i & 7));
+}
+
+// R_IsNA() is a function call, so check that a double is a NaN first
+inline bool arrow_is_null(double x) noexcept { return x != x && R_IsNA(x); }
+inline bool arrow_is_null(int x) noexcept { return x == NA_INTEGER; }
+
+/// The validity bitmap of `array`, or `nullptr` if all its values are valid
+inline const void* arrow_validity(const ArrowArray* array) noexcept {
+  return array->null_count == 0 ? nullptr : array->buffers[0];
+}
+
+/// Everything an exported `ArrowSchema` points to
+struct exported_schema {
+  std::string format;
+  std::string name;
+  std::vector<std::unique_ptr<ArrowSchema>> children;
+  std::vector<ArrowSchema*> child_ptrs;
+
+  // Consumers may move children out, which leaves them without a release callback
+  ~exported_schema() {
+    for (auto& child : children) {
+      if (child->release != nullptr) {
+        child->release(child.get());
+      }
+    }
+  }
+};
+
+/// Everything an exported `ArrowArray` points to. `token` protects the R vector when
+/// the buffers point into it rather than into the copies held here.
+struct exported_array {
+  SEXP token = R_NilValue;
+  std::vector<uint8_t> validity;
+  std::vector<uint8_t> data;
+  std::vector<int32_t> offsets;
+  std::vector<const void*> buffers;
+  std::vector<std::unique_ptr<ArrowArray>> children;
+  std::vector<ArrowArray*> child_ptrs;
+
+  ~exported_array() {
+    for (auto& child : children) {
+      if (child->release != nullptr) {
+        child->release(child.get());
+      }
+    }
+    store::release(token);
+  }
+};
+
+inline void release_exported_schema(ArrowSchema* schema) {
+  delete static_cast<exported_schema*>(schema->private_data);
+  schema->release = nullptr;
+}
+
+inline void release_exported_array(ArrowArray* array) {
+  delete static_cast<exported_array*>(array->private_data);
+  array->release = nullptr;
+}
+
+inline void finish_schema(std::unique_ptr<exported_schema> owner, ArrowSchema* schema) {
+  for (auto& child : owner->children) {
+    owner->child_ptrs.push_back(child.get());
+  }
+  schema->format = owner->format.c_str();
+  schema->name = owner->name.c_str();
+  schema->metadata = nullptr;
+  schema->flags = ARROW_FLAG_NULLABLE;
+  schema->n_children = static_cast<int64_t>(owner->children.size());
+  schema->children = owner->child_ptrs.empty() ? nullptr : owner->child_ptrs.data();
+  schema->dictionary = nullptr;
+  schema->release = release_exported_schema;
+  schema->private_data = owner.release();
+}
+
+inline void finish_array(std::unique_ptr<exported_array> owner, int64_t length,
+                         int64_t null_count, ArrowArray* array) {
+  for (auto& child : owner->children) {
+    owner->child_ptrs.push_back(child.get());
+  }
+  array->length = length;
+  array->null_count = null_count;
+  array->offset = 0;
+  array->n_buffers = static_cast<int64_t>(owner->buffers.size());
+  array->n_children = static_cast<int64_t>(owner->children.size());
+  array->buffers = owner->buffers.data();
+  array->children = owner->child_ptrs.empty() ? nullptr : owner->child_ptrs.data();
+  array->dictionary = nullptr;
+  array->release = release_exported_array;
+  array->private_data = owner.release();
+}
+
+inline void get_region(SEXP x, R_xlen_t n, double* out) { REAL_GET_REGION(x, 0, n, out); }
+inline void get_region(SEXP x, R_xlen_t n, int* out) { INTEGER_GET_REGION(x, 0, n, out); }
+
+/// Export a double or integer vector. The buffer points into `x` unless it is ALTREP,
+/// whose data may not be materialized, and a validity bitmap is only built for `NA`s.
+template <typename T>
+inline int64_t export_numeric(SEXP x, R_xlen_t n, exported_array& owner) {
+  const T* values;
+  if (__builtin_expect(!ALTREP(x), 1)) {
+    values = column_traits<T>::ptr(x);
+    owner.token = store::insert(x);
+  } else {
+    owner.data.resize(n * sizeof(T));
+    T* copy = reinterpret_cast<T*>(owner.data.data());
+    get_region(x, n, copy);
+    values = copy;
+  }
+
+  int64_t null_count = 0;
+  for (R_xlen_t i = 0; i < n; ++i) {
+    null_count += arrow_is_null(values[i]);
+  }
+  if (null_count > 0) {
+    owner.validity.assign((n + 7) / 8, 0);
+    for (R_xlen_t i = 0; i < n; ++i) {
+      if (!arrow_is_null(values[i])) {
+        set_arrow_bit(owner.validity, i);
+      }
+    }
+  }
+
+  owner.buffers = {owner.validity.empty() ? nullptr : owner.validity.data(), values};
+  return null_count;
+}
+
+/// Export a logical vector as bit packed booleans, a copy
+inline int64_t export_logical(SEXP x, R_xlen_t n, exported_array& owner) {
+  const int* values = LOGICAL_RO(x);
+  owner.validity.assign((n + 7) / 8, 0);
+  owner.data.assign((n + 7) / 8, 0);
+
+  int64_t null_count = 0;
+  for (R_xlen_t i = 0; i < n; ++i) {
+    if (values[i] == NA_LOGICAL) {
+      ++null_count;
+      continue;
+    }
+    set_arrow_bit(owner.validity, i);
+    if (values[i]) {
+      set_arrow_bit(owner.data, i);
+    }
+  }
+
+  owner.buffers = {null_count > 0 ? owner.validity.data() : nullptr, owner.data.data()};
+  return null_count;
+}
+
+/// Export a character vector as UTF-8 strings with 32 bit offsets, a copy
+inline int64_t export_string(SEXP x, R_xlen_t n, exported_array& owner) {
+  owner.validity.assign((n + 7) / 8, 0);
+  owner.offsets.resize(n + 1);
+  owner.offsets[0] = 0;
+
+  int64_t null_count = 0;
+  for (R_xlen_t i = 0; i < n; ++i) {
+    SEXP s = STRING_ELT(x, i);
+    if (s == NA_STRING) {
+      ++null_count;
+    } else {
+      const char* utf8 = safe[Rf_translateCharUTF8](s);
+      owner.data.insert(owner.data.end(), utf8, utf8 + std::strlen(utf8));
+      if (__builtin_expect(owner.data.size() > INT32_MAX, 0)) {
+        throw std::length_error("Strings are too long for an Arrow utf8 array");
+      }
+      set_arrow_bit(owner.validity, i);
+    }
+    owner.offsets[i + 1] = static_cast<int32_t>(owner.data.size());
+  }
+
+  owner.buffers = {null_count > 0 ? owner.validity.data() : nullptr,
+                   owner.offsets.data(), owner.data.data()};
+  return null_count;
+}
+
+inline const char* checked_arrow_format(SEXP x) {
+  switch (r_typeof(x)) {
+    case REALSXP:
+      return "g";
+    case INTSXP:
+      if (Rf_inherits(x, "factor")) {
+        throw std::invalid_argument(
+            "Can't export a factor to Arrow, convert it to character first");
+      }
+      return "i";
+    case LGLSXP:
+      return "b";
+    case STRSXP:
+      return "u";
+    default:
+      throw std::invalid_argument(std::string("Can't export a vector of type '") +
+                                  Rf_type2char(r_typeof(x)) + "' to Arrow");
+  }
+}
+
+/// Fill `schema` and `array` with `x`. Nothing is written to them if this throws.
+inline void export_vector(SEXP x, const std::string& name, ArrowSchema* schema,
+                          ArrowArray* array) {
+  std::unique_ptr<exported_schema> schema_owner(new exported_schema);
+  schema_owner->format = checked_arrow_format(x);
+  schema_owner->name = name;
+
+  std::unique_ptr<exported_array> array_owner(new exported_array);
+  const R_xlen_t n = Rf_xlength(x);
+  int64_t null_count = 0;
+  switch (r_typeof(x)) {
+    case REALSXP:
+      null_count = export_numeric<double>(x, n, *array_owner);
+      break;
+    case INTSXP:
+      null_count = export_numeric<int>(x, n, *array_owner);
+      break;
+    case LGLSXP:
+      null_count = export_logical(x, n, *array_owner);
+      break;
+    default:
+      null_count = export_string(x, n, *array_owner);
+      break;
+  }
+
+  finish_schema(std::move(schema_owner), schema);
+  finish_array(std::move(array_owner), n, null_count, array);
+}
+
+/// Releases an imported `ArrowArray`, the address of the external pointer `xp`, once
+/// no R vector borrows its buffers any more.
+inline void release_imported_array(SEXP xp) {
+  ArrowArray* array = static_cast<ArrowArray*>(R_ExternalPtrAddr(xp));
+  if (array == nullptr) {
+    return;
+  }
+  R_ClearExternalPtr(xp);
+  if (array->release != nullptr) {
+    array->release(array);
+  }
+  delete array;
+}
+
+/// Move `array` into an external pointer that releases it when garbage collected
+inline sexp adopt_arrow_array(ArrowArray* array) {
+  sexp owner = safe[R_MakeExternalPtr](nullptr, R_NilValue, R_NilValue);
+  safe[R_RegisterCFinalizerEx](owner, release_imported_array, TRUE);
+  R_SetExternalPtrAddr(owner, new ArrowArray(*array));
+  array->release = nullptr;
+  return owner;
+}
+
+/// ALTREP class of double and integer vectors viewing the data buffer of an imported
+/// `ArrowArray`. `data1` is an external pointer to the array, protecting the owner of
+/// the whole imported array, and `data2` the materialized vector once R asks for a
+/// writable pointer or the validity bitmap has to be applied to all values.
+template <typename T>
+struct arrow_vector {
+  static R_altrep_class_t& altrep_class() noexcept {
+    static R_altrep_class_t klass;
+    return klass;
+  }
+
+  static bool registered() noexcept { return altrep_class().ptr != nullptr; }
+
+  static void init(DllInfo* dll, const char* package);
+
+  /// SAFETY: Keep as a pure C function. Call like an R API function, i.e. wrap in
+  /// `safe[]` as required.
+  static SEXP make(const ArrowArray* array, SEXP owner) {
+    SEXP data1 =
+        PROTECT(R_MakeExternalPtr(const_cast<ArrowArray*>(array), R_NilValue, owner));
+    SEXP out = R_new_altrep(altrep_class(), data1, R_NilValue);
+    UNPROTECT(1);
+    return out;
+  }
+
+  /// Copy `n` values of `array` from `start`, with `NA` for the invalid ones
+  static void copy(const ArrowArray* array, R_xlen_t start, R_xlen_t n, T* out) {
+    if (n <= 0) {
+      return;
+    }
+    const T* values = static_cast<const T*>(array->buffers[1]) + array->offset + start;
+    const void* bits = arrow_validity(array);
+    if (bits == nullptr) {
+      std::memcpy(out, values, n * sizeof(T));
+      return;
+    }
+    const int64_t first = array->offset + start;
+    for (R_xlen_t i = 0; i < n; ++i) {
+      out[i] = arrow_bit(bits, first + i) ? values[i] : na<T>();
+    }
+  }
+
+  static const ArrowArray* array(SEXP x) {
+    return static_cast<const ArrowArray*>(R_ExternalPtrAddr(R_altrep_data1(x)));
+  }
+
+  static R_xlen_t length(SEXP x) { return static_cast<R_xlen_t>(array(x)->length); }
+
+  static Rboolean inspect(SEXP x, int, int, int, void (*)(SEXP, int, int, int)) {
+    Rprintf("cpp4r::arrow (len=%lld, materialized=%s)\n",
+            static_cast<long long>(length(x)),
+            R_altrep_data2(x) != R_NilValue ? "T" : "F");
+    return TRUE;
+  }
+
+  static SEXP materialize(SEXP x) {
+    SEXP out = R_altrep_data2(x);
+    if (out == R_NilValue) {
+      const R_xlen_t n = length(x);
+      out = PROTECT(Rf_allocVector(column_traits<T>::sexptype(), n));
+      copy(array(x), 0, n, column_traits<T>::mutable_ptr(out));
+      R_set_altrep_data2(x, out);
+      UNPROTECT(1);
+    }
+    return out;
+  }
+
+  // Read only access borrows the foreign buffer as long as there are no nulls to apply
+  static void* dataptr(SEXP x, Rboolean writeable) {
+    if (!writeable && R_altrep_data2(x) == R_NilValue) {
+      const ArrowArray* a = array(x);
+      if (arrow_validity(a) == nullptr) {
+        return const_cast<T*>(static_cast<const T*>(a->buffers[1]) + a->offset);
+      }
+    }
+    return column_traits<T>::mutable_ptr(materialize(x));
+  }
+
+  static const void* dataptr_or_null(SEXP x) {
+    SEXP out = R_altrep_data2(x);
+    if (out != R_NilValue) {
+      return column_traits<T>::ptr(out);
+    }
+    const ArrowArray* a = array(x);
+    if (arrow_validity(a) != nullptr) {
+      return nullptr;
+    }
+    return static_cast<const T*>(a->buffers[1]) + a->offset;
+  }
+
+  static T elt(SEXP x, R_xlen_t i) {
+    SEXP out = R_altrep_data2(x);
+    if (out != R_NilValue) {
+      return column_traits<T>::ptr(out)[i];
+    }
+    T value;
+    copy(array(x), i, 1, &value);
+    return value;
+  }
+
+  static R_xlen_t get_region(SEXP x, R_xlen_t start, R_xlen_t size, T* out) {
+    const R_xlen_t n = start + size > length(x) ? length(x) - start : size;
+    SEXP data2 = R_altrep_data2(x);
+    if (data2 != R_NilValue) {
+      if (n > 0) {
+        std::memcpy(out, column_traits<T>::ptr(data2) + start, n * sizeof(T));
+      }
+    } else {
+      copy(array(x), start, n, out);
+    }
+    return n;
+  }
+
+  static void init_common(R_altrep_class_t klass) {
+    R_set_altrep_Length_method(klass, length);
+    R_set_altrep_Inspect_method(klass, inspect);
+    R_set_altvec_Dataptr_method(klass, dataptr);
+    R_set_altvec_Dataptr_or_null_method(klass, dataptr_or_null);
+  }
+};
+
+template <>
+inline void arrow_vector<double>::init(DllInfo* dll, const char* package) {
+  R_altrep_class_t klass = R_make_altreal_class("cpp4r_arrow_float64", package, dll);
+  init_common(klass);
+  R_set_altreal_Elt_method(klass, elt);
+  R_set_altreal_Get_region_method(klass, get_region);
+  altrep_class() = klass;
+}
+
+template <>
+inline void arrow_vector<int>::init(DllInfo* dll, const char* package) {
+  R_altrep_class_t klass = R_make_altinteger_class("cpp4r_arrow_int32", package, dll);
+  init_common(klass);
+  R_set_altinteger_Elt_method(klass, elt);
+  R_set_altinteger_Get_region_method(klass, get_region);
+  altrep_class() = klass;
+}
+
+inline void check_arrow_vector(const ArrowSchema* schema, const ArrowArray* array) {
+  if (array->release == nullptr) {
+    throw std::invalid_argument("The Arrow array has already been released");
+  }
+  const std::string format(schema->format);
+  int64_t n_buffers;
+  if (format == "g" || format == "i" || format == "b") {
+    n_buffers = 2;
+  } else if (format == "u" || format == "U") {
+    n_buffers = 3;
+  } else {
+    throw std::invalid_argument("Can't import Arrow format '" + format + "'");
+  }
+  if (array->n_buffers != n_buffers) {
+    throw std::invalid_argument("Arrow format '" + format + "' expects " +
+                                std::to_string(n_buffers) + " buffers");
+  }
+}
+
+template <typename T>
+inline sexp import_numeric(const ArrowArray* array, SEXP owner, bool& borrowed) {
+  if (arrow_vector<T>::registered()) {
+    borrowed = true;
+    return safe[arrow_vector<T>::make](array, owner);
+  }
+  sexp out = safe[Rf_allocVector](column_traits<T>::sexptype(), array->length);
+  arrow_vector<T>::copy(array, 0, array->length, column_traits<T>::mutable_ptr(out));
+  return out;
+}
+
+inline sexp import_logical(const ArrowArray* array) {
+  const R_xlen_t n = array->length;
+  sexp out = safe[Rf_allocVector](LGLSXP, n);
+  int* p = LOGICAL(out);
+  const void* bits = arrow_validity(array);
+  for (R_xlen_t i = 0; i < n; ++i) {
+    const int64_t j = array->offset + i;
+    if (bits != nullptr && !arrow_bit(bits, j)) {
+      p[i] = NA_LOGICAL;
+    } else {
+      p[i] = arrow_bit(array->buffers[1], j);
+    }
+  }
+  return out;
+}
+
+template <typename Offset>
+inline sexp import_string(const ArrowArray* array) {
+  const R_xlen_t n = array->length;
+  sexp out = safe[Rf_allocVector](STRSXP, n);
+  const Offset* offsets = static_cast<const Offset*>(array->buffers[1]) + array->offset;
+  const char* chars = static_cast<const char*>(array->buffers[2]);
+  const void* bits = arrow_validity(array);
+  for (R_xlen_t i = 0; i < n; ++i) {
+    if (bits != nullptr && !arrow_bit(bits, array->offset + i)) {
+      SET_STRING_ELT(out, i, NA_STRING);
+    } else {
+      SET_STRING_ELT(out, i,
+                     safe[Rf_mkCharLenCE](chars + offsets[i],
+                                          static_cast<int>(offsets[i + 1] - offsets[i]),
+                                          CE_UTF8));
+    }
+  }
+  return out;
+}
+
+/// An R vector for `array`, which must have passed `check_arrow_vector()`. `borrowed`
+/// is set if the vector views the buffers of `array`, which `owner` keeps alive.
+inline sexp import_vector(const ArrowSchema* schema, const ArrowArray* array, SEXP owner,
+                          bool& borrowed) {
+  const char* format = schema->format;
+  if (std::strcmp(format, "g") == 0) {
+    return import_numeric<double>(array, owner, borrowed);
+  }
+  if (std::strcmp(format, "i") == 0) {
+    return import_numeric<int>(array, owner, borrowed);
+  }
+  if (std::strcmp(format, "b") == 0) {
+    return import_logical(array);
+  }
+  if (std::strcmp(format, "u") == 0) {
+    return import_string<int32_t>(array);
+  }
+  return import_string<int64_t>(array);
+}
+
+}  // namespace detail
+
+/// Exchange of vectors and data frames with other libraries in the same process through
+/// the Arrow C data interface.
+///
+/// Double and integer vectors are exported without copying unless they are ALTREP,
+/// and `NA`s become nulls. Logical and character vectors are copied into Arrow
+/// booleans and UTF-8 strings. Exported structs must be released, by calling their
+/// `release` callback, on the R main thread as it unprotects the R vectors.
+///
+/// Imports take ownership of the `ArrowArray`. Float64 and int32 arrays become ALTREP
+/// vectors viewing the foreign buffers once the classes are registered with
+/// `arrow::init()`; nulls are turned into `NA` as elements are read, and the vector is
+/// copied only when R needs a writable pointer or a pointer to all values with the nulls
+/// applied. Note that a valid int32 equal to `INT_MIN` reads as `NA` in R. Other formats,
+/// and all formats before `arrow::init()`, are copied and released right away.
+namespace arrow {
+
+/// Register the ALTREP classes of zero copy imports, from the `[[cpp4r::init]]`
+/// function of `package`
+inline void init(DllInfo* dll, const char* package) {
+  detail::arrow_vector<double>::init(dll, package);
+  detail::arrow_vector<int>::init(dll, package);
+}
+
+/// Export the double, integer, logical or character vector `x` into the structs
+/// allocated by the consumer
+inline void export_array(SEXP x, ArrowSchema* schema, ArrowArray* array) {
+  detail::export_vector(x, "", schema, array);
+}
+
+/// Export `x` as an Arrow struct array with one child per column
+inline void export_data_frame(const data_frame& x, ArrowSchema* schema,
+                              ArrowArray* array) {
+  const R_xlen_t ncol = x.ncol();
+  const R_xlen_t nrow = x.nrow();
+  SEXP names = Rf_getAttrib(x, R_NamesSymbol);
+
+  std::unique_ptr<detail::exported_schema> schema_owner(new detail::exported_schema);
+  schema_owner->format = "+s";
+  std::unique_ptr<detail::exported_array> array_owner(new detail::exported_array);
+  array_owner->buffers = {nullptr};
+
+  for (R_xlen_t i = 0; i < ncol; ++i) {
+    SEXP column = VECTOR_ELT(x, i);
+    if (Rf_xlength(column) != nrow) {
+      throw std::invalid_argument("Data frame columns must have one value per row");
+    }
+    const char* name =
+        names == R_NilValue ? "" : safe[Rf_translateCharUTF8](STRING_ELT(names, i));
+    schema_owner->children.emplace_back(new ArrowSchema());
+    array_owner->children.emplace_back(new ArrowArray());
+    detail::export_vector(column, name, schema_owner->children.back().get(),
+                          array_owner->children.back().get());
+  }
+
+  detail::finish_schema(std::move(schema_owner), schema);
+  detail::finish_array(std::move(array_owner), nrow, 0, array);
+}
+
+/// Import the vector in `array`, described by `schema`. `array` is moved from, so the
+/// caller no longer releases it, unless this throws; `schema` is only read.
+inline sexp import_array(const ArrowSchema* schema, ArrowArray* array) {
+  detail::check_arrow_vector(schema, array);
+
+  sexp owner = detail::adopt_arrow_array(array);
+  bool borrowed = false;
+  sexp out = detail::import_vector(
+      schema, static_cast<const ArrowArray*>(R_ExternalPtrAddr(owner)), owner, borrowed);
+  if (!borrowed) {
+    detail::release_imported_array(owner);
+  }
+  return out;
+}
+
+/// Import the Arrow struct array `array` as a data frame, see `import_array()`
+inline writable::data_frame import_data_frame(const ArrowSchema* schema,
+                                              ArrowArray* array) {
+  if (std::strcmp(schema->format, "+s") != 0) {
+    throw std::invalid_argument(std::string("Expected an Arrow struct array, not '") +
+                                schema->format + "'");
+  }
+  if (schema->n_children != array->n_children || array->offset != 0) {
+    throw std::invalid_argument("Malformed or sliced Arrow struct array");
+  }
+  const R_xlen_t ncol = static_cast<R_xlen_t>(schema->n_children);
+  for (R_xlen_t i = 0; i < ncol; ++i) {
+    detail::check_arrow_vector(schema->children[i], array->children[i]);
+    if (array->children[i]->length != array->length) {
+      throw std::invalid_argument("Arrow struct children must have one value per row");
+    }
+  }
+
+  sexp owner = detail::adopt_arrow_array(array);
+  const ArrowArray* adopted = static_cast<const ArrowArray*>(R_ExternalPtrAddr(owner));
+  bool borrowed = false;
+  writable::list columns(ncol);
+  writable::strings names(ncol);
+  for (R_xlen_t i = 0; i < ncol; ++i) {
+    columns[i] =
+        detail::import_vector(schema->children[i], adopted->children[i], owner, borrowed);
+    const char* name = schema->children[i]->name;
+    SET_STRING_ELT(names, i, safe[Rf_mkCharCE](name == nullptr ? "" : name, CE_UTF8));
+  }
+  columns.names() = names;
+
+  const R_xlen_t nrow = static_cast<R_xlen_t>(adopted->length);
+  if (!borrowed) {
+    detail::release_imported_array(owner);
+  }
+  return writable::data_frame(columns, false, nrow);
+}
+
+}  // namespace arrow
+
+}  // namespace cpp4r
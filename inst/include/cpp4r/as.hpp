@@ -1,7 +1,11 @@
 #pragma once
 
-#include <cmath>  // for modf
+#include <algorithm>  // for sort
+#include <cmath>      // for modf, isinf
 #include <complex>
+#include <cstdio>   // for snprintf
+#include <cstdlib>  // for strtod
+#include <cstring>  // for strcmp
 #include <initializer_list>  // for initializer_list
 #include <map>               // for std::map
 #include <memory>            // for std::shared_ptr, std::weak_ptr, std::unique_ptr
@@ -12,7 +16,7 @@
 #include <vector>         // for std::vector
 
 #include "cpp4r/R.hpp"        // for SEXP, SEXPREC, Rf_xlength, R_xlen_t
-#include "cpp4r/protect.hpp"  // for stop, protect, safe, protect::function
+#include "cpp4r/protect.hpp"  // for stop, protect, safe, protect::function, store
 
 namespace cpp4r {
 
@@ -75,6 +79,20 @@ using enable_if_std_string = enable_if_t<std::is_same<T, std::string>::value, R>
 template <typename T, typename R = void>
 using enable_if_c_string = enable_if_t<std::is_same<T, const char*>::value, R>;
 
+/// Specialized by `CPP4R_RECORD()` for structs that map to the rows of a data frame
+template <typename T>
+struct record_traits : std::false_type {};
+
+template <typename T, typename R = void>
+using enable_if_record = enable_if_t<record_traits<T>::value, R>;
+
+/// Nested `std::vector`s of numbers convert through the overloads in ragged.hpp
+template <typename T>
+struct is_std_vector : std::false_type {};
+
+template <typename T, typename A>
+struct is_std_vector<std::vector<T, A>> : std::true_type {};
+
 // Detect std::complex types to avoid treating them as containers in generic
 // container overloads.
 template <typename>
@@ -346,73 +364,234 @@ enable_if_convertible_to_sexp<T, SEXP> as_sexp(const T& from) {
   return from;
 }
 
-// Pacha: Specialization for std::map
-// NOTE: I did not use templates to avoid clashes with doubles/function/etc.
-inline SEXP as_sexp(const std::map<std::string, SEXP>& map) {
-  R_xlen_t size = map.size();
-  SEXP result = PROTECT(Rf_allocVector(VECSXP, size));
-  SEXP names = PROTECT(Rf_allocVector(STRSXP, size));
+/// How `as_sexp()` converts `std::map` and `std::unordered_map`
+struct map_options {
+  /// A data frame with a `key` and a `value` column instead of a vector named by the
+  /// keys
+  bool data_frame = false;
+  /// Order the entries of unordered maps by key, so the output does not depend on the
+  /// hash table layout. Ordered maps are always in key order.
+  bool sort = false;
+};
 
-  auto it = map.begin();
-  for (R_xlen_t i = 0; i < size; ++i, ++it) {
-    SET_VECTOR_ELT(result, i, it->second);
-    SET_STRING_ELT(names, i, Rf_mkCharCE(it->first.c_str(), CE_UTF8));
+template <typename T>
+struct is_map : std::false_type {};
+
+template <typename K, typename V, typename C, typename A>
+struct is_map<std::map<K, V, C, A>> : std::true_type {};
+
+template <typename K, typename V, typename H, typename E, typename A>
+struct is_map<std::unordered_map<K, V, H, E, A>> : std::true_type {};
+
+namespace detail {
+
+template <typename T>
+struct is_map_string
+    : std::integral_constant<bool, std::is_same<T, std::string>::value ||
+                                       std::is_same<T, const char*>::value> {};
+
+template <typename T>
+struct is_map_key : std::integral_constant<bool, is_map_string<T>::value ||
+                                                     std::is_arithmetic<T>::value> {};
+
+template <typename T>
+struct is_map_value
+    : std::integral_constant<bool, is_map_key<T>::value || std::is_same<T, SEXP>::value> {
+};
+
+inline const char* map_c_str(const std::string& x) { return x.c_str(); }
+inline const char* map_c_str(const char* x) { return x; }
+
+/// A vector kept in the preserve list for the lifetime of the holder, as `sexp` is but
+/// without its header, which depends on this one
+class preserved_sexp {
+ public:
+  explicit preserved_sexp(SEXP x) : data_(x), token_(store::insert(x)) {}
+  ~preserved_sexp() { store::release(token_); }
+  preserved_sexp(const preserved_sexp&) = delete;
+  preserved_sexp& operator=(const preserved_sexp&) = delete;
+
+  operator SEXP() const noexcept { return data_; }
+
+ private:
+  SEXP data_;
+  SEXP token_;
+};
+
+/// One column of a converted map, allocated once and filled by position. Values are
+/// stored like `as_sexp()` stores scalars: floating point as double, `bool` as logical,
+/// other integral types as integer, strings as character and `SEXP`s in a list.
+template <typename T, typename = void>
+class map_column;
+
+template <typename T>
+class map_column<T, enable_if_t<std::is_arithmetic<T>::value>> {
+  using storage = typename std::conditional<std::is_floating_point<T>::value, double,
+                                            int>::type;
+
+ public:
+  explicit map_column(R_xlen_t n)
+      : data_(safe[Rf_allocVector](type(), n)),
+        p_(ptr(data_, static_cast<storage*>(nullptr))) {}
+
+  void set(R_xlen_t i, T value) { p_[i] = static_cast<storage>(value); }
+  SEXP data() const { return data_; }
+
+ private:
+  static double* ptr(SEXP x, double*) { return REAL(x); }
+  static int* ptr(SEXP x, int*) { return TYPEOF(x) == LGLSXP ? LOGICAL(x) : INTEGER(x); }
+
+  static SEXPTYPE type() {
+    return std::is_floating_point<T>::value ? REALSXP
+           : std::is_same<T, bool>::value   ? LGLSXP
+                                            : INTSXP;
   }
 
-  Rf_setAttrib(result, R_NamesSymbol, names);
-  UNPROTECT(2);
-  return result;
-}
+  preserved_sexp data_;
+  storage* p_;
+};
 
-// Specialization for std::map<double, int>
-inline SEXP as_sexp(const std::map<double, int>& map) {
-  R_xlen_t size = map.size();
-  SEXP result = PROTECT(Rf_allocVector(VECSXP, size));
-  SEXP names = PROTECT(Rf_allocVector(REALSXP, size));
+template <typename T>
+class map_column<T, enable_if_t<is_map_string<T>::value>> {
+ public:
+  explicit map_column(R_xlen_t n) : data_(safe[Rf_allocVector](STRSXP, n)) {}
 
-  auto it = map.begin();
-  for (R_xlen_t i = 0; i < size; ++i, ++it) {
-    SET_VECTOR_ELT(result, i, Rf_ScalarInteger(it->second));
-    REAL(names)[i] = it->first;
+  void set(R_xlen_t i, const T& value) {
+    SET_STRING_ELT(data_, i, Rf_mkCharCE(map_c_str(value), CE_UTF8));
   }
+  SEXP data() const { return data_; }
 
-  Rf_setAttrib(result, R_NamesSymbol, names);
-  UNPROTECT(2);
-  return result;
-}
+ private:
+  preserved_sexp data_;
+};
+
+template <typename T>
+class map_column<T, enable_if_t<std::is_same<T, SEXP>::value>> {
+ public:
+  explicit map_column(R_xlen_t n) : data_(safe[Rf_allocVector](VECSXP, n)) {}
 
-// Pacha: Specialization for std::unordered_map
-inline SEXP as_sexp(const std::unordered_map<std::string, SEXP>& map) {
-  R_xlen_t size = map.size();
-  SEXP result = PROTECT(Rf_allocVector(VECSXP, size));
-  SEXP names = PROTECT(Rf_allocVector(STRSXP, size));
+  void set(R_xlen_t i, SEXP value) { SET_VECTOR_ELT(data_, i, value); }
+  SEXP data() const { return data_; }
 
-  auto it = map.begin();
-  for (R_xlen_t i = 0; i < size; ++i, ++it) {
-    SET_VECTOR_ELT(result, i, it->second);
-    SET_STRING_ELT(names, i, Rf_mkCharCE(it->first.c_str(), CE_UTF8));
+ private:
+  preserved_sexp data_;
+};
+
+/// The name of a key, numbers formatted like `as.character()` with up to 15 significant
+/// digits, or 17 where that's needed to read the same number back
+inline SEXP map_name(const std::string& key) { return Rf_mkCharCE(key.c_str(), CE_UTF8); }
+inline SEXP map_name(const char* key) { return Rf_mkCharCE(key, CE_UTF8); }
+
+inline SEXP map_name(double key) {
+  if (ISNAN(key)) {
+    return Rf_mkChar(R_IsNA(key) ? "NA" : "NaN");
+  }
+  if (std::isinf(key)) {
+    return Rf_mkChar(key > 0 ? "Inf" : "-Inf");
+  }
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.15g", key);
+  if (std::strtod(buf, nullptr) != key) {
+    std::snprintf(buf, sizeof(buf), "%.17g", key);
   }
+  return Rf_mkChar(buf);
+}
 
-  Rf_setAttrib(result, R_NamesSymbol, names);
-  UNPROTECT(2);
-  return result;
+template <typename T>
+enable_if_t<std::is_integral<T>::value, SEXP> map_name(T key) {
+  if (std::is_same<T, bool>::value) {
+    return Rf_mkChar(key ? "TRUE" : "FALSE");
+  }
+  return Rf_mkChar(std::to_string(key).c_str());
+}
+
+template <typename T>
+bool map_key_less(const T& x, const T& y) {
+  return x < y;
 }
 
-// Specialization for std::unordered_map<double, int>
-inline SEXP as_sexp(const std::unordered_map<double, int>& map) {
-  R_xlen_t size = map.size();
-  SEXP result = PROTECT(Rf_allocVector(VECSXP, size));
-  SEXP names = PROTECT(Rf_allocVector(REALSXP, size));
+inline bool map_key_less(const char* x, const char* y) { return std::strcmp(x, y) < 0; }
 
-  auto it = map.begin();
-  for (R_xlen_t i = 0; i < size; ++i, ++it) {
-    SET_VECTOR_ELT(result, i, Rf_ScalarInteger(it->second));
-    REAL(names)[i] = it->first;
+template <typename Map>
+SEXP map_as_sexp(const Map& from, const map_options& options, bool sort) {
+  using entry = typename Map::value_type;
+  using key_type = decay_t<typename Map::key_type>;
+  using mapped_type = decay_t<typename Map::mapped_type>;
+
+  std::vector<const entry*> entries;
+  entries.reserve(from.size());
+  for (const entry& e : from) {
+    entries.push_back(&e);
+  }
+  if (sort) {
+    std::sort(entries.begin(), entries.end(), [](const entry* x, const entry* y) {
+      return map_key_less(x->first, y->first);
+    });
   }
 
-  Rf_setAttrib(result, R_NamesSymbol, names);
-  UNPROTECT(2);
-  return result;
+  const R_xlen_t n = entries.size();
+  map_column<mapped_type> values(n);
+  if (options.data_frame) {
+    map_column<key_type> keys(n);
+    preserved_sexp out(safe[Rf_allocVector](VECSXP, 2));
+    unwind_protect([&] {
+      for (R_xlen_t i = 0; i < n; ++i) {
+        keys.set(i, entries[i]->first);
+        values.set(i, entries[i]->second);
+      }
+      SET_VECTOR_ELT(out, 0, keys.data());
+      SET_VECTOR_ELT(out, 1, values.data());
+
+      SEXP names = PROTECT(Rf_allocVector(STRSXP, 2));
+      SET_STRING_ELT(names, 0, Rf_mkChar("key"));
+      SET_STRING_ELT(names, 1, Rf_mkChar("value"));
+      Rf_setAttrib(out, R_NamesSymbol, names);
+      SEXP row_names = PROTECT(Rf_allocVector(INTSXP, 2));
+      INTEGER(row_names)[0] = NA_INTEGER;
+      INTEGER(row_names)[1] = -static_cast<int>(n);
+      Rf_setAttrib(out, R_RowNamesSymbol, row_names);
+      Rf_setAttrib(out, R_ClassSymbol, Rf_mkString("data.frame"));
+      UNPROTECT(2);
+    });
+    return out;
+  }
+
+  preserved_sexp names(safe[Rf_allocVector](STRSXP, n));
+  unwind_protect([&] {
+    for (R_xlen_t i = 0; i < n; ++i) {
+      SET_STRING_ELT(names, i, map_name(entries[i]->first));
+      values.set(i, entries[i]->second);
+    }
+    Rf_setAttrib(values.data(), R_NamesSymbol, names);
+  });
+  return values.data();
+}
+
+template <typename Map, typename R = void>
+using enable_if_convertible_map =
+    enable_if_t<is_map<Map>::value &&
+                    is_map_key<decay_t<typename Map::key_type>>::value &&
+                    is_map_value<decay_t<typename Map::mapped_type>>::value,
+                R>;
+
+}  // namespace detail
+
+/// Convert a `std::map` with string or arithmetic keys and arithmetic, string or `SEXP`
+/// values to a vector named by the keys, see `map_options`. The output is allocated
+/// once: numbers and strings become typed atomic vectors and `SEXP`s a list.
+template <typename K, typename V, typename C, typename A>
+detail::enable_if_convertible_map<std::map<K, V, C, A>, SEXP> as_sexp(
+    const std::map<K, V, C, A>& from, const map_options& options = map_options()) {
+  return detail::map_as_sexp(from, options, false);
+}
+
+/// Convert a `std::unordered_map`, like `std::map`. The entries are in the iteration
+/// order of the map, or in key order with `map_options::sort`.
+template <typename K, typename V, typename H, typename E, typename A>
+detail::enable_if_convertible_map<std::unordered_map<K, V, H, E, A>, SEXP> as_sexp(
+    const std::unordered_map<K, V, H, E, A>& from,
+    const map_options& options = map_options()) {
+  return detail::map_as_sexp(from, options, options.sort);
 }
 
 }  // namespace cpp4r
@@ -7,6 +7,7 @@
 #include "cpp4r/R.hpp"        // for SEXP, SEXPREC, Rf_install, PROTECT, Rf_...
 #include "cpp4r/as.hpp"       // for as_sexp
 #include "cpp4r/protect.hpp"  // for protect, safe, protect::function
+#include "cpp4r/symbol.hpp"   // for symbol
 
 namespace cpp4r {
 
@@ -25,6 +26,9 @@ class attribute_proxy {
   inline attribute_proxy(const T& parent, const std::string& index)
       : parent_(parent), symbol_(safe[Rf_install](index.c_str())) {}
 
+  inline attribute_proxy(const T& parent, const symbol& index) noexcept
+      : parent_(parent), symbol_(index) {}
+
   inline attribute_proxy(const T& parent, SEXP index) noexcept
       : parent_(parent), symbol_(index) {}
 
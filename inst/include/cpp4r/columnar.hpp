@@ -0,0 +1,535 @@
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for int32_t, int64_t, uint32_t
+
+#include <cstring>    // for memcpy, memcmp, strlen
+#include <memory>     // for shared_ptr
+#include <stdexcept>  // for invalid_argument, out_of_range, runtime_error
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include "R_ext/Arith.h"          // for NA_INTEGER, NA_LOGICAL, NA_REAL, ISNAN
+#include "cpp4r/R.hpp"            // for SEXP, SEXPREC, Rf_allocVector, REAL_RO
+#include "cpp4r/arrow.hpp"        // for ArrowArray, arrow_vector, import_array
+#include "cpp4r/data_frame.hpp"   // for data_frame, column_traits
+#include "cpp4r/list.hpp"         // for list
+#include "cpp4r/protect.hpp"      // for safe
+#include "cpp4r/read_delim.hpp"   // for mapped_file, charsxp_cache, hash_bytes
+#include "cpp4r/sexp.hpp"         // for sexp
+#include "cpp4r/strings.hpp"      // for strings
+#include "cpp4r/write_delim.hpp"  // for output_file, utf8_chars
+
+namespace cpp4r {
+
+/// Summary of one block of rows of a column in a columnar file. `min` and `max` are
+/// `NA_REAL` for string columns and for blocks without any non missing value.
+struct columnar_stats {
+  double min;
+  double max;
+  int64_t na_count;
+};
+
+struct columnar_options {
+  /// Rows per block of the per block statistics
+  R_xlen_t block_rows = 65536;
+};
+
+namespace detail {
+
+// The layout of a columnar file, with all numbers in native byte order:
+//
+// * A `columnar_header`.
+// * The data of each column, starting at 64 byte aligned offsets. Doubles, integers,
+//   logicals and factor codes are stored as the values of the R vector. Strings are
+//   stored as `nrow + 1` int64 offsets followed by the UTF-8 bytes, where bit 62 of
+//   the end offset marks `NA`. The levels of factors follow their codes as strings.
+// * The directory: per column a `columnar_entry`, its name padded to 8 bytes and one
+//   `columnar_stats` per block.
+// * A `columnar_footer` with the offset of the directory.
+
+enum class columnar_type : int32_t { real = 1, integer, logical, string, factor };
+
+struct columnar_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  int64_t nrow;
+  int64_t ncol;
+  int64_t block_rows;
+};
+
+struct columnar_entry {
+  int32_t type;
+  int32_t name_size;
+  int64_t data_offset;
+  int64_t data_size;
+  /// Number of factor levels, stored at `data_offset + nrow * 4`
+  int64_t levels;
+};
+
+struct columnar_footer {
+  int64_t directory_offset;
+  char magic[8];
+};
+
+inline const char* columnar_magic() noexcept { return "CPP4RCOL"; }
+
+inline uint32_t columnar_byte_order() noexcept { return 0x01020304; }
+
+inline int64_t string_na_bit() noexcept { return static_cast<int64_t>(1) << 62; }
+
+/// Streams the columns of a data frame to a file through a fixed size buffer
+class columnar_writer {
+ public:
+  columnar_writer(const std::string& path, const columnar_options& options)
+      : file_(path), block_rows_(options.block_rows) {
+    if (block_rows_ <= 0) {
+      throw std::invalid_argument("`block_rows` must be positive");
+    }
+  }
+
+  void write(const data_frame& x) {
+    const R_xlen_t ncol = x.ncol();
+    nrow_ = x.nrow();
+    SEXP names = Rf_getAttrib(x, R_NamesSymbol);
+
+    columnar_header header = columnar_header();
+    std::memcpy(header.magic, columnar_magic(), sizeof(header.magic));
+    header.version = 1;
+    header.byte_order = columnar_byte_order();
+    header.nrow = nrow_;
+    header.ncol = ncol;
+    header.block_rows = block_rows_;
+    append(&header, sizeof(header));
+
+    std::vector<columnar_entry> entries(ncol);
+    std::vector<std::vector<columnar_stats>> stats(ncol);
+    for (R_xlen_t j = 0; j < ncol; ++j) {
+      SEXP column = VECTOR_ELT(x, j);
+      if (Rf_xlength(column) != nrow_) {
+        throw std::invalid_argument("Data frame columns must have one value per row");
+      }
+      align();
+      entries[j].data_offset = position_;
+      write_column(column, entries[j], stats[j]);
+      entries[j].data_size = position_ - entries[j].data_offset;
+    }
+
+    align();
+    columnar_footer footer = columnar_footer();
+    footer.directory_offset = position_;
+    std::memcpy(footer.magic, columnar_magic(), sizeof(footer.magic));
+    for (R_xlen_t j = 0; j < ncol; ++j) {
+      const char* name = utf8_chars(STRING_ELT(names, j));
+      entries[j].name_size = static_cast<int32_t>(std::strlen(name));
+      append(&entries[j], sizeof(columnar_entry));
+      append(name, entries[j].name_size);
+      align(8);
+      append(stats[j].data(), stats[j].size() * sizeof(columnar_stats));
+    }
+    append(&footer, sizeof(footer));
+
+    flush();
+    file_.close();
+  }
+
+ private:
+  output_file file_;
+  R_xlen_t block_rows_;
+  R_xlen_t nrow_ = 0;
+  std::string buffer_;
+  int64_t position_ = 0;
+
+  static size_t buffer_size() noexcept { return 1 << 20; }
+
+  void flush() {
+    if (!buffer_.empty() && !file_.write(buffer_.data(), buffer_.size())) {
+      throw std::runtime_error("Can't write to '" + file_.path() + "'");
+    }
+    buffer_.clear();
+  }
+
+  // Large runs, such as whole blocks of numbers, bypass the buffer
+  void append(const void* data, size_t size) {
+    if (size >= buffer_size()) {
+      flush();
+      if (!file_.write(static_cast<const char*>(data), size)) {
+        throw std::runtime_error("Can't write to '" + file_.path() + "'");
+      }
+    } else {
+      buffer_.append(static_cast<const char*>(data), size);
+      if (buffer_.size() >= buffer_size()) {
+        flush();
+      }
+    }
+    position_ += static_cast<int64_t>(size);
+  }
+
+  void align(int64_t alignment = 64) {
+    static const char zeros[64] = {};
+    append(zeros, static_cast<size_t>((alignment - position_ % alignment) % alignment));
+  }
+
+  void write_column(SEXP x, columnar_entry& entry, std::vector<columnar_stats>& stats) {
+    entry.levels = 0;
+    switch (r_typeof(x)) {
+      case REALSXP:
+        entry.type = static_cast<int32_t>(columnar_type::real);
+        write_numbers(REAL_RO(x), stats);
+        break;
+      case INTSXP:
+        if (Rf_inherits(x, "factor")) {
+          entry.type = static_cast<int32_t>(columnar_type::factor);
+          write_numbers(INTEGER_RO(x), stats);
+          SEXP levels = Rf_getAttrib(x, R_LevelsSymbol);
+          entry.levels = Rf_xlength(levels);
+          align(8);
+          write_strings(levels, nullptr);
+        } else {
+          entry.type = static_cast<int32_t>(columnar_type::integer);
+          write_numbers(INTEGER_RO(x), stats);
+        }
+        break;
+      case LGLSXP:
+        entry.type = static_cast<int32_t>(columnar_type::logical);
+        write_numbers(LOGICAL_RO(x), stats);
+        break;
+      case STRSXP:
+        entry.type = static_cast<int32_t>(columnar_type::string);
+        write_strings(x, &stats);
+        break;
+      default:
+        throw std::invalid_argument(std::string("Can't write a column of type '") +
+                                    Rf_type2char(r_typeof(x)) + "'");
+    }
+  }
+
+  template <typename T>
+  void write_numbers(const T* values, std::vector<columnar_stats>& stats) {
+    for (R_xlen_t begin = 0; begin < nrow_; begin += block_rows_) {
+      const R_xlen_t end = begin + block_rows_ < nrow_ ? begin + block_rows_ : nrow_;
+      columnar_stats block = {NA_REAL, NA_REAL, 0};
+      for (R_xlen_t i = begin; i < end; ++i) {
+        const double value = static_cast<double>(values[i]);
+        if (is_na(values[i]) || ISNAN(value)) {
+          ++block.na_count;
+          continue;
+        }
+        if (ISNAN(block.min) || value < block.min) {
+          block.min = value;
+        }
+        if (ISNAN(block.max) || value > block.max) {
+          block.max = value;
+        }
+      }
+      stats.push_back(block);
+      append(values + begin, (end - begin) * sizeof(T));
+    }
+  }
+
+  // Two passes over `x`, writing the offsets and then the bytes
+  void write_strings(SEXP x, std::vector<columnar_stats>* stats) {
+    const R_xlen_t n = Rf_xlength(x);
+    int64_t offset = 0;
+    append(&offset, sizeof(offset));
+    columnar_stats block = {NA_REAL, NA_REAL, 0};
+    for (R_xlen_t i = 0; i < n; ++i) {
+      SEXP value = STRING_ELT(x, i);
+      int64_t end;
+      if (value == NA_STRING) {
+        ++block.na_count;
+        end = offset | string_na_bit();
+      } else {
+        offset += static_cast<int64_t>(std::strlen(utf8_chars(value)));
+        end = offset;
+      }
+      append(&end, sizeof(end));
+      if (stats != nullptr && ((i + 1) % block_rows_ == 0 || i + 1 == n)) {
+        stats->push_back(block);
+        block.na_count = 0;
+      }
+    }
+    for (R_xlen_t i = 0; i < n; ++i) {
+      SEXP value = STRING_ELT(x, i);
+      if (value != NA_STRING) {
+        const char* chars = utf8_chars(value);
+        append(chars, std::strlen(chars));
+      }
+    }
+  }
+};
+
+/// Keeps a mapped file alive for as long as an R vector views one of its columns
+struct mapped_column {
+  std::shared_ptr<mapped_file> file;
+  const void* buffers[2];
+};
+
+inline void release_mapped_column(ArrowArray* array) {
+  delete static_cast<mapped_column*>(array->private_data);
+  array->release = nullptr;
+}
+
+}  // namespace detail
+
+/// A file written by `write_columnar()`, mapped into memory.
+///
+/// Columns are read as ALTREP views of the mapped file where possible: doubles,
+/// integers and factor codes reuse the ALTREP classes of `arrow::init()`, so the file
+/// stays mapped until the last view is garbage collected and pages are only read as
+/// they are used. Without `arrow::init()`, or with `copy`, the values are copied, at
+/// about the speed of `memcpy()` once the file is in the page cache. Logicals are
+/// always copied, and strings are created once per distinct value.
+class columnar_file {
+ public:
+  explicit columnar_file(const std::string& path)
+      : path_(path), file_(std::make_shared<detail::mapped_file>(path)) {
+    const char* begin = file_->begin();
+    const int64_t size = file_->end() - begin;
+
+    detail::columnar_header header;
+    detail::columnar_footer footer;
+    if (size < static_cast<int64_t>(sizeof(header) + sizeof(footer))) {
+      throw std::runtime_error("'" + path + "' is not a cpp4r columnar file");
+    }
+    std::memcpy(&header, begin, sizeof(header));
+    std::memcpy(&footer, begin + size - sizeof(footer), sizeof(footer));
+    if (std::memcmp(header.magic, detail::columnar_magic(), 8) != 0 ||
+        std::memcmp(footer.magic, detail::columnar_magic(), 8) != 0) {
+      throw std::runtime_error("'" + path + "' is not a cpp4r columnar file");
+    }
+    if (header.version != 1 || header.byte_order != detail::columnar_byte_order()) {
+      throw std::runtime_error("'" + path +
+                               "' was written by another version or platform");
+    }
+    nrow_ = header.nrow;
+    block_rows_ = header.block_rows;
+    if (nrow_ < 0 || block_rows_ <= 0 || header.ncol < 0) {
+      corrupt();
+    }
+    const int64_t n_blocks = (nrow_ + block_rows_ - 1) / block_rows_;
+
+    int64_t position = footer.directory_offset;
+    const int64_t directory_end = size - static_cast<int64_t>(sizeof(footer));
+    entries_.resize(header.ncol);
+    names_.resize(header.ncol);
+    stats_.resize(header.ncol);
+    for (int64_t j = 0; j < header.ncol; ++j) {
+      detail::columnar_entry& entry = entries_[j];
+      read_directory(position, directory_end, &entry, sizeof(entry));
+      if (entry.name_size < 0 || entry.data_offset < 0 || entry.data_size < 0 ||
+          entry.data_offset + entry.data_size > footer.directory_offset ||
+          entry.data_size < expected_size(entry)) {
+        corrupt();
+      }
+      names_[j].resize(entry.name_size);
+      read_directory(position, directory_end, &names_[j][0], entry.name_size);
+      position += (8 - position % 8) % 8;
+      stats_[j].resize(n_blocks);
+      read_directory(position, directory_end, stats_[j].data(),
+                     n_blocks * sizeof(columnar_stats));
+    }
+  }
+
+  R_xlen_t nrow() const noexcept { return nrow_; }
+  R_xlen_t ncol() const noexcept { return static_cast<R_xlen_t>(entries_.size()); }
+  R_xlen_t block_rows() const noexcept { return block_rows_; }
+
+  const std::vector<std::string>& names() const noexcept { return names_; }
+
+  /// The position of the column called `name`, or -1 if there is none
+  R_xlen_t find(const std::string& name) const noexcept {
+    for (size_t j = 0; j < names_.size(); ++j) {
+      if (names_[j] == name) {
+        return static_cast<R_xlen_t>(j);
+      }
+    }
+    return -1;
+  }
+
+  /// The statistics of each block of `block_rows()` rows of column `j`
+  const std::vector<columnar_stats>& stats(R_xlen_t j) const { return stats_.at(j); }
+
+  /// Rows `[begin, end)` of column `j`
+  sexp column(R_xlen_t j, R_xlen_t begin, R_xlen_t end, bool copy = false) const {
+    if (j < 0 || j >= ncol()) {
+      throw std::out_of_range("Column " + std::to_string(j) + " is out of bounds");
+    }
+    if (begin < 0 || end < begin || end > nrow_) {
+      throw std::out_of_range("Rows must be a range within [0, " +
+                              std::to_string(nrow_) + "]");
+    }
+    const detail::columnar_entry& entry = entries_[j];
+    const char* data = file_->begin() + entry.data_offset;
+    switch (static_cast<detail::columnar_type>(entry.type)) {
+      case detail::columnar_type::real:
+        return numbers<double>("g", data, begin, end, copy);
+      case detail::columnar_type::integer:
+        return numbers<int>("i", data, begin, end, copy);
+      case detail::columnar_type::logical:
+        return numbers<r_bool>(nullptr, data, begin, end, true);
+      case detail::columnar_type::factor: {
+        sexp out = numbers<int>("i", data, begin, end, copy);
+        int64_t levels = entry.data_offset + nrow_ * static_cast<int64_t>(sizeof(int));
+        levels += (8 - levels % 8) % 8;
+        out.attr(R_LevelsSymbol) =
+            string_column(file_->begin() + levels,
+                          entry.data_offset + entry.data_size - levels, entry.levels, 0,
+                          entry.levels);
+        out.attr(R_ClassSymbol) = "factor";
+        return out;
+      }
+      case detail::columnar_type::string:
+        return string_column(data, entry.data_size, nrow_, begin, end);
+    }
+    corrupt();
+    return R_NilValue;
+  }
+
+  /// Rows `[begin, end)` of the columns called `columns`, all columns if empty. `end`
+  /// defaults to the number of rows.
+  writable::data_frame read(const std::vector<std::string>& columns = {},
+                            R_xlen_t begin = 0, R_xlen_t end = -1,
+                            bool copy = false) const {
+    if (end < 0) {
+      end = nrow_;
+    }
+    std::vector<R_xlen_t> positions;
+    if (columns.empty()) {
+      for (R_xlen_t j = 0; j < ncol(); ++j) {
+        positions.push_back(j);
+      }
+    } else {
+      for (const std::string& name : columns) {
+        R_xlen_t j = find(name);
+        if (j < 0) {
+          throw std::out_of_range("Unknown column '" + name + "'");
+        }
+        positions.push_back(j);
+      }
+    }
+
+    const R_xlen_t n = static_cast<R_xlen_t>(positions.size());
+    writable::list out(n);
+    writable::strings names(n);
+    for (R_xlen_t i = 0; i < n; ++i) {
+      out[i] = column(positions[i], begin, end, copy);
+      names[i] = names_[positions[i]];
+    }
+    out.names() = names;
+    return writable::data_frame(out, false, end - begin);
+  }
+
+ private:
+  std::string path_;
+  std::shared_ptr<detail::mapped_file> file_;
+  R_xlen_t nrow_;
+  R_xlen_t block_rows_;
+  std::vector<detail::columnar_entry> entries_;
+  std::vector<std::string> names_;
+  std::vector<std::vector<columnar_stats>> stats_;
+
+  [[noreturn]] void corrupt() const {
+    throw std::runtime_error("'" + path_ + "' is truncated or corrupt");
+  }
+
+  void read_directory(int64_t& position, int64_t end, void* out, int64_t size) const {
+    if (position < 0 || size < 0 || position + size > end) {
+      corrupt();
+    }
+    std::memcpy(out, file_->begin() + position, size);
+    position += size;
+  }
+
+  int64_t expected_size(const detail::columnar_entry& entry) const {
+    switch (static_cast<detail::columnar_type>(entry.type)) {
+      case detail::columnar_type::real:
+        return nrow_ * 8;
+      case detail::columnar_type::integer:
+      case detail::columnar_type::logical:
+        return nrow_ * 4;
+      case detail::columnar_type::factor:
+        return nrow_ * 4 + (entry.levels + 1) * 8;
+      case detail::columnar_type::string:
+        return (nrow_ + 1) * 8;
+    }
+    corrupt();
+  }
+
+  template <typename T>
+  sexp numbers(const char* format, const char* data, R_xlen_t begin, R_xlen_t end,
+               bool copy) const {
+    using traits = detail::column_traits<T>;
+    using value_type = typename traits::type;
+    const value_type* values = reinterpret_cast<const value_type*>(data);
+    if (!copy && detail::arrow_vector<value_type>::registered()) {
+      auto* owner = new detail::mapped_column{file_, {nullptr, values}};
+      ArrowArray array = ArrowArray();
+      array.length = end - begin;
+      array.offset = begin;
+      array.n_buffers = 2;
+      array.buffers = owner->buffers;
+      array.release = detail::release_mapped_column;
+      array.private_data = owner;
+      ArrowSchema schema = ArrowSchema();
+      schema.format = format;
+      return arrow::import_array(&schema, &array);
+    }
+    sexp out = safe[Rf_allocVector](traits::sexptype(), end - begin);
+    if (end > begin) {
+      std::memcpy(traits::mutable_ptr(out), values + begin,
+                  (end - begin) * sizeof(value_type));
+    }
+    return out;
+  }
+
+  // Strings `[begin, end)` of the `n` strings of the block at `data`, `size` bytes long
+  writable::strings string_column(const char* data, int64_t size, R_xlen_t n,
+                                  R_xlen_t begin, R_xlen_t end) const {
+    const int64_t* offsets = reinterpret_cast<const int64_t*>(data);
+    const char* chars = data + (n + 1) * 8;
+    const int64_t chars_size = size - (n + 1) * 8;
+    const int64_t mask = detail::string_na_bit() - 1;
+
+    writable::strings out(end - begin);
+    detail::charsxp_cache cache;
+    for (R_xlen_t i = begin; i < end; ++i) {
+      const int64_t start = offsets[i] & mask;
+      const int64_t stop = offsets[i + 1] & mask;
+      if (stop < start || stop > chars_size) {
+        corrupt();
+      }
+      if (offsets[i + 1] & detail::string_na_bit()) {
+        SET_STRING_ELT(out, i - begin, NA_STRING);
+        continue;
+      }
+      const size_t length = static_cast<size_t>(stop - start);
+      detail::string_field field = {chars + start, length,
+                                    detail::hash_bytes(chars + start, length), false};
+      SET_STRING_ELT(out, i - begin, cache.get(field, '"'));
+    }
+    return out;
+  }
+};
+
+/// Write `x` to `path` in the columnar format read by `columnar_file`. Each column is
+/// streamed straight from the data frame, in 64 byte aligned blocks, along with the
+/// minimum, maximum and number of `NA`s of every block of `block_rows` rows. Doubles,
+/// integers, logicals, strings and factors are supported.
+inline void write_columnar(const data_frame& x, const std::string& path,
+                           const columnar_options& options = columnar_options()) {
+  detail::columnar_writer writer(path, options);
+  writer.write(x);
+}
+
+/// Read rows `[begin, end)` of `columns` of the columnar file at `path`, see
+/// `columnar_file::read()`
+inline writable::data_frame read_columnar(const std::string& path,
+                                          const std::vector<std::string>& columns = {},
+                                          R_xlen_t begin = 0, R_xlen_t end = -1,
+                                          bool copy = false) {
+  return columnar_file(path).read(columns, begin, end, copy);
+}
+
+}  // namespace cpp4r
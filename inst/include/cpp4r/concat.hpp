@@ -0,0 +1,273 @@
+#pragma once
+
+#include <cstring>      // for memcpy, strcmp
+#include <stdexcept>    // for invalid_argument
+#include <string>       // for string
+#include <type_traits>  // for is_same
+#include <vector>       // for vector
+
+#if defined(_OPENMP)
+#include <omp.h>  // for omp_get_max_threads
+#endif
+
+#include "cpp4r/R.hpp"           // for SEXP, SEXPREC, Rf_allocVector, REAL_RO
+#include "cpp4r/data_frame.hpp"  // for data_frame, column_traits
+#include "cpp4r/list.hpp"        // for list
+#include "cpp4r/list_of.hpp"     // for list_of
+#include "cpp4r/protect.hpp"     // for safe
+#include "cpp4r/r_vector.hpp"    // for r_vector, type_error
+#include "cpp4r/sexp.hpp"        // for sexp
+
+namespace cpp4r {
+
+struct concat_options {
+  /// Carry the names of the pieces, with `""` for pieces without names
+  bool names = true;
+  /// Threads copying totals of at least 2^20 values, 0 for the OpenMP default
+  int num_threads = 0;
+};
+
+namespace detail {
+
+inline R_xlen_t concat_parallel_threshold() noexcept { return 1 << 20; }
+
+/// Copy `sources` end to end into `out`, piece `k` to `out + offsets[k]`
+template <typename T>
+inline void copy_pieces(const std::vector<const T*>& sources,
+                        const std::vector<R_xlen_t>& offsets, T* out, int num_threads) {
+  const R_xlen_t n = static_cast<R_xlen_t>(sources.size());
+#if defined(_OPENMP)
+  const int n_threads = num_threads > 0 ? num_threads : omp_get_max_threads();
+#pragma omp parallel for schedule(dynamic, 16) num_threads(n_threads) \
+    if (offsets[n] >= concat_parallel_threshold())
+#else
+  (void)num_threads;
+#endif
+  for (R_xlen_t k = 0; k < n; ++k) {
+    const R_xlen_t size = offsets[k + 1] - offsets[k];
+    if (size > 0) {
+      std::memcpy(out + offsets[k], sources[k], size * sizeof(T));
+    }
+  }
+}
+
+/// The data pointers of `pieces`, taken on the main thread as ALTREP pieces may need
+/// to allocate
+template <typename T>
+inline std::vector<const T*> piece_pointers(const std::vector<SEXP>& pieces,
+                                            const T* (*ptr)(SEXP)) {
+  std::vector<const T*> out(pieces.size());
+  for (size_t k = 0; k < pieces.size(); ++k) {
+    out[k] = ptr(pieces[k]);
+  }
+  return out;
+}
+
+/// `pieces`, which must all be of `type`, copied end to end into a single new vector.
+/// Names are carried if `options.names` and any piece has names.
+inline sexp concat_pieces(const std::vector<SEXP>& pieces, SEXPTYPE type,
+                          const concat_options& options) {
+  const size_t n_pieces = pieces.size();
+  std::vector<R_xlen_t> offsets(n_pieces + 1, 0);
+  bool has_names = false;
+  for (size_t k = 0; k < n_pieces; ++k) {
+    SEXP piece = pieces[k];
+    if (r_typeof(piece) != type) {
+      throw type_error(type, r_typeof(piece));
+    }
+    offsets[k + 1] = offsets[k] + Rf_xlength(piece);
+    has_names = has_names ||
+                (options.names && Rf_getAttrib(piece, R_NamesSymbol) != R_NilValue);
+  }
+  const R_xlen_t total = offsets[n_pieces];
+
+  sexp out = safe[Rf_allocVector](type, total);
+  switch (type) {
+    case REALSXP:
+      copy_pieces(piece_pointers(pieces, real_ptr), offsets, REAL(out),
+                  options.num_threads);
+      break;
+    case INTSXP:
+      copy_pieces(piece_pointers(pieces, integer_ptr), offsets, INTEGER(out),
+                  options.num_threads);
+      break;
+    case LGLSXP:
+      copy_pieces(piece_pointers(pieces, logical_ptr), offsets, LOGICAL(out),
+                  options.num_threads);
+      break;
+    case STRSXP:
+      // Only the pointers to the existing `CHARSXP`s are copied
+      for (size_t k = 0; k < n_pieces; ++k) {
+        const SEXP* p = STRING_PTR_RO(pieces[k]);
+        for (R_xlen_t i = 0, n = offsets[k + 1] - offsets[k]; i < n; ++i) {
+          SET_STRING_ELT(out, offsets[k] + i, p[i]);
+        }
+      }
+      break;
+    case VECSXP:
+      for (size_t k = 0; k < n_pieces; ++k) {
+        for (R_xlen_t i = 0, n = offsets[k + 1] - offsets[k]; i < n; ++i) {
+          SET_VECTOR_ELT(out, offsets[k] + i, VECTOR_ELT(pieces[k], i));
+        }
+      }
+      break;
+    default:
+      throw std::invalid_argument(
+          "Can only concatenate logical, integer, double, character or list vectors");
+  }
+
+  if (has_names) {
+    sexp names = safe[Rf_allocVector](STRSXP, total);
+    for (size_t k = 0; k < n_pieces; ++k) {
+      SEXP piece_names = Rf_getAttrib(pieces[k], R_NamesSymbol);
+      for (R_xlen_t i = 0, n = offsets[k + 1] - offsets[k]; i < n; ++i) {
+        SET_STRING_ELT(names, offsets[k] + i,
+                       piece_names == R_NilValue ? R_BlankString
+                                                 : STRING_ELT(piece_names, i));
+      }
+    }
+    Rf_setAttrib(out, R_NamesSymbol, names);
+  }
+  return out;
+}
+
+inline bool same_string(SEXP x, SEXP y) noexcept {
+  return x == y || std::strcmp(CHAR(x), CHAR(y)) == 0;
+}
+
+/// The columns of `frames` must have the same names and types, and factors the same
+/// levels in the same order
+inline void check_rbind_schema(const std::vector<SEXP>& frames) {
+  SEXP first = frames[0];
+  SEXP names = Rf_getAttrib(first, R_NamesSymbol);
+  const R_xlen_t ncol = Rf_xlength(first);
+  for (size_t k = 1; k < frames.size(); ++k) {
+    SEXP frame = frames[k];
+    SEXP frame_names = Rf_getAttrib(frame, R_NamesSymbol);
+    if (Rf_xlength(frame) != ncol) {
+      throw std::invalid_argument(
+          "Can't bind data frames with different numbers of columns");
+    }
+    if (ncol > 0 && (names == R_NilValue || frame_names == R_NilValue)) {
+      throw std::invalid_argument("Can't bind data frames without column names");
+    }
+    for (R_xlen_t j = 0; j < ncol; ++j) {
+      if (!same_string(STRING_ELT(names, j), STRING_ELT(frame_names, j))) {
+        throw std::invalid_argument("Can't bind data frames with different column names");
+      }
+      SEXP x = VECTOR_ELT(first, j);
+      SEXP y = VECTOR_ELT(frame, j);
+      const bool factor = Rf_inherits(x, "factor");
+      if (r_typeof(x) != r_typeof(y) || factor != Rf_inherits(y, "factor")) {
+        throw std::invalid_argument("Column '" + std::string(CHAR(STRING_ELT(names, j))) +
+                                    "' has different types");
+      }
+      if (factor) {
+        SEXP x_levels = Rf_getAttrib(x, R_LevelsSymbol);
+        SEXP y_levels = Rf_getAttrib(y, R_LevelsSymbol);
+        bool same = Rf_xlength(x_levels) == Rf_xlength(y_levels);
+        for (R_xlen_t i = 0; same && i < Rf_xlength(x_levels); ++i) {
+          same = same_string(STRING_ELT(x_levels, i), STRING_ELT(y_levels, i));
+        }
+        if (!same) {
+          throw std::invalid_argument("Factor column '" +
+                                      std::string(CHAR(STRING_ELT(names, j))) +
+                                      "' has different levels");
+        }
+      }
+    }
+  }
+}
+
+/// The element type `T` of `r_vector<T>` and `writable::r_vector<T>`
+template <typename V>
+struct r_vector_value {};
+
+template <typename T>
+struct r_vector_value<r_vector<T>> {
+  using type = T;
+};
+
+template <typename T>
+struct r_vector_value<writable::r_vector<T>> {
+  using type = T;
+};
+
+}  // namespace detail
+
+/// The vectors of `pieces` concatenated into a single vector.
+///
+/// The output is sized in one pass and allocated once. Numbers are copied with
+/// `memcpy()`, in parallel for large totals when compiled with OpenMP, and strings by
+/// pointer, without creating new `CHARSXP`s. Unlike `c()`, the names of `pieces`
+/// themselves are not used, and attributes other than names are dropped.
+template <typename T>
+inline T concat(const list_of<T>& pieces,
+                const concat_options& options = concat_options()) {
+  const R_xlen_t n = pieces.size();
+  std::vector<SEXP> sexps(n);
+  for (R_xlen_t k = 0; k < n; ++k) {
+    sexps[k] = VECTOR_ELT(pieces, k);
+  }
+  return T(detail::concat_pieces(
+      sexps, detail::column_traits<typename T::value_type>::sexptype(), options));
+}
+
+/// `first`, `second` and `rest` concatenated into a single vector, see `concat()`.
+///
+/// Each argument is converted through its own `operator SEXP`, so writable vectors
+/// grown with `push_back()` are truncated to their length and get their names first.
+template <typename A, typename B, typename... U,
+          typename T = typename detail::r_vector_value<A>::type>
+inline enable_if_t<std::is_same<typename detail::r_vector_value<B>::type, T>::value,
+                   r_vector<T>>
+concat(const A& first, const B& second, const U&... rest) {
+  std::vector<SEXP> sexps = {static_cast<SEXP>(first), static_cast<SEXP>(second),
+                             static_cast<SEXP>(rest)...};
+  return r_vector<T>(
+      detail::concat_pieces(sexps, detail::r_typeof(sexps[0]), concat_options()));
+}
+
+/// The rows of `frames`, which must have the same column names and types, bound
+/// together into a single data frame.
+///
+/// Each column is built like `concat()`, with a single allocation, and keeps the
+/// attributes of the column of the first data frame, such as factor levels or classes.
+/// Factor columns must have identical levels.
+inline writable::data_frame rbind(const list_of<data_frame>& frames,
+                                  const concat_options& options = concat_options()) {
+  const R_xlen_t n = frames.size();
+  if (n == 0) {
+    return writable::data_frame(writable::list(R_xlen_t(0)), false, 0);
+  }
+  std::vector<SEXP> sexps(n);
+  for (R_xlen_t k = 0; k < n; ++k) {
+    sexps[k] = VECTOR_ELT(frames, k);
+  }
+  detail::check_rbind_schema(sexps);
+
+  SEXP first = sexps[0];
+  const R_xlen_t ncol = Rf_xlength(first);
+  concat_options column_options = options;
+  column_options.names = false;
+  writable::list columns(ncol);
+  std::vector<SEXP> pieces(n);
+  for (R_xlen_t j = 0; j < ncol; ++j) {
+    for (R_xlen_t k = 0; k < n; ++k) {
+      pieces[k] = VECTOR_ELT(sexps[k], j);
+    }
+    SEXP column = VECTOR_ELT(first, j);
+    sexp out = detail::concat_pieces(pieces, detail::r_typeof(column), column_options);
+    safe[Rf_copyMostAttrib](column, out);
+    columns[j] = out;
+  }
+  columns.names() = Rf_getAttrib(first, R_NamesSymbol);
+
+  R_xlen_t nrow = 0;
+  for (R_xlen_t k = 0; k < n; ++k) {
+    nrow += data_frame(sexps[k]).nrow();
+  }
+  return writable::data_frame(columns, false, nrow);
+}
+
+}  // namespace cpp4r
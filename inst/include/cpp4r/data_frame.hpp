@@ -1,15 +1,27 @@
 #pragma once
 
+#include <stddef.h>  // for size_t
+
+#include <array>             // for array
 #include <cstdlib>           // for abs
 #include <initializer_list>  // for initializer_list
+#include <iterator>          // for forward_iterator_tag
+#include <memory>            // for unique_ptr
+#include <stdexcept>         // for invalid_argument, out_of_range
 #include <string>            // for string, basic_string
+#include <tuple>             // for tuple, tuple_element
+#include <unordered_map>     // for unordered_map
 #include <utility>           // for move
+#include <vector>            // for vector
 
 #include "R_ext/Arith.h"              // for NA_INTEGER
 #include "cpp4r/R.hpp"                // for Rf_xlength, SEXP, SEXPREC, INTEGER
 #include "cpp4r/attribute_proxy.hpp"  // for attribute_proxy
 #include "cpp4r/list.hpp"             // for list, r_vector<>::r_vector, r_v...
-#include "cpp4r/r_vector.hpp"         // for r_vector
+#include "cpp4r/protect.hpp"          // for safe
+#include "cpp4r/r_bool.hpp"           // for r_bool
+#include "cpp4r/r_string.hpp"         // for r_string
+#include "cpp4r/r_vector.hpp"         // for r_vector, type_error
 
 namespace cpp4r {
 
@@ -18,6 +30,149 @@ namespace writable {
 class data_frame;
 }  // namespace writable
 
+namespace detail {
+
+/// The element type and accessor of the columns `data_frame::chunks()` can read
+template <typename T>
+struct column_traits;
+
+template <>
+struct column_traits<double> {
+  using type = double;
+  static SEXPTYPE sexptype() { return REALSXP; }
+  static const type* ptr(SEXP x) { return real_ptr(x); }
+  static type* mutable_ptr(SEXP x) { return REAL(x); }
+};
+
+template <>
+struct column_traits<int> {
+  using type = int;
+  static SEXPTYPE sexptype() { return INTSXP; }
+  static const type* ptr(SEXP x) { return integer_ptr(x); }
+  static type* mutable_ptr(SEXP x) { return INTEGER(x); }
+};
+
+template <>
+struct column_traits<r_bool> {
+  using type = int;
+  static SEXPTYPE sexptype() { return LGLSXP; }
+  static const type* ptr(SEXP x) { return logical_ptr(x); }
+  static type* mutable_ptr(SEXP x) { return LOGICAL(x); }
+};
+
+template <>
+struct column_traits<r_string> {
+  using type = SEXP;
+  static SEXPTYPE sexptype() { return STRSXP; }
+  static const type* ptr(SEXP x) { return string_ptr(x); }
+};
+
+/// The positions of a data frame's columns by name, see `data_frame::column_index()`
+struct column_name_index {
+  std::unordered_map<std::string, R_xlen_t> positions;
+  /// The names attribute `positions` was built from
+  SEXP names;
+};
+
+template <typename T>
+inline const void* checked_column_ptr(SEXP x) {
+  if (detail::r_typeof(x) != column_traits<T>::sexptype()) {
+    throw type_error(column_traits<T>::sexptype(), detail::r_typeof(x));
+  }
+  return column_traits<T>::ptr(x);
+}
+
+}  // namespace detail
+
+/// A block of rows of some columns of a data frame, see `data_frame::chunks()`
+template <typename... T>
+class data_frame_chunk {
+ public:
+  template <size_t I>
+  using value_type = typename detail::column_traits<
+      typename std::tuple_element<I, std::tuple<T...>>::type>::type;
+
+  data_frame_chunk(const std::array<const void*, sizeof...(T)>& columns, R_xlen_t offset,
+                   R_xlen_t size) noexcept
+      : columns_(columns), offset_(offset), size_(size) {}
+
+  /// The index of the first row of the chunk
+  R_xlen_t offset() const noexcept { return offset_; }
+  /// The number of rows of the chunk
+  R_xlen_t size() const noexcept { return size_; }
+
+  /// The data of the `I`th column, starting at the first row of the chunk
+  template <size_t I>
+  const value_type<I>* get() const noexcept {
+    return static_cast<const value_type<I>*>(columns_[I]) + offset_;
+  }
+
+ private:
+  std::array<const void*, sizeof...(T)> columns_;
+  R_xlen_t offset_;
+  R_xlen_t size_;
+};
+
+/// Row chunks of some columns of a data frame, see `data_frame::chunks()`
+template <typename... T>
+class data_frame_chunks {
+ public:
+  class const_iterator {
+   private:
+    const data_frame_chunks* data_;
+    R_xlen_t pos_;
+
+   public:
+    using difference_type = ptrdiff_t;
+    using value_type = data_frame_chunk<T...>;
+    using pointer = value_type*;
+    using reference = value_type&;
+    using iterator_category = std::forward_iterator_tag;
+
+    const_iterator(const data_frame_chunks* data, R_xlen_t pos) noexcept
+        : data_(data), pos_(pos) {}
+
+    const_iterator& operator++() noexcept {
+      pos_ += data_->chunk_size_;
+      if (pos_ > data_->nrow_) {
+        pos_ = data_->nrow_;
+      }
+      return *this;
+    }
+
+    bool operator!=(const const_iterator& other) const noexcept {
+      return pos_ != other.pos_;
+    }
+    bool operator==(const const_iterator& other) const noexcept {
+      return pos_ == other.pos_;
+    }
+
+    value_type operator*() const noexcept {
+      R_xlen_t size = data_->nrow_ - pos_;
+      if (size > data_->chunk_size_) {
+        size = data_->chunk_size_;
+      }
+      return {data_->columns_, pos_, size};
+    }
+  };
+
+  data_frame_chunks(const std::array<const void*, sizeof...(T)>& columns, R_xlen_t nrow,
+                    R_xlen_t chunk_size)
+      : columns_(columns), nrow_(nrow), chunk_size_(chunk_size) {
+    if (chunk_size < 1) {
+      throw std::invalid_argument("`chunk_size` must be positive");
+    }
+  }
+
+  const_iterator begin() const noexcept { return const_iterator(this, 0); }
+  const_iterator end() const noexcept { return const_iterator(this, nrow_); }
+
+ private:
+  std::array<const void*, sizeof...(T)> columns_;
+  R_xlen_t nrow_;
+  R_xlen_t chunk_size_;
+};
+
 class data_frame : public list {
   using list::list;
 
@@ -55,11 +210,83 @@ class data_frame : public list {
   }
 
  public:
+  data_frame() = default;
+  // Copies share the data but build their own name index on demand
+  data_frame(const data_frame& rhs) : list(rhs) {}
+  data_frame(data_frame&& rhs) = default;
+  data_frame& operator=(const data_frame& rhs) {
+    list::operator=(rhs);
+    index_.reset();
+    return *this;
+  }
+  data_frame& operator=(data_frame&& rhs) = default;
+
   /* Adapted from
    * https://github.com/wch/r-source/blob/f2a0dfab3e26fb42b8b296fcba40cbdbdbec767d/src/main/attrib.c#L198-L207
    */
   R_xlen_t nrow() const noexcept { return calc_nrow(*this); }
   R_xlen_t ncol() const noexcept { return size(); }
+
+  /// The position of the column called `name`. Names are indexed on the first lookup,
+  /// and re-indexed when the names attribute is replaced or a hit no longer matches,
+  /// e.g. after the names were edited in place.
+  R_xlen_t column_index(const std::string& name) const {
+    SEXP names = get_attrib0(data(), R_NamesSymbol);
+    if (index_ != nullptr && names == index_->names) {
+      auto it = index_->positions.find(name);
+      if (it != index_->positions.end() && it->second < Rf_xlength(names) &&
+          name == safe[Rf_translateCharUTF8](STRING_ELT(names, it->second))) {
+        return it->second;
+      }
+    }
+    index_columns(names);
+
+    auto it = index_->positions.find(name);
+    if (it == index_->positions.end()) {
+      throw std::out_of_range("Unknown column '" + name + "'");
+    }
+    return it->second;
+  }
+
+  /// The column called `name`, as a `T` such as `doubles` or `strings`
+  template <typename T>
+  T column(const std::string& name) const {
+    return T(VECTOR_ELT(data(), column_index(name)));
+  }
+
+  /// Iterate over blocks of `chunk_size` rows of the columns called `names`. Each chunk
+  /// gives a pointer per column, e.g. `const double*` for `double` and `const SEXP*` for
+  /// `r_string`, so that kernels over several columns work on one block at a time.
+  ///
+  /// The data frame must outlive the iteration.
+  template <typename... T>
+  data_frame_chunks<T...> chunks(const std::vector<std::string>& names,
+                                 R_xlen_t chunk_size = 4096) const {
+    if (names.size() != sizeof...(T)) {
+      throw std::invalid_argument("Expected one column name per chunk type");
+    }
+    size_t i = 0;
+    std::array<const void*, sizeof...(T)> columns = {
+        {detail::checked_column_ptr<T>(VECTOR_ELT(data(), column_index(names[i++])))...}};
+    return {columns, nrow(), chunk_size};
+  }
+
+ private:
+  void index_columns(SEXP names) const {
+    if (index_ == nullptr) {
+      index_.reset(new detail::column_name_index());
+    }
+    index_->positions.clear();
+    index_->names = nullptr;
+    R_xlen_t n = Rf_xlength(names);
+    for (R_xlen_t pos = 0; pos < n; ++pos) {
+      index_->positions.emplace(safe[Rf_translateCharUTF8](STRING_ELT(names, pos)), pos);
+    }
+    index_->names = names;
+  }
+
+  // Built on the first lookup, so data frames that are only copied around don't pay
+  mutable std::unique_ptr<detail::column_name_index> index_;
 };
 
 namespace writable {
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <stddef.h>  // for size_t
+
+#include <cstring>      // for memcpy
+#include <stdexcept>    // for invalid_argument
+#include <string>       // for string
+#include <tuple>        // for tuple, get
+#include <type_traits>  // for integral_constant
+#include <vector>       // for vector
+
+#include "cpp4r/R.hpp"           // for SEXP, SEXPREC, Rf_allocVector, SET_STRING_ELT
+#include "cpp4r/data_frame.hpp"  // for data_frame, column_traits
+#include "cpp4r/list.hpp"        // for list
+#include "cpp4r/protect.hpp"     // for safe
+#include "cpp4r/r_bool.hpp"      // for r_bool
+#include "cpp4r/r_string.hpp"    // for r_string
+#include "cpp4r/sexp.hpp"        // for sexp
+#include "cpp4r/strings.hpp"     // for strings
+
+namespace cpp4r {
+
+namespace detail {
+
+/// Growable storage of one column of a `data_frame_builder`. Numeric columns are kept
+/// in C++ memory and copied into an R vector of the exact size at the end.
+template <typename T>
+class column_buffer {
+ public:
+  using value_type = typename column_traits<T>::type;
+
+  void reserve(R_xlen_t capacity) { data_.reserve(capacity); }
+
+  void push_back(const T& value) { data_.push_back(static_cast<value_type>(value)); }
+
+  void append(const value_type* values, R_xlen_t n) {
+    data_.insert(data_.end(), values, values + n);
+  }
+
+  SEXP finish() {
+    const R_xlen_t n = static_cast<R_xlen_t>(data_.size());
+    SEXP out = safe[Rf_allocVector](column_traits<T>::sexptype(), n);
+    if (n > 0) {
+      value_type* p = column_traits<T>::mutable_ptr(out);
+      std::memcpy(p, data_.data(), n * sizeof(value_type));
+    }
+    std::vector<value_type>().swap(data_);
+    return out;
+  }
+
+ private:
+  std::vector<value_type> data_;
+};
+
+/// String columns hold `CHARSXP`s, which must stay reachable by the garbage collector,
+/// so they are written straight into a `STRSXP` that grows with the other columns.
+template <>
+class column_buffer<r_string> {
+ public:
+  using value_type = SEXP;
+
+  void reserve(R_xlen_t capacity) {
+    if (capacity <= capacity_) {
+      return;
+    }
+    sexp data = safe[Rf_allocVector](STRSXP, capacity);
+    for (R_xlen_t i = 0; i < size_; ++i) {
+      SET_STRING_ELT(data, i, STRING_ELT(data_, i));
+    }
+    data_ = data;
+    capacity_ = capacity;
+  }
+
+  // The builder reserves all columns before appending to any of them
+  void push_back(const r_string& value) { SET_STRING_ELT(data_, size_++, value); }
+
+  void append(const SEXP* values, R_xlen_t n) {
+    for (R_xlen_t i = 0; i < n; ++i) {
+      SET_STRING_ELT(data_, size_++, values[i]);
+    }
+  }
+
+  SEXP finish() {
+    // `data_` is still unallocated when nothing was reserved
+    if (size_ != capacity_ || data_ == R_NilValue) {
+      sexp out = safe[Rf_allocVector](STRSXP, size_);
+      for (R_xlen_t i = 0; i < size_; ++i) {
+        SET_STRING_ELT(out, i, STRING_ELT(data_, i));
+      }
+      data_ = out;
+    }
+    SEXP out = data_;
+    data_ = R_NilValue;
+    size_ = 0;
+    capacity_ = 0;
+    return out;
+  }
+
+ private:
+  sexp data_;
+  R_xlen_t size_ = 0;
+  R_xlen_t capacity_ = 0;
+};
+
+}  // namespace detail
+
+/// Builds a data frame row by row when the number of rows is not known in advance.
+///
+/// The column types are given as template arguments, one of `double`, `int`, `r_bool`
+/// or `r_string`. All columns grow together and are converted to R vectors of the
+/// exact size once, in `finish()`.
+///
+/// ```cpp
+/// cpp4r::data_frame_builder<double, int, cpp4r::r_string> b({"x", "g", "s"});
+/// b.append_row(1.5, 2, "a");
+/// cpp4r::writable::data_frame df = b.finish();
+/// ```
+template <typename... T>
+class data_frame_builder {
+ public:
+  explicit data_frame_builder(const std::vector<std::string>& names,
+                              R_xlen_t capacity = 0)
+      : names_(names) {
+    if (names.size() != sizeof...(T)) {
+      throw std::invalid_argument("Expected one column name per column type");
+    }
+    reserve(capacity);
+  }
+
+  R_xlen_t size() const noexcept { return size_; }
+  R_xlen_t capacity() const noexcept { return capacity_; }
+
+  void reserve(R_xlen_t new_capacity) {
+    if (new_capacity > capacity_) {
+      capacity_ = new_capacity;
+      reserve_columns(std::integral_constant<size_t, 0>());
+    }
+  }
+
+  void append_row(const T&... values) {
+    if (__builtin_expect(size_ == capacity_, 0)) {
+      reserve(capacity_ == 0 ? 16 : 2 * capacity_);
+    }
+    push_back_columns(std::integral_constant<size_t, 0>(), values...);
+    ++size_;
+  }
+
+  /// Append `n` rows given as one pointer per column, e.g. `const double*` for `double`
+  /// columns and `const SEXP*` for `r_string` columns
+  void append_rows(R_xlen_t n, const typename detail::column_traits<T>::type*... values) {
+    if (size_ + n > capacity_) {
+      reserve(size_ + n > 2 * capacity_ ? size_ + n : 2 * capacity_);
+    }
+    append_columns(std::integral_constant<size_t, 0>(), n, values...);
+    size_ += n;
+  }
+
+  /// The data frame of all rows appended so far, the builder is left empty
+  writable::data_frame finish() {
+    writable::list columns(static_cast<R_xlen_t>(sizeof...(T)));
+    finish_columns(std::integral_constant<size_t, 0>(), columns);
+
+    writable::strings names(static_cast<R_xlen_t>(sizeof...(T)));
+    for (size_t i = 0; i < sizeof...(T); ++i) {
+      names[i] = names_[i];
+    }
+    columns.names() = names;
+
+    R_xlen_t nrow = size_;
+    size_ = 0;
+    capacity_ = 0;
+    return writable::data_frame(columns, false, nrow);
+  }
+
+ private:
+  std::vector<std::string> names_;
+  std::tuple<detail::column_buffer<T>...> columns_;
+  R_xlen_t size_ = 0;
+  R_xlen_t capacity_ = 0;
+
+  // Compile time loops over the columns, C++11 has no fold expressions
+  template <size_t I>
+  using index = std::integral_constant<size_t, I>;
+  using end = index<sizeof...(T)>;
+
+  void reserve_columns(end) {}
+  template <size_t I>
+  void reserve_columns(index<I>) {
+    std::get<I>(columns_).reserve(capacity_);
+    reserve_columns(index<I + 1>());
+  }
+
+  void push_back_columns(end) {}
+  template <size_t I, typename U, typename... Rest>
+  void push_back_columns(index<I>, const U& value, const Rest&... rest) {
+    std::get<I>(columns_).push_back(value);
+    push_back_columns(index<I + 1>(), rest...);
+  }
+
+  void append_columns(end, R_xlen_t) {}
+  template <size_t I, typename U, typename... Rest>
+  void append_columns(index<I>, R_xlen_t n, const U* values, const Rest*... rest) {
+    std::get<I>(columns_).append(values, n);
+    append_columns(index<I + 1>(), n, rest...);
+  }
+
+  void finish_columns(end, writable::list&) {}
+  template <size_t I>
+  void finish_columns(index<I>, writable::list& columns) {
+    columns[I] = std::get<I>(columns_).finish();
+    finish_columns(index<I + 1>(), columns);
+  }
+};
+
+}  // namespace cpp4r
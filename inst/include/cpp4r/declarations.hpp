@@ -19,24 +19,26 @@ using namespace ::cpp4r;
 
 #define CPP4R_ERROR_BUFSIZE 8192
 
-#define BEGIN_CPP4R                   \
-  SEXP err = R_NilValue;              \
-  char buf[CPP4R_ERROR_BUFSIZE] = ""; \
+#define BEGIN_CPP4R                          \
+  SEXP err = R_NilValue;                     \
+  char buf[CPP4R_ERROR_BUFSIZE] = "";        \
+  cpp4r::detail::pending_warnings().clear(); \
   try {
-#define END_CPP4R                                               \
-  }                                                             \
-  catch (cpp4r::unwind_exception & e) {                         \
-    err = e.token;                                              \
-  }                                                             \
-  catch (std::exception & e) {                                  \
-    strncpy(buf, e.what(), sizeof(buf) - 1);                    \
-  }                                                             \
-  catch (...) {                                                 \
-    strncpy(buf, "C++ error (unknown cause)", sizeof(buf) - 1); \
-  }                                                             \
-  if (buf[0] != '\0') {                                         \
-    Rf_errorcall(R_NilValue, "%s", buf);                        \
-  } else if (err != R_NilValue) {                               \
-    R_ContinueUnwind(err);                                      \
-  }                                                             \
+#define END_CPP4R                                                \
+  }                                                              \
+  catch (cpp4r::unwind_exception & e) {                          \
+    err = e.token;                                               \
+  }                                                              \
+  catch (std::exception & e) {                                   \
+    strncpy(buf, e.what(), sizeof(buf) - 1);                     \
+  }                                                              \
+  catch (...) {                                                  \
+    strncpy(buf, "C++ error (unknown cause)", sizeof(buf) - 1);  \
+  }                                                              \
+  cpp4r::detail::finish_pending_warnings(buf, sizeof(buf), err); \
+  if (buf[0] != '\0') {                                          \
+    Rf_errorcall(R_NilValue, "%s", buf);                         \
+  } else if (err != R_NilValue) {                                \
+    R_ContinueUnwind(err);                                       \
+  }                                                              \
   return R_NilValue;
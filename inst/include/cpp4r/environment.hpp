@@ -8,6 +8,7 @@
 #include "cpp4r/as.hpp"       // for as_sexp
 #include "cpp4r/protect.hpp"  // for protect, protect::function, safe, unwin...
 #include "cpp4r/sexp.hpp"     // for sexp
+#include "cpp4r/symbol.hpp"   // for symbol
 
 namespace cpp4r {
 
@@ -60,6 +61,7 @@ class environment {
   environment(environment&& other) noexcept = default;
   environment& operator=(environment&& other) noexcept = default;
   inline proxy operator[](const SEXP name) const noexcept { return {env_, name}; }
+  inline proxy operator[](const symbol& name) const noexcept { return {env_, name}; }
   inline proxy operator[](const char* name) const {
     // Cache the symbol lookup
     SEXP symbol = safe[Rf_install](name);
@@ -70,6 +72,7 @@ class environment {
   }
 
   inline bool exists(SEXP name) const { return safe[detail::r_env_has](env_, name); }
+  inline bool exists(const symbol& name) const { return exists(name.data()); }
   inline bool exists(const char* name) const {
     // Cache the symbol lookup
     SEXP symbol = safe[Rf_install](name);
@@ -82,6 +85,8 @@ class environment {
     unwind_protect([&] { R_removeVarFromFrame(name, env_); });
   }
 
+  void remove(const symbol& name) { remove(name.data()); }
+
   void remove(const char* name) {
     // Cache the symbol lookup and call remove directly
     SEXP symbol = safe[Rf_install](name);
@@ -0,0 +1,367 @@
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint64_t, uintptr_t
+
+#include <algorithm>  // for sort
+#include <cstring>    // for strcmp
+#include <iterator>   // for forward_iterator_tag
+#include <stdexcept>  // for invalid_argument
+#include <vector>     // for vector
+
+#include "R_ext/Arith.h"       // for NA_INTEGER
+#include "cpp4r/R.hpp"         // for SEXP, SEXPREC, R_LevelsSymbol, Rf_inherits
+#include "cpp4r/integers.hpp"  // for integers
+#include "cpp4r/protect.hpp"   // for safe
+#include "cpp4r/r_string.hpp"  // for r_string
+#include "cpp4r/r_vector.hpp"  // for type_error
+#include "cpp4r/strings.hpp"   // for strings
+
+namespace cpp4r {
+
+namespace detail {
+
+// Finalizer of MurmurHash3, good enough to spread aligned pointers and small integers
+// over the buckets of a power of two table.
+inline size_t hash_mix(uint64_t x) noexcept {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return static_cast<size_t>(x);
+}
+
+inline size_t hash_pointer(const void* x) noexcept {
+  return hash_mix(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(x)));
+}
+
+/// Open addressing table from `CHARSXP` pointers to dense integer ids.
+///
+/// R interns every `CHARSXP` in its global string cache, so two equal strings in the
+/// same encoding share a pointer and we never have to look at the bytes.
+class charsxp_table {
+ public:
+  explicit charsxp_table(R_xlen_t capacity_hint = 0) { rehash(capacity_hint); }
+
+  /// The id of `key`, or -1 if absent
+  int find(SEXP key) const noexcept {
+    for (size_t i = hash_pointer(key) & mask_;; i = (i + 1) & mask_) {
+      if (keys_[i] == key) {
+        return ids_[i];
+      }
+      if (keys_[i] == nullptr) {
+        return -1;
+      }
+    }
+  }
+
+  /// Insert `key` with `id`, `key` must not be present yet
+  void insert(SEXP key, int id) {
+    if (2 * (size_ + 1) > keys_.size()) {
+      rehash(static_cast<R_xlen_t>(keys_.size()));
+    }
+    size_t i = hash_pointer(key) & mask_;
+    while (keys_[i] != nullptr) {
+      i = (i + 1) & mask_;
+    }
+    keys_[i] = key;
+    ids_[i] = id;
+    ++size_;
+  }
+
+ private:
+  std::vector<SEXP> keys_;
+  std::vector<int> ids_;
+  size_t mask_ = 0;
+  size_t size_ = 0;
+
+  void rehash(R_xlen_t capacity_hint) {
+    size_t n = 16;
+    while (n < 2 * static_cast<size_t>(capacity_hint)) {
+      n *= 2;
+    }
+
+    std::vector<SEXP> keys(n, nullptr);
+    std::vector<int> ids(n);
+    keys.swap(keys_);
+    ids.swap(ids_);
+    mask_ = n - 1;
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (keys[i] != nullptr) {
+        size_t j = hash_pointer(keys[i]) & mask_;
+        while (keys_[j] != nullptr) {
+          j = (j + 1) & mask_;
+        }
+        keys_[j] = keys[i];
+        ids_[j] = ids[i];
+      }
+    }
+  }
+};
+
+/// The `CHARSXP` R would use for `x` once translated to UTF-8.
+///
+/// SAFETY: Keep as a pure C function. Call like an R API function, i.e. wrap in `safe[]`
+/// as required.
+inline SEXP r_char_utf8(SEXP x) {
+  if (Rf_getCharCE(x) == CE_UTF8) {
+    return x;
+  }
+  return Rf_mkCharCE(Rf_translateCharUTF8(x), CE_UTF8);
+}
+
+/// Maps strings to 1-based factor codes, collecting levels in order of first appearance.
+class level_index {
+ public:
+  explicit level_index(R_xlen_t capacity_hint = 0) : table_(capacity_hint) {}
+
+  int code(SEXP x) {
+    if (__builtin_expect(x == NA_STRING, 0)) {
+      return NA_INTEGER;
+    }
+
+    int id = table_.find(x);
+    if (__builtin_expect(id >= 0, 1)) {
+      return id;
+    }
+
+    // Only reached once per distinct pointer. The same text in another encoding has a
+    // different `CHARSXP`, so we register it as an alias of its UTF-8 spelling.
+    SEXP utf8 = safe[r_char_utf8](x);
+    if (utf8 != x) {
+      id = table_.find(utf8);
+      if (id >= 0) {
+        table_.insert(x, id);
+        return id;
+      }
+    }
+
+    levels_.push_back(utf8);
+    id = static_cast<int>(levels_.size());
+    table_.insert(utf8, id);
+    if (utf8 != x) {
+      table_.insert(x, id);
+    }
+    return id;
+  }
+
+  R_xlen_t size() const noexcept { return levels_.size(); }
+
+  const writable::strings& levels() const noexcept { return levels_; }
+
+  /// Sort the levels in C locale (byte) order and recode `codes` to match.
+  void sort(int* codes, R_xlen_t n) {
+    const R_xlen_t n_levels = levels_.size();
+    SEXP levels = levels_.data();
+
+    std::vector<int> order(n_levels);
+    for (R_xlen_t i = 0; i < n_levels; ++i) {
+      order[i] = static_cast<int>(i);
+    }
+    std::sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+      return std::strcmp(CHAR(STRING_ELT(levels, lhs)), CHAR(STRING_ELT(levels, rhs))) <
+             0;
+    });
+
+    // `recode[old]` is the new 1-based code of the old 1-based code `old`
+    std::vector<int> recode(n_levels + 1);
+    writable::strings sorted(n_levels);
+    for (R_xlen_t i = 0; i < n_levels; ++i) {
+      recode[order[i] + 1] = static_cast<int>(i + 1);
+      SET_STRING_ELT(sorted.data(), i, STRING_ELT(levels, order[i]));
+    }
+
+    for (R_xlen_t i = 0; i < n; ++i) {
+      if (codes[i] != NA_INTEGER) {
+        codes[i] = recode[codes[i]];
+      }
+    }
+
+    // Aliases are keyed by pointer, so rebuild the table for the new codes
+    table_ = charsxp_table(n_levels);
+    for (R_xlen_t i = 0; i < n_levels; ++i) {
+      table_.insert(STRING_ELT(sorted.data(), i), static_cast<int>(i + 1));
+    }
+    levels_ = std::move(sorted);
+  }
+
+ private:
+  charsxp_table table_;
+  writable::strings levels_;
+};
+
+}  // namespace detail
+
+namespace writable {
+class factor;
+}  // namespace writable
+
+/// Read only access to an R factor, i.e. integer codes with a `levels` attribute
+class factor : public integers {
+ public:
+  /// A code together with its level, `NA_STRING` for missing codes
+  struct element {
+    int code;
+    SEXP level;
+
+    bool is_na() const noexcept { return code == NA_INTEGER; }
+  };
+
+  class const_iterator {
+   private:
+    const factor* data_;
+    R_xlen_t pos_;
+
+   public:
+    using difference_type = ptrdiff_t;
+    using value_type = element;
+    using pointer = element*;
+    using reference = element&;
+    using iterator_category = std::forward_iterator_tag;
+
+    const_iterator(const factor* data, R_xlen_t pos) noexcept : data_(data), pos_(pos) {}
+
+    const_iterator& operator++() noexcept {
+      ++pos_;
+      return *this;
+    }
+
+    bool operator!=(const const_iterator& other) const noexcept {
+      return pos_ != other.pos_;
+    }
+    bool operator==(const const_iterator& other) const noexcept {
+      return pos_ == other.pos_;
+    }
+
+    element operator*() const { return data_->element_at(pos_); }
+  };
+
+  factor(SEXP data)
+      : integers(valid_factor(data)),
+        levels_(Rf_getAttrib(data, R_LevelsSymbol)),
+        levels_p_(STRING_PTR_RO(levels_.data())),
+        n_levels_(levels_.size()) {}
+
+  factor(const writable::factor& data);
+
+  strings levels() const noexcept { return levels_; }
+  R_xlen_t nlevels() const noexcept { return n_levels_; }
+  bool ordered() const noexcept { return Rf_inherits(data(), "ordered"); }
+
+  /// The level of the element at `pos`, `NA_STRING` if it is missing
+  r_string level(R_xlen_t pos) const { return element_at(pos).level; }
+
+  const_iterator begin() const noexcept { return const_iterator(this, 0); }
+  const_iterator end() const noexcept { return const_iterator(this, size()); }
+
+ private:
+  strings levels_;
+  const SEXP* levels_p_;
+  R_xlen_t n_levels_;
+
+  element element_at(R_xlen_t pos) const {
+    const int code = integers::operator[](pos);
+    // Out of range codes only occur in malformed factors, treat them as missing
+    if (__builtin_expect(code == NA_INTEGER || code < 1 || code > n_levels_, 0)) {
+      return {code, NA_STRING};
+    }
+    return {code, levels_p_[code - 1]};
+  }
+
+  static SEXP valid_factor(SEXP x) {
+    if (x == nullptr || detail::r_typeof(x) != INTSXP || !Rf_inherits(x, "factor")) {
+      throw std::invalid_argument("Invalid input type, expected 'factor'");
+    }
+    SEXP levels = Rf_getAttrib(x, R_LevelsSymbol);
+    if (detail::r_typeof(levels) != STRSXP) {
+      throw type_error(STRSXP, detail::r_typeof(levels));
+    }
+    return x;
+  }
+};
+
+namespace writable {
+
+/// A factor under construction. Levels are added in order of first appearance as
+/// values are pushed, and are only attached to the codes when converting to `SEXP`.
+class factor {
+ public:
+  factor() = default;
+
+  /// Encode `x`, see `as_factor()`
+  explicit factor(const cpp4r::strings& x, bool sorted = false)
+      : codes_(x.size()), index_(x.size() > 1024 ? 1024 : x.size()) {
+    const R_xlen_t n = x.size();
+    int* codes = INTEGER(codes_.data());
+    SEXP data = x.data();
+
+    if (__builtin_expect(!x.is_altrep(), 1)) {
+      const SEXP* p = STRING_PTR_RO(data);
+      for (R_xlen_t i = 0; i < n; ++i) {
+        codes[i] = index_.code(p[i]);
+      }
+    } else {
+      for (R_xlen_t i = 0; i < n; ++i) {
+        codes[i] = index_.code(STRING_ELT(data, i));
+      }
+    }
+
+    if (sorted) {
+      index_.sort(codes, n);
+    }
+  }
+
+  /// Wrap existing 1-based `codes` of the given `levels`
+  factor(writable::integers codes, const cpp4r::strings& levels)
+      : codes_(std::move(codes)), index_(levels.size()) {
+    for (R_xlen_t i = 0; i < levels.size(); ++i) {
+      if (index_.code(STRING_ELT(levels.data(), i)) != i + 1) {
+        throw std::invalid_argument("Factor levels must be unique and not missing");
+      }
+    }
+  }
+
+  void push_back(r_string value) { codes_.push_back(index_.code(value)); }
+
+  void reserve(R_xlen_t new_capacity) { codes_.reserve(new_capacity); }
+
+  R_xlen_t size() const noexcept { return codes_.size(); }
+  R_xlen_t nlevels() const noexcept { return index_.size(); }
+
+  /// Reorder the levels alphabetically (C locale) and recode the values
+  void sort_levels() { index_.sort(INTEGER(codes_.data()), codes_.size()); }
+
+  operator SEXP() const {
+    codes_.attr(R_LevelsSymbol) = index_.levels();
+    codes_.attr(R_ClassSymbol) = "factor";
+    return codes_;
+  }
+
+ private:
+  writable::integers codes_;
+  detail::level_index index_;
+};
+
+}  // namespace writable
+
+inline factor::factor(const writable::factor& data) : factor(static_cast<SEXP>(data)) {}
+
+/// Convert a character vector to a factor in a single hashing pass over the values.
+///
+/// Strings are keyed on their `CHARSXP` pointer rather than their contents. Levels are
+/// in order of first appearance, or in C locale (byte) order if `sorted` is true, which
+/// may differ from `base::factor()` under other collations. `NA` never becomes a level.
+inline factor as_factor(SEXP x, bool sorted = false) {
+  SEXPTYPE x_type = detail::r_typeof(x);
+  if (__builtin_expect(x_type == INTSXP && Rf_inherits(x, "factor"), 0)) {
+    return factor(x);
+  }
+  if (__builtin_expect(x_type != STRSXP, 0)) {
+    throw type_error(STRSXP, x_type);
+  }
+  return writable::factor(strings(x), sorted);
+}
+
+}  // namespace cpp4r
@@ -2,18 +2,51 @@
 
 #include <cstring>  // for std::strcmp (@pachadotdev use std qualifiers)
 
-#include <cstdio>   // for snprintf
-#include <string>   // for string, basic_string
-#include <utility>  // for forward
+#include <cstdio>            // for snprintf
+#include <initializer_list>  // for initializer_list
+#include <stdexcept>         // for out_of_range
+#include <string>            // for string, basic_string, to_string
+#include <unordered_map>     // for unordered_map
+#include <utility>           // for forward
+#include <vector>            // for vector
 
 #include "cpp4r/R.hpp"          // for SEXP, SEXPREC, CDR, Rf_install, SETCAR
 #include "cpp4r/as.hpp"         // for as_sexp
 #include "cpp4r/named_arg.hpp"  // for named_arg
 #include "cpp4r/protect.hpp"    // for protect, protect::function, safe
 #include "cpp4r/sexp.hpp"       // for sexp
+#include "cpp4r/symbol.hpp"     // for symbol
 
 namespace cpp4r {
 
+namespace detail {
+
+// Base case, just return
+inline void construct_call(SEXP val) noexcept {}
+
+template <typename T, typename... Args>
+inline void construct_call(SEXP val, const T& arg, Args&&... args);
+
+template <typename... Args>
+inline void construct_call(SEXP val, const named_arg& arg, Args&&... args) {
+  SETCAR(val, arg.value());
+  SET_TAG(val, arg.tag());
+  val = CDR(val);
+  construct_call(val, std::forward<Args>(args)...);
+}
+
+// Construct the call recursively, each iteration adds an Arg to the pairlist.
+template <typename T, typename... Args>
+inline void construct_call(SEXP val, const T& arg, Args&&... args) {
+  SETCAR(val, as_sexp(arg));
+  val = CDR(val);
+  construct_call(val, std::forward<Args>(args)...);
+}
+
+}  // namespace detail
+
+class prepared_call;
+
 class function {
  public:
   inline function(SEXP data) noexcept : data_(data) {}
@@ -25,53 +58,195 @@ class function {
 
     sexp call(safe[Rf_allocVector](LANGSXP, num_args));
 
-    construct_call(call, data_, std::forward<Args>(args)...);
+    detail::construct_call(call, data_, std::forward<Args>(args)...);
 
     return safe[Rf_eval](call, R_GlobalEnv);
   }
 
  private:
+  friend class prepared_call;
+
   sexp data_;
+};
 
+/// A call to an R function built once and evaluated many times, for callbacks in tight
+/// loops such as the objective of an optimizer.
+///
+/// The call is allocated and protected on construction. Arguments are slots that can be
+/// replaced with `set_arg()`, or kept as they are and overwritten in place: pass a
+/// preallocated `writable::doubles` and write new values into it before each call.
+/// `operator()` then evaluates the call in `env()` without allocating anything beyond
+/// what the callee allocates. The callee must not keep a reference to an argument
+/// that is overwritten in place.
+class prepared_call {
+ public:
   template <typename... Args>
-  inline void construct_call(SEXP val, const named_arg& arg, Args&&... args) const {
-    SETCAR(val, arg.value());
-    SET_TAG(val, safe[Rf_install](arg.name()));
-    val = CDR(val);
-    construct_call(val, std::forward<Args>(args)...);
+  explicit prepared_call(const function& fn, Args&&... args)
+      : prepared_call(static_cast<SEXP>(fn.data_), std::forward<Args>(args)...) {}
+
+  /// `fn` is a function, or a symbol looked up in `env()` on every call
+  template <typename... Args>
+  explicit prepared_call(SEXP fn, Args&&... args)
+      : call_(safe[Rf_allocVector](LANGSXP, sizeof...(args) + 1)),
+        result_(safe[Rf_allocVector](VECSXP, 1)) {
+    SETCAR(call_, fn);
+    detail::construct_call(CDR(call_), std::forward<Args>(args)...);
+    slots_.reserve(sizeof...(args));
+    for (SEXP cell = CDR(call_); cell != R_NilValue; cell = CDR(cell)) {
+      slots_.push_back(cell);
+    }
+  }
+
+  /// Evaluate the call. The result stays protected until the next evaluation.
+  SEXP operator()() const {
+    SEXP out = safe[Rf_eval](call_, env_);
+    SET_VECTOR_ELT(result_, 0, out);
+    return out;
   }
 
-  // Construct the call recursively, each iteration adds an Arg to the pairlist.
-  template <typename T, typename... Args>
-  inline void construct_call(SEXP val, const T& arg, Args&&... args) const {
-    SETCAR(val, as_sexp(arg));
-    val = CDR(val);
-    construct_call(val, std::forward<Args>(args)...);
+  /// The number of arguments
+  R_xlen_t size() const noexcept { return slots_.size(); }
+
+  SEXP arg(R_xlen_t i) const { return CAR(slot(i)); }
+
+  /// Replace argument `i`, which is protected by the call from then on
+  void set_arg(R_xlen_t i, SEXP value) { SETCAR(slot(i), value); }
+
+  /// The environment the call is evaluated in, the global environment by default
+  SEXP env() const noexcept { return env_; }
+  prepared_call& set_env(SEXP env) {
+    env_ = env;
+    return *this;
   }
 
-  // Base case, just return
-  inline void construct_call(SEXP val) const noexcept {}
+  SEXP call() const noexcept { return call_; }
+
+ private:
+  SEXP slot(R_xlen_t i) const {
+    if (i < 0 || i >= size()) {
+      throw std::out_of_range("prepared_call: argument " + std::to_string(i) + " of " +
+                              std::to_string(size()));
+    }
+    return slots_[i];
+  }
+
+  sexp call_;
+  sexp result_;
+  sexp env_ = R_GlobalEnv;
+  std::vector<SEXP> slots_;
 };
 
+namespace detail {
+
+/// The namespaces and functions resolved by `package`, each protected once with
+/// `R_PreserveObject()` until `package::invalidate()`. Functions are keyed by their
+/// namespace and symbol, which R never collects.
+struct package_cache {
+  std::unordered_map<std::string, SEXP> namespaces;
+  std::unordered_map<SEXP, std::unordered_map<SEXP, SEXP>> functions;
+
+  static package_cache& get() {
+    static package_cache cache;
+    return cache;
+  }
+};
+
+}  // namespace detail
+
+/// The functions of an R package.
+///
+/// Namespaces and functions are looked up once per process and cached, so
+/// `package("stats")["qnorm"]` in a loop costs a hash lookup rather than a search of
+/// the namespace registry and environments. Call `invalidate()` after reloading a
+/// namespace during development, e.g. with `pkgload::load_all()`.
 class package {
  public:
   inline package(const char* name) : data_(get_namespace(name)) {}
   inline package(const std::string& name) : data_(get_namespace(name.c_str())) {}
   inline function operator[](const char* name) {
-    return safe[Rf_findFun](safe[Rf_install](name), data_);
+    return get_function(safe[Rf_install](name));
+  }
+  inline function operator[](const std::string& name) { return (*this)[name.c_str()]; }
+  inline function operator[](const symbol& name) { return get_function(name.data()); }
+
+  /// Resolve `names` now, e.g. in a package's init function, so later lookups only hit
+  /// the cache
+  inline void prefetch(std::initializer_list<const char*> names) {
+    for (const char* name : names) {
+      get_function(safe[Rf_install](name));
+    }
+  }
+
+  /// Drop the cached namespace of `name` and its functions
+  static inline void invalidate(const char* name) {
+    detail::package_cache& cache = detail::package_cache::get();
+    SEXP ns = std::strcmp(name, "base") == 0 ? R_BaseEnv : R_NilValue;
+    auto it = cache.namespaces.find(name);
+    if (it != cache.namespaces.end()) {
+      ns = it->second;
+      cache.namespaces.erase(it);
+      R_ReleaseObject(ns);
+    }
+    release_functions(cache.functions.find(ns));
+  }
+  static inline void invalidate(const std::string& name) { invalidate(name.c_str()); }
+
+  /// Drop all cached namespaces and functions
+  static inline void invalidate() {
+    detail::package_cache& cache = detail::package_cache::get();
+    for (auto& ns : cache.namespaces) {
+      R_ReleaseObject(ns.second);
+    }
+    cache.namespaces.clear();
+    while (!cache.functions.empty()) {
+      release_functions(cache.functions.begin());
+    }
   }
-  inline function operator[](const std::string& name) { return operator[](name.c_str()); }
 
  private:
+  using function_map = std::unordered_map<SEXP, std::unordered_map<SEXP, SEXP>>;
+
   static inline SEXP get_namespace(const char* name) {
     if (__builtin_expect(std::strcmp(name, "base") == 0, 1)) {
       return R_BaseEnv;
     }
+    detail::package_cache& cache = detail::package_cache::get();
+    auto it = cache.namespaces.find(name);
+    if (it != cache.namespaces.end()) {
+      return it->second;
+    }
     sexp name_sexp = safe[Rf_install](name);
-    return safe[detail::r_env_get](R_NamespaceRegistry, name_sexp);
+    SEXP ns = safe[detail::r_env_get](R_NamespaceRegistry, name_sexp);
+    R_PreserveObject(ns);
+    cache.namespaces.emplace(name, ns);
+    return ns;
+  }
+
+  inline SEXP get_function(SEXP name) {
+    std::unordered_map<SEXP, SEXP>& functions =
+        detail::package_cache::get().functions[data_];
+    auto it = functions.find(name);
+    if (it != functions.end()) {
+      return it->second;
+    }
+    SEXP fn = safe[Rf_findFun](name, data_);
+    R_PreserveObject(fn);
+    functions.emplace(name, fn);
+    return fn;
   }
 
-  // Either base env or in namespace registry, so no protection needed
+  static inline void release_functions(function_map::iterator it) {
+    function_map& functions = detail::package_cache::get().functions;
+    if (it == functions.end()) {
+      return;
+    }
+    for (auto& fn : it->second) {
+      R_ReleaseObject(fn.second);
+    }
+    functions.erase(it);
+  }
+
+  // Either base env or a namespace protected by the cache
   SEXP data_;
 };
 
@@ -110,12 +285,7 @@ inline void message(const char* fmt_arg) {
   std::string msg = fmt::format(fmt_arg);
   safe[detail::r_message](msg.c_str());
 #else
-  char buff[1024];
-  int msg;
-  msg = std::snprintf(buff, 1024, "%s", fmt_arg);
-  if (msg >= 0 && msg < 1024) {
-    safe[detail::r_message](buff);
-  }
+  safe[detail::r_message](fmt_arg);
 #endif
 }
 
@@ -130,6 +300,11 @@ void message(const char* fmt_arg, Args... args) {
   msg = std::snprintf(buff, 1024, fmt_arg, args...);
   if (msg >= 0 && msg < 1024) {
     safe[detail::r_message](buff);
+  } else if (msg >= 1024) {
+    // Too long for the stack buffer, so format again at the exact size
+    std::string long_msg(msg + 1, '\0');
+    std::snprintf(&long_msg[0], long_msg.size(), fmt_arg, args...);
+    safe[detail::r_message](long_msg.c_str());
   }
 #endif
 }
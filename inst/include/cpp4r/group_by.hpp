@@ -0,0 +1,582 @@
+#pragma once
+
+#include <limits.h>  // for INT_MAX
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint64_t
+
+#include <algorithm>  // for fill, min, max
+#include <cstring>    // for memcpy
+#include <stdexcept>  // for invalid_argument, length_error, out_of_range
+#include <string>     // for string
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include "R_ext/Arith.h"         // for NA_INTEGER, NA_REAL, R_IsNA, ISNAN
+#include "cpp4r/R.hpp"           // for SEXP, SEXPREC, INTEGER_RO, REAL_RO
+#include "cpp4r/data_frame.hpp"  // for data_frame
+#include "cpp4r/doubles.hpp"     // for doubles
+#include "cpp4r/factor.hpp"      // for level_index, hash_mix
+#include "cpp4r/integers.hpp"    // for integers
+#include "cpp4r/protect.hpp"     // for safe
+#include "cpp4r/r_string.hpp"    // for r_string
+#include "cpp4r/r_vector.hpp"    // for type_error
+#include "cpp4r/sexp.hpp"        // for sexp
+
+namespace cpp4r {
+
+namespace detail {
+
+/// Looks up a column of `df` by name, throwing if there is none
+inline SEXP find_column(const data_frame& df, const std::string& name) {
+  SEXP col = df[r_string(name)];
+  if (col == R_NilValue) {
+    throw std::out_of_range("Unknown column '" + name + "'");
+  }
+  return col;
+}
+
+/// Bits of `x` with all zeros, all `NA` and all `NaN` values folded together, so that
+/// doubles which R considers equal compare and hash equal.
+inline uint64_t double_key(double x) noexcept {
+  if (x == 0.) {
+    return 0;
+  }
+  if (ISNAN(x)) {
+    return R_IsNA(x) ? 0x7ff00000000007a2ULL : 0x7ff8000000000000ULL;
+  }
+  uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+/// The key columns of a data frame, normalized for hashing and equality.
+///
+/// Integer and logical columns are used in place. Strings and factors are recoded to
+/// integers through a dictionary per column, and two `key_columns` built with the same
+/// dictionaries can be compared to each other, which is what joins rely on.
+class key_columns {
+ public:
+  key_columns(const std::vector<SEXP>& columns, std::vector<level_index>& dictionaries,
+              R_xlen_t nrow)
+      : nrow_(nrow) {
+    columns_.reserve(columns.size());
+    codes_.reserve(columns.size());
+
+    for (size_t k = 0; k < columns.size(); ++k) {
+      SEXP x = columns[k];
+      if (Rf_xlength(x) != nrow) {
+        throw std::invalid_argument("Key columns must have the same length");
+      }
+
+      switch (detail::r_typeof(x)) {
+        case INTSXP:
+          if (Rf_inherits(x, "factor")) {
+            columns_.push_back({recode_factor(x, dictionaries[k]), nullptr});
+          } else {
+            columns_.push_back({detail::integer_ptr(x), nullptr});
+          }
+          break;
+        case LGLSXP:
+          columns_.push_back({detail::logical_ptr(x), nullptr});
+          break;
+        case REALSXP:
+          columns_.push_back({nullptr, detail::real_ptr(x)});
+          break;
+        case STRSXP:
+          columns_.push_back({recode_strings(x, dictionaries[k]), nullptr});
+          break;
+        default:
+          throw std::invalid_argument(
+              "Key columns must be integer, logical, double, character or factor");
+      }
+    }
+  }
+
+  key_columns(const key_columns&) = delete;
+  key_columns& operator=(const key_columns&) = delete;
+  key_columns(key_columns&&) = default;
+  key_columns& operator=(key_columns&&) = default;
+
+  R_xlen_t nrow() const noexcept { return nrow_; }
+
+  /// Whether column `k` holds doubles rather than integer codes
+  bool is_double(size_t k) const noexcept { return columns_[k].dbls != nullptr; }
+
+  size_t hash(R_xlen_t i) const noexcept {
+    uint64_t h = 0;
+    for (const column& col : columns_) {
+      uint64_t value = col.dbls == nullptr ? static_cast<uint64_t>(col.ints[i])
+                                           : double_key(col.dbls[i]);
+      h = hash_mix(h ^ (value + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2)));
+    }
+    return static_cast<size_t>(h);
+  }
+
+  /// Whether row `i` of `*this` and row `j` of `other` have the same key
+  bool equal(R_xlen_t i, const key_columns& other, R_xlen_t j) const noexcept {
+    for (size_t k = 0; k < columns_.size(); ++k) {
+      const column& lhs = columns_[k];
+      const column& rhs = other.columns_[k];
+      if (lhs.dbls == nullptr) {
+        if (lhs.ints[i] != rhs.ints[j]) {
+          return false;
+        }
+      } else if (double_key(lhs.dbls[i]) != double_key(rhs.dbls[j])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  struct column {
+    const int* ints;
+    const double* dbls;
+  };
+
+  R_xlen_t nrow_;
+  std::vector<column> columns_;
+  // Owns the codes of recoded columns, moving it keeps the buffers in place
+  std::vector<std::vector<int>> codes_;
+
+  const int* recode_strings(SEXP x, level_index& dictionary) {
+    codes_.emplace_back(nrow_);
+    int* codes = codes_.back().data();
+    if (__builtin_expect(!ALTREP(x), 1)) {
+      const SEXP* p = STRING_PTR_RO(x);
+      for (R_xlen_t i = 0; i < nrow_; ++i) {
+        codes[i] = dictionary.code(p[i]);
+      }
+    } else {
+      for (R_xlen_t i = 0; i < nrow_; ++i) {
+        codes[i] = dictionary.code(STRING_ELT(x, i));
+      }
+    }
+    return codes;
+  }
+
+  const int* recode_factor(SEXP x, level_index& dictionary) {
+    SEXP levels = Rf_getAttrib(x, R_LevelsSymbol);
+    const R_xlen_t n_levels = Rf_xlength(levels);
+    std::vector<int> recode(n_levels + 1, NA_INTEGER);
+    for (R_xlen_t i = 0; i < n_levels; ++i) {
+      recode[i + 1] = dictionary.code(STRING_ELT(levels, i));
+    }
+
+    codes_.emplace_back(nrow_);
+    int* codes = codes_.back().data();
+    const int* p = detail::integer_ptr(x);
+    for (R_xlen_t i = 0; i < nrow_; ++i) {
+      codes[i] = p[i] >= 1 && p[i] <= n_levels ? recode[p[i]] : NA_INTEGER;
+    }
+    return codes;
+  }
+};
+
+/// Open addressing table from keys to the first row holding them. Rows are compared
+/// through a callback so the table itself never touches the key columns.
+class row_table {
+ public:
+  explicit row_table(R_xlen_t capacity_hint = 0) { reset(capacity_hint); }
+
+  /// Empty the table, sizing it for `capacity_hint` distinct keys
+  void reset(R_xlen_t capacity_hint) {
+    size_t n = 16;
+    while (n < 2 * static_cast<size_t>(capacity_hint)) {
+      n *= 2;
+    }
+    slots_.assign(n, slot{-1, 0, 0});
+    mask_ = n - 1;
+    size_ = 0;
+  }
+
+  /// The id stored for a row with this `hash` accepted by `equal`, or -1 if absent
+  template <typename Equal>
+  int find(size_t hash, Equal&& equal) const {
+    for (size_t i = hash & mask_;; i = (i + 1) & mask_) {
+      const slot& s = slots_[i];
+      if (s.row < 0) {
+        return -1;
+      }
+      if (s.hash == hash && equal(s.row)) {
+        return s.id;
+      }
+    }
+  }
+
+  /// The id stored for the key of `row`, inserting `row` with `id` if absent
+  template <typename Equal>
+  int find_or_insert(R_xlen_t row, size_t hash, int id, Equal&& equal) {
+    if (2 * (size_ + 1) > slots_.size()) {
+      grow();
+    }
+    size_t i = hash & mask_;
+    for (;; i = (i + 1) & mask_) {
+      slot& s = slots_[i];
+      if (s.row < 0) {
+        break;
+      }
+      if (s.hash == hash && equal(s.row)) {
+        return s.id;
+      }
+    }
+    slots_[i] = slot{row, hash, id};
+    ++size_;
+    return id;
+  }
+
+ private:
+  struct slot {
+    R_xlen_t row;
+    size_t hash;
+    int id;
+  };
+
+  std::vector<slot> slots_;
+  size_t mask_ = 0;
+  size_t size_ = 0;
+
+  void grow() {
+    std::vector<slot> old(2 * slots_.size(), slot{-1, 0, 0});
+    old.swap(slots_);
+    mask_ = slots_.size() - 1;
+    for (const slot& s : old) {
+      if (s.row >= 0) {
+        size_t i = s.hash & mask_;
+        while (slots_[i].row >= 0) {
+          i = (i + 1) & mask_;
+        }
+        slots_[i] = s;
+      }
+    }
+  }
+};
+
+}  // namespace detail
+
+/// Rows of a data frame grouped by the values of one or more key columns.
+///
+/// Groups are numbered from 1 in order of first appearance. The grouping only holds
+/// integer vectors, so it can be kept and reused for any number of reductions over
+/// columns of the same data frame.
+class grouping {
+ public:
+  /// Rows at which the input is split into radix partitions before hashing, so that
+  /// each partition's table stays in cache
+  static constexpr R_xlen_t partition_threshold = 1 << 20;
+
+  grouping(const data_frame& df, const std::vector<std::string>& keys)
+      : grouping(df.nrow(), key_sexps(df, keys)) {}
+
+  grouping(R_xlen_t nrow, const std::vector<SEXP>& keys)
+      : grouping(make_key_columns(nrow, keys)) {}
+
+  explicit grouping(const detail::key_columns& columns)
+      : nrow_(columns.nrow()), ids_(columns.nrow()) {
+    if (nrow_ > INT_MAX) {
+      throw std::length_error("Cannot group more than INT_MAX rows");
+    }
+
+    int* ids = INTEGER(ids_.data());
+    n_groups_ = nrow_ < partition_threshold ? hash_rows(columns, ids)
+                                            : hash_partitions(columns, ids);
+    index_groups(ids);
+  }
+
+  R_xlen_t nrow() const noexcept { return nrow_; }
+  int ngroups() const noexcept { return n_groups_; }
+
+  /// The 1-based group id of each row
+  integers ids() const noexcept { return ids_; }
+
+  /// The number of rows in each group
+  integers sizes() const noexcept { return sizes_; }
+
+  /// 1-based row indices, stably sorted by group
+  integers order() const noexcept { return order_; }
+
+  /// 0-based offsets into `order()` at which each group starts, with a final `nrow()`
+  integers starts() const noexcept { return starts_; }
+
+  /// The 1-based index of the first row of each group
+  writable::integers first_rows() const {
+    writable::integers out(n_groups_);
+    const int* order = INTEGER_RO(order_.data());
+    const int* starts = INTEGER_RO(starts_.data());
+    for (int g = 0; g < n_groups_; ++g) {
+      out[g] = order[starts[g]];
+    }
+    return out;
+  }
+
+  /// The number of rows of each group, as `sizes()` but writable
+  writable::integers count() const { return writable::integers(sizes_.data()); }
+
+  /// The sum of `x` over each group. Integer and logical inputs are summed as doubles,
+  /// so they never overflow. `NA` wins over `NaN`, which propagates unless `na_rm`.
+  writable::doubles sum(SEXP x, bool na_rm = false) const {
+    std::vector<double> acc(n_groups_, 0.);
+    std::vector<int> n;
+    std::vector<char> na;
+    reduce(x, na_rm, acc, n, na, [](double a, double v) { return a + v; });
+
+    writable::doubles out(n_groups_);
+    for (int g = 0; g < n_groups_; ++g) {
+      out[g] = na[g] ? NA_REAL : acc[g];
+    }
+    return out;
+  }
+
+  /// The mean of `x` over each group, `NaN` for groups without non-missing values
+  writable::doubles mean(SEXP x, bool na_rm = false) const {
+    std::vector<double> acc(n_groups_, 0.);
+    std::vector<int> n;
+    std::vector<char> na;
+    reduce(x, na_rm, acc, n, na, [](double a, double v) { return a + v; });
+
+    writable::doubles out(n_groups_);
+    for (int g = 0; g < n_groups_; ++g) {
+      out[g] = na[g] ? NA_REAL : acc[g] / n[g];
+    }
+    return out;
+  }
+
+  /// The minimum of `x` over each group, `NA` for groups without non-missing values
+  writable::doubles min(SEXP x, bool na_rm = false) const {
+    std::vector<double> acc(n_groups_, R_PosInf);
+    std::vector<int> n;
+    std::vector<char> na;
+    reduce(x, na_rm, acc, n, na,
+           [](double a, double v) { return v < a || ISNAN(v) ? v : a; });
+
+    writable::doubles out(n_groups_);
+    for (int g = 0; g < n_groups_; ++g) {
+      out[g] = na[g] || n[g] == 0 ? NA_REAL : acc[g];
+    }
+    return out;
+  }
+
+  /// The maximum of `x` over each group, `NA` for groups without non-missing values
+  writable::doubles max(SEXP x, bool na_rm = false) const {
+    std::vector<double> acc(n_groups_, R_NegInf);
+    std::vector<int> n;
+    std::vector<char> na;
+    reduce(x, na_rm, acc, n, na,
+           [](double a, double v) { return v > a || ISNAN(v) ? v : a; });
+
+    writable::doubles out(n_groups_);
+    for (int g = 0; g < n_groups_; ++g) {
+      out[g] = na[g] || n[g] == 0 ? NA_REAL : acc[g];
+    }
+    return out;
+  }
+
+  /// The value of `x` at the first row of each group, keeping the type and attributes
+  /// of `x` (e.g. factor levels)
+  SEXP first(SEXP x) const {
+    check_column(x);
+    const int* order = INTEGER_RO(order_.data());
+    const int* starts = INTEGER_RO(starts_.data());
+    SEXPTYPE type = detail::r_typeof(x);
+
+    sexp out = safe[Rf_allocVector](type, n_groups_);
+    for (int g = 0; g < n_groups_; ++g) {
+      R_xlen_t row = order[starts[g]] - 1;
+      switch (type) {
+        case LGLSXP:
+          LOGICAL(out)[g] = LOGICAL_ELT(x, row);
+          break;
+        case INTSXP:
+          INTEGER(out)[g] = INTEGER_ELT(x, row);
+          break;
+        case REALSXP:
+          REAL(out)[g] = REAL_ELT(x, row);
+          break;
+        case STRSXP:
+          SET_STRING_ELT(out, g, STRING_ELT(x, row));
+          break;
+        case VECSXP:
+          SET_VECTOR_ELT(out, g, VECTOR_ELT(x, row));
+          break;
+        default:
+          throw std::invalid_argument(
+              "`first()` requires a logical, integer, double, character or list column");
+      }
+    }
+    safe[Rf_copyMostAttrib](x, out);
+    return out;
+  }
+
+ private:
+  R_xlen_t nrow_;
+  int n_groups_ = 0;
+  writable::integers ids_;
+  writable::integers sizes_;
+  writable::integers order_;
+  writable::integers starts_;
+
+  static detail::key_columns make_key_columns(R_xlen_t nrow,
+                                              const std::vector<SEXP>& keys) {
+    std::vector<detail::level_index> dictionaries(keys.size());
+    return detail::key_columns(keys, dictionaries, nrow);
+  }
+
+  static std::vector<SEXP> key_sexps(const data_frame& df,
+                                     const std::vector<std::string>& keys) {
+    std::vector<SEXP> out;
+    out.reserve(keys.size());
+    for (const std::string& key : keys) {
+      out.push_back(detail::find_column(df, key));
+    }
+    return out;
+  }
+
+  // Assigns 1-based ids in order of first appearance, returns the number of groups
+  static int hash_rows(const detail::key_columns& columns, int* ids) {
+    const R_xlen_t n = columns.nrow();
+    detail::row_table table(n < 1024 ? n : 1024);
+    int n_groups = 0;
+    for (R_xlen_t i = 0; i < n; ++i) {
+      ids[i] = table.find_or_insert(i, columns.hash(i), n_groups + 1, [&](R_xlen_t j) {
+        return columns.equal(i, columns, j);
+      });
+      n_groups += ids[i] > n_groups;
+    }
+    return n_groups;
+  }
+
+  // As `hash_rows()`, but first scatters the rows into 256 partitions on the top bits of
+  // their hash. Each partition is hashed with its own small table, and the ids are then
+  // renumbered in order of first appearance.
+  static int hash_partitions(const detail::key_columns& columns, int* ids) {
+    const R_xlen_t n = columns.nrow();
+    const int shift = static_cast<int>(sizeof(size_t) * 8 - 8);
+
+    std::vector<size_t> hashes(n);
+    std::vector<R_xlen_t> offsets(257, 0);
+    for (R_xlen_t i = 0; i < n; ++i) {
+      hashes[i] = columns.hash(i);
+      ++offsets[(hashes[i] >> shift) + 1];
+    }
+    for (int p = 0; p < 256; ++p) {
+      offsets[p + 1] += offsets[p];
+    }
+
+    std::vector<R_xlen_t> rows(n);
+    std::vector<R_xlen_t> next(offsets.begin(), offsets.end() - 1);
+    for (R_xlen_t i = 0; i < n; ++i) {
+      rows[next[hashes[i] >> shift]++] = i;
+    }
+
+    int n_groups = 0;
+    detail::row_table table;
+    for (int p = 0; p < 256; ++p) {
+      table.reset(std::min<R_xlen_t>(offsets[p + 1] - offsets[p], 1024));
+      for (R_xlen_t k = offsets[p]; k < offsets[p + 1]; ++k) {
+        const R_xlen_t i = rows[k];
+        ids[i] = table.find_or_insert(i, hashes[i], n_groups + 1, [&](R_xlen_t j) {
+          return columns.equal(i, columns, j);
+        });
+        n_groups += ids[i] > n_groups;
+      }
+    }
+
+    std::vector<int> renumber(n_groups + 1, 0);
+    int next_id = 0;
+    for (R_xlen_t i = 0; i < n; ++i) {
+      int& id = renumber[ids[i]];
+      if (id == 0) {
+        id = ++next_id;
+      }
+      ids[i] = id;
+    }
+    return n_groups;
+  }
+
+  // Counting sort of the rows by group
+  void index_groups(const int* ids) {
+    sizes_ = writable::integers(static_cast<R_xlen_t>(n_groups_));
+    starts_ = writable::integers(static_cast<R_xlen_t>(n_groups_) + 1);
+    order_ = writable::integers(nrow_);
+    int* sizes = INTEGER(sizes_.data());
+    int* starts = INTEGER(starts_.data());
+    int* order = INTEGER(order_.data());
+
+    std::fill(sizes, sizes + n_groups_, 0);
+    for (R_xlen_t i = 0; i < nrow_; ++i) {
+      ++sizes[ids[i] - 1];
+    }
+    starts[0] = 0;
+    for (int g = 0; g < n_groups_; ++g) {
+      starts[g + 1] = starts[g] + sizes[g];
+    }
+
+    std::vector<int> next(starts, starts + n_groups_);
+    for (R_xlen_t i = 0; i < nrow_; ++i) {
+      order[next[ids[i] - 1]++] = static_cast<int>(i + 1);
+    }
+  }
+
+  void check_column(SEXP x) const {
+    if (Rf_xlength(x) != nrow_) {
+      throw std::invalid_argument("Column length must match the number of grouped rows");
+    }
+  }
+
+  // One sequential pass over `x`, folding each non-missing value into the accumulator of
+  // its group. `n` receives the number of values folded per group and `na` whether a
+  // missing value was seen (always false when `na_rm` is true). Only `NA` is missing:
+  // `NaN` is folded like any other value, unless `na_rm` drops it as `base::sum()` does.
+  template <typename F>
+  void reduce(SEXP x, bool na_rm, std::vector<double>& acc, std::vector<int>& n,
+              std::vector<char>& na, F f) const {
+    check_column(x);
+    n.assign(n_groups_, 0);
+    na.assign(n_groups_, 0);
+    // Factor codes are integers, but not numbers to be summed or compared
+    if (Rf_inherits(x, "factor")) {
+      throw type_error(REALSXP, detail::r_typeof(x));
+    }
+    const int* ids = INTEGER_RO(ids_.data());
+
+    switch (detail::r_typeof(x)) {
+      case REALSXP: {
+        const double* p = detail::real_ptr(x);
+        for (R_xlen_t i = 0; i < nrow_; ++i) {
+          const int g = ids[i] - 1;
+          if (__builtin_expect(ISNAN(p[i]), 0) && (na_rm || R_IsNA(p[i]))) {
+            na[g] |= !na_rm;
+            continue;
+          }
+          acc[g] = f(acc[g], p[i]);
+          ++n[g];
+        }
+        break;
+      }
+      case INTSXP:
+      case LGLSXP: {
+        const int* p = detail::r_typeof(x) == INTSXP ? detail::integer_ptr(x)
+                                                           : detail::logical_ptr(x);
+        for (R_xlen_t i = 0; i < nrow_; ++i) {
+          const int g = ids[i] - 1;
+          if (__builtin_expect(p[i] == NA_INTEGER, 0)) {
+            na[g] |= !na_rm;
+            continue;
+          }
+          acc[g] = f(acc[g], static_cast<double>(p[i]));
+          ++n[g];
+        }
+        break;
+      }
+      default:
+        throw type_error(REALSXP, detail::r_typeof(x));
+    }
+  }
+};
+
+/// Group the rows of `df` by the columns named in `keys`
+inline grouping group_by(const data_frame& df, const std::vector<std::string>& keys) {
+  return grouping(df, keys);
+}
+
+}  // namespace cpp4r
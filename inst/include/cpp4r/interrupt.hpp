@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>  // for atomic
+#include <chrono>  // for steady_clock, milliseconds
+#include <thread>  // for this_thread, thread::id
+
+#include "cpp4r/R.hpp"        // for SEXP, SEXPREC, R_ToplevelExec, Rf_lang2
+#include "cpp4r/protect.hpp"  // for safe, R_CheckUserInterrupt
+
+namespace cpp4r {
+
+namespace detail {
+
+inline void check_interrupt(void*) { R_CheckUserInterrupt(); }
+
+// Signal an `interrupt` condition and return to the top level, like an interrupt R
+// handles itself
+//
+// - Pure C, so call with `safe[]`
+inline void r_interrupt() {
+  SEXP cond = PROTECT(Rf_allocVector(VECSXP, 0));
+  SEXP cls = PROTECT(Rf_allocVector(STRSXP, 2));
+  SET_STRING_ELT(cls, 0, Rf_mkChar("interrupt"));
+  SET_STRING_ELT(cls, 1, Rf_mkChar("condition"));
+  Rf_setAttrib(cond, R_ClassSymbol, cls);
+
+  SEXP signal = PROTECT(Rf_lang2(Rf_install("signalCondition"), cond));
+  Rf_eval(signal, R_BaseEnv);
+
+  SEXP abort = PROTECT(Rf_lang2(Rf_install("invokeRestart"), Rf_mkString("abort")));
+  Rf_eval(abort, R_BaseEnv);
+
+  UNPROTECT(4);
+}
+
+}  // namespace detail
+
+/// Interrupt checks for long loops, including parallel ones.
+///
+/// `check()` on the thread that created the checker, which must be the R main thread,
+/// polls R for a user interrupt at most every `interval_ms` milliseconds, and only
+/// reads the clock every `stride` calls. The poll runs in `R_ToplevelExec()`, so an
+/// interrupt sets the cancellation flag instead of jumping out of the loop. Worker
+/// threads poll the flag with `cancelled()` or `check()`, which never call R off the
+/// main thread. Once the workers have joined, `unwind_if_interrupted()` turns the
+/// interrupt into a regular R interrupt.
+class interrupt_checker {
+ public:
+  explicit interrupt_checker(int interval_ms = 100, int stride = 1)
+      : interval_(interval_ms),
+        stride_(stride > 0 ? stride : 1),
+        last_(clock::now()),
+        owner_(std::this_thread::get_id()) {}
+
+  interrupt_checker(const interrupt_checker&) = delete;
+  interrupt_checker& operator=(const interrupt_checker&) = delete;
+
+  /// Whether the work is cancelled, after polling R for an interrupt if called on the
+  /// main thread and a poll is due
+  bool check() {
+    if (cancelled() || std::this_thread::get_id() != owner_ || ++calls_ < stride_) {
+      return cancelled();
+    }
+    calls_ = 0;
+    const clock::time_point now = clock::now();
+    if (now - last_ < interval_) {
+      return false;
+    }
+    last_ = now;
+    if (!R_ToplevelExec(detail::check_interrupt, nullptr)) {
+      interrupted_ = true;
+      cancel();
+    }
+    return cancelled();
+  }
+
+  bool cancelled() const noexcept { return cancelled_.load(std::memory_order_relaxed); }
+
+  /// Cancel the work without an interrupt, e.g. from a worker that failed
+  void cancel() noexcept { cancelled_.store(true, std::memory_order_relaxed); }
+
+  /// Whether the user interrupted
+  bool interrupted() const noexcept { return interrupted_; }
+
+  /// The cancellation flag, for workers that only take a `std::atomic<bool>`
+  std::atomic<bool>& flag() noexcept { return cancelled_; }
+
+  /// Unwind to R as an interrupt if the user interrupted. Call on the main thread once
+  /// the workers have joined.
+  void unwind_if_interrupted() {
+    if (interrupted_) {
+      interrupted_ = false;
+      safe[detail::r_interrupt]();
+    }
+  }
+
+ private:
+  using clock = std::chrono::steady_clock;
+
+  std::atomic<bool> cancelled_{false};
+  bool interrupted_ = false;
+  const std::chrono::milliseconds interval_;
+  const int stride_;
+  int calls_ = 0;
+  clock::time_point last_;
+  const std::thread::id owner_;
+};
+
+}  // namespace cpp4r
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <limits.h>  // for INT_MAX
+
+#include <stdexcept>  // for invalid_argument, length_error
+#include <string>     // for string
+#include <utility>    // for pair
+#include <vector>     // for vector
+
+#include "R_ext/Arith.h"         // for NA_INTEGER, NA_REAL
+#include "cpp4r/R.hpp"           // for SEXP, SEXPREC, INTEGER_RO, Rf_coerceVector
+#include "cpp4r/data_frame.hpp"  // for data_frame
+#include "cpp4r/factor.hpp"      // for level_index
+#include "cpp4r/group_by.hpp"    // for grouping, key_columns, row_table
+#include "cpp4r/integers.hpp"    // for integers
+#include "cpp4r/list.hpp"        // for list
+#include "cpp4r/protect.hpp"     // for safe
+#include "cpp4r/sexp.hpp"        // for sexp
+#include "cpp4r/strings.hpp"     // for strings
+
+namespace cpp4r {
+
+enum class join_type { inner, left, semi, anti };
+
+namespace detail {
+
+enum class key_kind { code, integer, real };
+
+inline key_kind join_key_kind(SEXP x) {
+  switch (detail::r_typeof(x)) {
+    case STRSXP:
+      return key_kind::code;
+    case INTSXP:
+      return Rf_inherits(x, "factor") ? key_kind::code : key_kind::integer;
+    case REALSXP:
+      return key_kind::real;
+    default:
+      return key_kind::integer;
+  }
+}
+
+/// The `keys` of `left` and `right`, with integer keys promoted to double where the
+/// other side is double. Coerced columns are kept alive in `protect`.
+inline void join_key_columns(const data_frame& left, const data_frame& right,
+                             const std::vector<std::string>& keys,
+                             std::vector<SEXP>& left_keys, std::vector<SEXP>& right_keys,
+                             std::vector<sexp>& protect) {
+  for (const std::string& key : keys) {
+    SEXP l = find_column(left, key);
+    SEXP r = find_column(right, key);
+    key_kind l_kind = join_key_kind(l);
+    key_kind r_kind = join_key_kind(r);
+
+    if (l_kind != r_kind) {
+      if (l_kind == key_kind::code || r_kind == key_kind::code) {
+        throw std::invalid_argument("Can't join on '" + key +
+                                    "' because of incompatible types");
+      }
+      if (l_kind == key_kind::integer) {
+        protect.emplace_back(safe[Rf_coerceVector](l, REALSXP));
+        l = protect.back();
+      } else {
+        protect.emplace_back(safe[Rf_coerceVector](r, REALSXP));
+        r = protect.back();
+      }
+    }
+
+    left_keys.push_back(l);
+    right_keys.push_back(r);
+  }
+}
+
+/// `x[index]` for 1-based `index`, where `NA_INTEGER` gives a missing value. Keeps the
+/// attributes of `x` other than names.
+inline SEXP gather(SEXP x, const int* index, R_xlen_t n) {
+  SEXPTYPE type = detail::r_typeof(x);
+  sexp out = safe[Rf_allocVector](type, n);
+
+  // Gathers are random reads into `x`, so fetch a few indices ahead
+  constexpr R_xlen_t lookahead = 16;
+
+  switch (type) {
+    case LGLSXP:
+    case INTSXP: {
+      const int* p = type == INTSXP ? detail::integer_ptr(x) : detail::logical_ptr(x);
+      int* o = type == INTSXP ? INTEGER(out) : LOGICAL(out);
+      for (R_xlen_t i = 0; i < n; ++i) {
+        if (i + lookahead < n && index[i + lookahead] != NA_INTEGER) {
+          __builtin_prefetch(p + index[i + lookahead] - 1);
+        }
+        o[i] = index[i] == NA_INTEGER ? NA_INTEGER : p[index[i] - 1];
+      }
+      break;
+    }
+    case REALSXP: {
+      const double* p = detail::real_ptr(x);
+      double* o = REAL(out);
+      for (R_xlen_t i = 0; i < n; ++i) {
+        if (i + lookahead < n && index[i + lookahead] != NA_INTEGER) {
+          __builtin_prefetch(p + index[i + lookahead] - 1);
+        }
+        o[i] = index[i] == NA_INTEGER ? NA_REAL : p[index[i] - 1];
+      }
+      break;
+    }
+    case STRSXP: {
+      const SEXP* p = detail::string_ptr(x);
+      for (R_xlen_t i = 0; i < n; ++i) {
+        if (i + lookahead < n && index[i + lookahead] != NA_INTEGER) {
+          __builtin_prefetch(p + index[i + lookahead] - 1);
+        }
+        SET_STRING_ELT(out, i, index[i] == NA_INTEGER ? NA_STRING : p[index[i] - 1]);
+      }
+      break;
+    }
+    case VECSXP: {
+      for (R_xlen_t i = 0; i < n; ++i) {
+        SET_VECTOR_ELT(out, i,
+                       index[i] == NA_INTEGER ? R_NilValue : VECTOR_ELT(x, index[i] - 1));
+      }
+      break;
+    }
+    default:
+      throw std::invalid_argument(
+          "Can only gather logical, integer, double, character or list columns");
+  }
+
+  safe[Rf_copyMostAttrib](x, out);
+  return out;
+}
+
+}  // namespace detail
+
+/// Matching rows of `left` and `right` on the columns named in `keys`.
+///
+/// Returns 1-based row indices into `left` and `right`, in the order of the rows of
+/// `left` and then of `right`. Unmatched rows of a left join have an `NA` right index.
+/// Semi and anti joins only return left indices, the right indices are empty.
+///
+/// The hash table is built over the distinct keys of the smaller input. The probing
+/// and output passes run in parallel when compiled with OpenMP.
+inline std::pair<integers, integers> join_indices(const data_frame& left,
+                                                  const data_frame& right,
+                                                  const std::vector<std::string>& keys,
+                                                  join_type type = join_type::inner) {
+  if (keys.empty()) {
+    throw std::invalid_argument("Joins need at least one key");
+  }
+
+  std::vector<SEXP> left_sexps;
+  std::vector<SEXP> right_sexps;
+  std::vector<sexp> protect;
+  detail::join_key_columns(left, right, keys, left_sexps, right_sexps, protect);
+
+  // Shared dictionaries give equal strings the same code on both sides
+  std::vector<detail::level_index> dictionaries(keys.size());
+  detail::key_columns left_keys(left_sexps, dictionaries, left.nrow());
+  detail::key_columns right_keys(right_sexps, dictionaries, right.nrow());
+
+  const R_xlen_t n_left = left_keys.nrow();
+  const R_xlen_t n_right = right_keys.nrow();
+  const bool build_left = n_left < n_right;
+  const detail::key_columns& build_keys = build_left ? left_keys : right_keys;
+  const detail::key_columns& probe_keys = build_left ? right_keys : left_keys;
+  const R_xlen_t n_probe = probe_keys.nrow();
+
+  grouping groups(build_keys);
+  const int n_groups = groups.ngroups();
+  const int* build_order = INTEGER_RO(groups.order().data());
+  const int* build_starts = INTEGER_RO(groups.starts().data());
+
+  detail::row_table table(n_groups);
+  for (int g = 0; g < n_groups; ++g) {
+    R_xlen_t row = build_order[build_starts[g]] - 1;
+    table.find_or_insert(row, build_keys.hash(row), g, [](R_xlen_t) { return false; });
+  }
+
+  // 0-based group of each probe row, -1 if it has no match
+  std::vector<int> probe_group(n_probe);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for (R_xlen_t i = 0; i < n_probe; ++i) {
+    probe_group[i] = table.find(probe_keys.hash(i), [&](R_xlen_t row) {
+      return build_keys.equal(row, probe_keys, i);
+    });
+  }
+
+  // For each left row, its group and the 1-based right rows matching that group
+  std::vector<int> left_group;
+  std::vector<int> match_rows;
+  std::vector<R_xlen_t> match_starts(static_cast<size_t>(n_groups) + 1, 0);
+  if (build_left) {
+    const int* ids = INTEGER_RO(groups.ids().data());
+    left_group.resize(n_left);
+    for (R_xlen_t i = 0; i < n_left; ++i) {
+      left_group[i] = ids[i] - 1;
+    }
+
+    // Counting sort of the right rows by the left group they match
+    for (R_xlen_t j = 0; j < n_right; ++j) {
+      if (probe_group[j] >= 0) {
+        ++match_starts[probe_group[j] + 1];
+      }
+    }
+    for (int g = 0; g < n_groups; ++g) {
+      match_starts[g + 1] += match_starts[g];
+    }
+    match_rows.resize(match_starts[n_groups]);
+    std::vector<R_xlen_t> next(match_starts.begin(), match_starts.end() - 1);
+    for (R_xlen_t j = 0; j < n_right; ++j) {
+      if (probe_group[j] >= 0) {
+        match_rows[next[probe_group[j]]++] = static_cast<int>(j + 1);
+      }
+    }
+  } else {
+    left_group.swap(probe_group);
+    match_rows.assign(build_order, build_order + n_right);
+    match_starts.assign(build_starts, build_starts + n_groups + 1);
+  }
+
+  // Number of output rows per left row, then their offsets
+  std::vector<R_xlen_t> offsets(static_cast<size_t>(n_left) + 1, 0);
+  for (R_xlen_t i = 0; i < n_left; ++i) {
+    const int g = left_group[i];
+    const R_xlen_t n_matches = g < 0 ? 0 : match_starts[g + 1] - match_starts[g];
+    R_xlen_t n_out = 0;
+    switch (type) {
+      case join_type::inner:
+        n_out = n_matches;
+        break;
+      case join_type::left:
+        n_out = n_matches == 0 ? 1 : n_matches;
+        break;
+      case join_type::semi:
+        n_out = n_matches > 0;
+        break;
+      case join_type::anti:
+        n_out = n_matches == 0;
+        break;
+    }
+    offsets[i + 1] = offsets[i] + n_out;
+  }
+
+  const R_xlen_t n_out = offsets[n_left];
+  if (n_out > INT_MAX) {
+    throw std::length_error("Join result has more than INT_MAX rows");
+  }
+
+  const bool has_right = type == join_type::inner || type == join_type::left;
+  writable::integers left_index(n_out);
+  writable::integers right_index(has_right ? n_out : 0);
+  int* l = INTEGER(left_index.data());
+  int* r = has_right ? INTEGER(right_index.data()) : nullptr;
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for (R_xlen_t i = 0; i < n_left; ++i) {
+    R_xlen_t k = offsets[i];
+    const R_xlen_t end = offsets[i + 1];
+    if (k == end) {
+      continue;
+    }
+
+    const int g = left_group[i];
+    if (!has_right) {
+      l[k] = static_cast<int>(i + 1);
+    } else if (g < 0 || match_starts[g] == match_starts[g + 1]) {
+      l[k] = static_cast<int>(i + 1);
+      r[k] = NA_INTEGER;
+    } else {
+      for (R_xlen_t m = match_starts[g]; k < end; ++k, ++m) {
+        l[k] = static_cast<int>(i + 1);
+        r[k] = match_rows[m];
+      }
+    }
+  }
+
+  return {left_index, right_index};
+}
+
+/// Build the joined data frame from the row indices returned by `join_indices()`.
+///
+/// The result has all columns of `left`, followed by the non key columns of `right` for
+/// inner and left joins. Other names found on both sides get the suffixes `.x` and `.y`.
+inline writable::data_frame join_gather(const data_frame& left, const data_frame& right,
+                                        const std::vector<std::string>& keys,
+                                        const std::pair<integers, integers>& indices,
+                                        join_type type = join_type::inner) {
+  const R_xlen_t n = indices.first.size();
+  const bool has_right = type == join_type::inner || type == join_type::left;
+  if (has_right && indices.second.size() != n) {
+    throw std::invalid_argument("Left and right indices must have the same length");
+  }
+
+  strings left_names(left.names());
+  strings right_names(right.names());
+  auto is_key = [&](const r_string& name) {
+    for (const std::string& key : keys) {
+      if (name == key) {
+        return true;
+      }
+    }
+    return false;
+  };
+  auto clashes = [&](const strings& names, const r_string& name) {
+    if (!has_right || is_key(name)) {
+      return false;
+    }
+    for (R_xlen_t i = 0; i < names.size(); ++i) {
+      if (names[i] == name) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  writable::list columns;
+  writable::strings names;
+  columns.reserve(left.ncol() + right.ncol());
+  names.reserve(left.ncol() + right.ncol());
+
+  const int* l = INTEGER_RO(indices.first.data());
+  for (R_xlen_t j = 0; j < left.ncol(); ++j) {
+    r_string name = left_names[j];
+    columns.push_back(detail::gather(left[j], l, n));
+    names.push_back(clashes(right_names, name) ? r_string(std::string(name) + ".x")
+                                               : name);
+  }
+
+  if (has_right) {
+    const int* r = INTEGER_RO(indices.second.data());
+    for (R_xlen_t j = 0; j < right.ncol(); ++j) {
+      r_string name = right_names[j];
+      if (is_key(name)) {
+        continue;
+      }
+      columns.push_back(detail::gather(right[j], r, n));
+      names.push_back(clashes(left_names, name) ? r_string(std::string(name) + ".y")
+                                                : name);
+    }
+  }
+
+  columns.names() = names;
+  return writable::data_frame(columns, false, n);
+}
+
+}  // namespace cpp4r
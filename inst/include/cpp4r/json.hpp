@@ -0,0 +1,427 @@
+#pragma once
+
+#include <stddef.h>  // for size_t
+
+#include <cstring>    // for memcpy
+#include <stdexcept>  // for invalid_argument, runtime_error
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include "R_ext/Arith.h"          // for NA_INTEGER, NA_LOGICAL, R_FINITE
+#include "cpp4r/R.hpp"            // for SEXP, SEXPREC, REAL_RO, INTEGER_RO
+#include "cpp4r/data_frame.hpp"   // for data_frame
+#include "cpp4r/protect.hpp"      // for safe
+#include "cpp4r/raws.hpp"         // for raws
+#include "cpp4r/sexp.hpp"         // for sexp
+#include "cpp4r/write_delim.hpp"  // for append_double, output_file, utf8_chars, write_fd
+
+namespace cpp4r {
+
+struct json_options {
+  /// Write length one atomic vectors as scalars rather than arrays
+  bool auto_unbox = false;
+  /// Bytes buffered before they are handed to the output
+  size_t chunk_size = 1 << 16;
+};
+
+namespace detail {
+
+/// Append `x` as a quoted JSON string. Runs of characters that need no escaping are
+/// appended in one go.
+inline void append_json_string(std::string& out, const char* x) {
+  static const char hex[] = "0123456789abcdef";
+  out += '"';
+  const char* run = x;
+  for (;;) {
+    const char* p = run;
+    unsigned char c;
+    while ((c = static_cast<unsigned char>(*p)) >= 0x20 && c != '"' && c != '\\') {
+      ++p;
+    }
+    out.append(run, p - run);
+    if (c == '\0') {
+      break;
+    }
+    switch (c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      case '\b':
+        out += "\\b";
+        break;
+      case '\f':
+        out += "\\f";
+        break;
+      default: {
+        const char escaped[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+        out.append(escaped, sizeof(escaped));
+      }
+    }
+    run = p + 1;
+  }
+  out += '"';
+}
+
+/// Writes to a file descriptor owned by the caller
+class fd_output {
+ public:
+  explicit fd_output(int fd) noexcept : fd_(fd) {}
+
+  bool write(const char* data, size_t size) noexcept { return write_fd(fd_, data, size); }
+
+ private:
+  int fd_;
+};
+
+/// Collects the output in a raw vector that grows geometrically
+class raws_output {
+ public:
+  bool write(const char* data, size_t size) {
+    const R_xlen_t needed = size_ + static_cast<R_xlen_t>(size);
+    if (needed > capacity_) {
+      R_xlen_t capacity = 2 * capacity_ > needed ? 2 * capacity_ : needed;
+      sexp grown = safe[Rf_allocVector](RAWSXP, capacity);
+      if (size_ > 0) {
+        std::memcpy(RAW(grown), RAW(data_), size_);
+      }
+      data_ = grown;
+      capacity_ = capacity;
+    }
+    if (size > 0) {
+      std::memcpy(RAW(data_) + size_, data, size);
+    }
+    size_ = needed;
+    return true;
+  }
+
+  raws value() const {
+    if (size_ == capacity_ && data_ != R_NilValue) {
+      return raws(data_);
+    }
+    sexp out = safe[Rf_allocVector](RAWSXP, size_);
+    if (size_ > 0) {
+      std::memcpy(RAW(out), RAW(data_), size_);
+    }
+    return raws(out);
+  }
+
+ private:
+  sexp data_;
+  R_xlen_t size_ = 0;
+  R_xlen_t capacity_ = 0;
+};
+
+/// Encodes R objects as JSON into a buffer of about `chunk_size` bytes that is handed
+/// to `Output` whenever it fills up, so memory use does not depend on the output size.
+///
+/// Atomic vectors become arrays, or scalars with `auto_unbox`, named lists become
+/// objects and other lists arrays. Data frames become arrays of row objects; their
+/// columns can't be matrices or data frames. Missing and non-finite values are written
+/// as `null`, factors as their levels.
+template <typename Output>
+class json_encoder {
+ public:
+  json_encoder(Output& output, const json_options& options)
+      : output_(output), options_(options) {
+    buffer_.reserve(options.chunk_size + 1024);
+  }
+
+  void value(SEXP x) {
+    switch (r_typeof(x)) {
+      case NILSXP:
+        buffer_ += "null";
+        break;
+      case LGLSXP: {
+        const int* values = LOGICAL_RO(x);
+        atomic(x, [&](R_xlen_t i) { logical(values[i]); });
+        break;
+      }
+      case INTSXP: {
+        const int* values = INTEGER_RO(x);
+        if (Rf_inherits(x, "factor")) {
+          SEXP levels = Rf_getAttrib(x, R_LevelsSymbol);
+          atomic(x, [&](R_xlen_t i) { level(levels, values[i]); });
+        } else {
+          atomic(x, [&](R_xlen_t i) { integer(values[i]); });
+        }
+        break;
+      }
+      case REALSXP: {
+        const double* values = REAL_RO(x);
+        atomic(x, [&](R_xlen_t i) { real(values[i]); });
+        break;
+      }
+      case STRSXP:
+        atomic(x, [&](R_xlen_t i) { string(STRING_ELT(x, i)); });
+        break;
+      case VECSXP:
+        if (Rf_inherits(x, "data.frame")) {
+          rows(data_frame(x), false);
+        } else {
+          list(x);
+        }
+        break;
+      default:
+        throw std::invalid_argument(std::string("Can't encode an object of type '") +
+                                    Rf_type2char(r_typeof(x)) + "' as JSON");
+    }
+  }
+
+  /// Write the rows of `x` as one JSON object per line
+  void ndjson(const data_frame& x) { rows(x, true); }
+
+  void finish() { flush(); }
+
+ private:
+  Output& output_;
+  const json_options& options_;
+  std::string buffer_;
+
+  void flush() {
+    if (!buffer_.empty() && !output_.write(buffer_.data(), buffer_.size())) {
+      throw std::runtime_error("Can't write JSON output");
+    }
+    buffer_.clear();
+  }
+
+  void maybe_flush() {
+    if (__builtin_expect(buffer_.size() >= options_.chunk_size, 0)) {
+      flush();
+    }
+  }
+
+  void logical(int value) {
+    buffer_ += value == NA_LOGICAL ? "null" : value ? "true" : "false";
+  }
+
+  void integer(int value) {
+    if (value == NA_INTEGER) {
+      buffer_ += "null";
+    } else {
+      append_int(buffer_, value);
+    }
+  }
+
+  void real(double value) {
+    if (R_FINITE(value)) {
+      append_double(buffer_, value);
+    } else {
+      buffer_ += "null";
+    }
+  }
+
+  void string(SEXP value) {
+    if (value == NA_STRING) {
+      buffer_ += "null";
+    } else {
+      append_json_string(buffer_, utf8_chars(value));
+    }
+  }
+
+  void level(SEXP levels, int code) {
+    if (code == NA_INTEGER || code < 1 || code > Rf_xlength(levels)) {
+      buffer_ += "null";
+    } else {
+      string(STRING_ELT(levels, code - 1));
+    }
+  }
+
+  template <typename F>
+  void atomic(SEXP x, F write) {
+    const R_xlen_t n = Rf_xlength(x);
+    if (options_.auto_unbox && n == 1) {
+      write(0);
+      return;
+    }
+    buffer_ += '[';
+    for (R_xlen_t i = 0; i < n; ++i) {
+      if (i > 0) {
+        buffer_ += ',';
+      }
+      write(i);
+      maybe_flush();
+    }
+    buffer_ += ']';
+  }
+
+  void list(SEXP x) {
+    const R_xlen_t n = Rf_xlength(x);
+    SEXP names = Rf_getAttrib(x, R_NamesSymbol);
+    buffer_ += names == R_NilValue ? '[' : '{';
+    for (R_xlen_t i = 0; i < n; ++i) {
+      if (i > 0) {
+        buffer_ += ',';
+      }
+      if (names != R_NilValue) {
+        append_key(buffer_, STRING_ELT(names, i));
+      }
+      value(VECTOR_ELT(x, i));
+      maybe_flush();
+    }
+    buffer_ += names == R_NilValue ? ']' : '}';
+  }
+
+  static void append_key(std::string& out, SEXP name) {
+    append_json_string(out, name == NA_STRING ? "NA" : utf8_chars(name));
+    out += ':';
+  }
+
+  // A data frame column with its key encoded once
+  struct column {
+    SEXP x;
+    SEXPTYPE type;
+    SEXP levels;
+    std::string key;
+  };
+
+  void rows(const data_frame& x, bool ndjson) {
+    const R_xlen_t ncol = x.ncol();
+    const R_xlen_t nrow = x.nrow();
+    SEXP names = Rf_getAttrib(x, R_NamesSymbol);
+    std::vector<column> columns(ncol);
+    for (R_xlen_t j = 0; j < ncol; ++j) {
+      column& col = columns[j];
+      col.x = VECTOR_ELT(x, j);
+      col.type = r_typeof(col.x);
+      col.levels = col.type == INTSXP && Rf_inherits(col.x, "factor")
+                       ? Rf_getAttrib(col.x, R_LevelsSymbol)
+                       : R_NilValue;
+      if (col.type != LGLSXP && col.type != INTSXP && col.type != REALSXP &&
+          col.type != STRSXP && col.type != VECSXP) {
+        throw std::invalid_argument(std::string("Can't encode a column of type '") +
+                                    Rf_type2char(col.type) + "' as JSON");
+      }
+      // The cells of these columns are rows of a matrix or data frame, not elements
+      if (Rf_getAttrib(col.x, R_DimSymbol) != R_NilValue) {
+        throw std::invalid_argument("Can't encode a matrix column as JSON");
+      }
+      if (col.type == VECSXP && Rf_inherits(col.x, "data.frame")) {
+        throw std::invalid_argument("Can't encode a data frame column as JSON");
+      }
+      append_key(col.key, STRING_ELT(names, j));
+    }
+
+    if (!ndjson) {
+      buffer_ += '[';
+    }
+    for (R_xlen_t i = 0; i < nrow; ++i) {
+      if (i > 0 && !ndjson) {
+        buffer_ += ',';
+      }
+      buffer_ += '{';
+      for (R_xlen_t j = 0; j < ncol; ++j) {
+        const column& col = columns[j];
+        if (j > 0) {
+          buffer_ += ',';
+        }
+        buffer_ += col.key;
+        cell(col, i);
+      }
+      buffer_ += '}';
+      if (ndjson) {
+        buffer_ += '\n';
+      }
+      maybe_flush();
+    }
+    if (!ndjson) {
+      buffer_ += ']';
+    }
+  }
+
+  void cell(const column& col, R_xlen_t i) {
+    switch (col.type) {
+      case LGLSXP:
+        logical(LOGICAL_RO(col.x)[i]);
+        break;
+      case INTSXP:
+        if (col.levels != R_NilValue) {
+          level(col.levels, INTEGER_RO(col.x)[i]);
+        } else {
+          integer(INTEGER_RO(col.x)[i]);
+        }
+        break;
+      case REALSXP:
+        real(REAL_RO(col.x)[i]);
+        break;
+      case STRSXP:
+        string(STRING_ELT(col.x, i));
+        break;
+      default:
+        value(VECTOR_ELT(col.x, i));
+    }
+  }
+};
+
+}  // namespace detail
+
+/// `x` encoded as JSON, see `write_json()`
+inline raws to_json(SEXP x, const json_options& options = json_options()) {
+  detail::raws_output output;
+  detail::json_encoder<detail::raws_output> encoder(output, options);
+  encoder.value(x);
+  encoder.finish();
+  return output.value();
+}
+
+/// Write `x` as JSON to the file descriptor `fd`, which stays open.
+///
+/// The encoder walks `x` directly and writes through a fixed size buffer, so memory
+/// use does not grow with the size of the output.
+inline void write_json(SEXP x, int fd, const json_options& options = json_options()) {
+  detail::fd_output output(fd);
+  detail::json_encoder<detail::fd_output> encoder(output, options);
+  encoder.value(x);
+  encoder.finish();
+}
+
+/// Write `x` as JSON to the file at `path`
+inline void write_json(SEXP x, const std::string& path,
+                       const json_options& options = json_options()) {
+  detail::output_file file(path);
+  detail::json_encoder<detail::output_file> encoder(file, options);
+  encoder.value(x);
+  encoder.finish();
+  file.close();
+}
+
+/// The rows of `x` as newline delimited JSON, one object per line
+inline raws to_ndjson(const data_frame& x, const json_options& options = json_options()) {
+  detail::raws_output output;
+  detail::json_encoder<detail::raws_output> encoder(output, options);
+  encoder.ndjson(x);
+  encoder.finish();
+  return output.value();
+}
+
+/// Write the rows of `x` as newline delimited JSON to the file descriptor `fd`
+inline void write_ndjson(const data_frame& x, int fd,
+                         const json_options& options = json_options()) {
+  detail::fd_output output(fd);
+  detail::json_encoder<detail::fd_output> encoder(output, options);
+  encoder.ndjson(x);
+  encoder.finish();
+}
+
+/// Write the rows of `x` as newline delimited JSON to the file at `path`
+inline void write_ndjson(const data_frame& x, const std::string& path,
+                         const json_options& options = json_options()) {
+  detail::output_file file(path);
+  detail::json_encoder<detail::output_file> encoder(file, options);
+  encoder.ndjson(x);
+  encoder.finish();
+  file.close();
+}
+
+}  // namespace cpp4r
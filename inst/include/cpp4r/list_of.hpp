@@ -1,17 +1,175 @@
 #pragma once
 
-#include <string>  // for string, basic_string
+#include <iterator>   // for forward_iterator_tag
+#include <memory>     // for shared_ptr, make_shared
+#include <stdexcept>  // for logic_error
+#include <string>     // for string, basic_string
 
-#include "cpp4r/R.hpp"     // for R_xlen_t, SEXP, SEXPREC, LONG_VECTOR_SUPPORT
-#include "cpp4r/list.hpp"  // for list
+#include "cpp4r/R.hpp"         // for R_xlen_t, SEXP, SEXPREC, LONG_VECTOR_SUPPORT
+#include "cpp4r/list.hpp"      // for list
+#include "cpp4r/r_vector.hpp"  // for r_vector
 
 namespace cpp4r {
 
+/// A read only view of a vector kept alive by a list, see `list_of::view()`.
+///
+/// Unlike `r_vector<T>`, a view does not protect its vector, so taking one only costs a
+/// type check and a data pointer lookup. It must not outlive the `list_of` it was taken
+/// from, nor the replacement of its element; when compiled with `CPP4R_DEBUG` defined,
+/// every access checks both.
+template <typename T>
+class r_vector_view {
+ public:
+  using underlying_type = typename r_vector<T>::underlying_type;
+
+  class const_iterator {
+   public:
+    using difference_type = ptrdiff_t;
+    using value_type = T;
+    using pointer = T*;
+    using reference = T&;
+    using iterator_category = std::forward_iterator_tag;
+
+    const_iterator(const r_vector_view* view, R_xlen_t pos) noexcept
+        : view_(view), pos_(pos) {}
+
+    const_iterator& operator++() noexcept {
+      ++pos_;
+      return *this;
+    }
+    bool operator!=(const const_iterator& other) const noexcept {
+      return pos_ != other.pos_;
+    }
+    bool operator==(const const_iterator& other) const noexcept {
+      return pos_ == other.pos_;
+    }
+    T operator*() const { return (*view_)[pos_]; }
+
+   private:
+    const r_vector_view* view_;
+    R_xlen_t pos_;
+  };
+
+#ifdef CPP4R_DEBUG
+  r_vector_view(SEXP list, R_xlen_t pos, std::shared_ptr<const bool> alive)
+      : r_vector_view(VECTOR_ELT(list, pos)) {
+    list_ = list;
+    pos_ = pos;
+    alive_ = std::move(alive);
+  }
+#endif
+
+  explicit r_vector_view(SEXP data)
+      : data_(r_vector<T>::valid_type(data)),
+        data_p_(r_vector<T>::get_const_p(ALTREP(data), data)),
+        length_(Rf_xlength(data)) {}
+
+  R_xlen_t size() const noexcept { return length_; }
+  bool empty() const noexcept { return length_ == 0; }
+  bool is_altrep() const noexcept { return data_p_ == nullptr; }
+
+  SEXP data() const {
+    check();
+    return data_;
+  }
+
+  /// The values, `nullptr` for ALTREP vectors without a data pointer
+  const underlying_type* data_ptr() const {
+    check();
+    return data_p_;
+  }
+
+  T operator[](R_xlen_t pos) const {
+    check();
+    return data_p_ != nullptr ? T(data_p_[pos]) : T(r_vector<T>::get_elt(data_, pos));
+  }
+
+  const_iterator begin() const noexcept { return const_iterator(this, 0); }
+  const_iterator end() const noexcept { return const_iterator(this, length_); }
+
+  /// An owning, protected vector of the same data
+  r_vector<T> protect() const { return r_vector<T>(data()); }
+
+ private:
+  void check() const {
+#ifdef CPP4R_DEBUG
+    if (alive_ != nullptr && (!*alive_ || VECTOR_ELT(list_, pos_) != data_)) {
+      throw std::logic_error(
+          "r_vector_view used after its list was destroyed or its element replaced");
+    }
+#endif
+  }
+
+  SEXP data_;
+  const underlying_type* data_p_;
+  R_xlen_t length_;
+#ifdef CPP4R_DEBUG
+  SEXP list_ = R_NilValue;
+  R_xlen_t pos_ = 0;
+  std::shared_ptr<const bool> alive_;
+#endif
+};
+
 template <typename T>
 class list_of : public list {
  public:
+  /// The type of the borrowed views of the elements
+  using view_type = r_vector_view<typename T::value_type>;
+
+  class view_iterator {
+   public:
+    using difference_type = ptrdiff_t;
+    using value_type = view_type;
+    using pointer = view_type*;
+    using reference = view_type&;
+    using iterator_category = std::forward_iterator_tag;
+
+    view_iterator(const list_of* parent, R_xlen_t pos) noexcept
+        : parent_(parent), pos_(pos) {}
+
+    view_iterator& operator++() noexcept {
+      ++pos_;
+      return *this;
+    }
+    bool operator!=(const view_iterator& other) const noexcept {
+      return pos_ != other.pos_;
+    }
+    bool operator==(const view_iterator& other) const noexcept {
+      return pos_ == other.pos_;
+    }
+    view_type operator*() const { return parent_->view(pos_); }
+
+   private:
+    const list_of* parent_;
+    R_xlen_t pos_;
+  };
+
+  /// The elements of a `list_of` as views, for use in range based for loops
+  class view_range {
+   public:
+    explicit view_range(const list_of* parent) noexcept : parent_(parent) {}
+    view_iterator begin() const noexcept { return view_iterator(parent_, 0); }
+    view_iterator end() const noexcept { return view_iterator(parent_, parent_->size()); }
+
+   private:
+    const list_of* parent_;
+  };
+
   inline list_of(const list& data) noexcept : list(data) {}
 
+#ifdef CPP4R_DEBUG
+  list_of(const list_of& x) : list(x) {}
+
+  list_of& operator=(const list_of& rhs) {
+    *alive_ = false;
+    alive_ = std::make_shared<bool>(true);
+    list::operator=(rhs);
+    return *this;
+  }
+
+  ~list_of() { *alive_ = false; }
+#endif
+
 #ifdef LONG_VECTOR_SUPPORT
   inline T operator[](const int pos) const {
     return operator[](static_cast<R_xlen_t>(pos));
@@ -25,6 +183,33 @@ class list_of : public list {
   inline T operator[](const std::string& pos) const {
     return list::operator[](pos.c_str());
   }
+
+  /// A view of element `pos`, borrowed from this list instead of protected on its own,
+  /// so it costs about as much as `VECTOR_ELT()`. See `r_vector_view`.
+  inline view_type view(R_xlen_t pos) const {
+#ifdef CPP4R_DEBUG
+    return view_type(data(), pos, alive_);
+#else
+    return view_type(VECTOR_ELT(data(), pos));
+#endif
+  }
+
+  /// Views of all elements, see `view()`
+  ///
+  /// ```cpp
+  /// double total = 0;
+  /// for (auto x : list.views()) {
+  ///   for (double value : x) {
+  ///     total += value;
+  ///   }
+  /// }
+  /// ```
+  inline view_range views() const noexcept { return view_range(this); }
+
+#ifdef CPP4R_DEBUG
+ private:
+  std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
+#endif
 };
 
 namespace writable {
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>  // for min
+#include <cstring>    // for memcpy
+#include <stdexcept>  // for invalid_argument
+#include <string>     // for to_string
+#include <vector>     // for vector
+
+#include "cpp4r/R.hpp"           // for SEXP, SEXPREC, Rf_allocVector, Rf_coerceVector
+#include "cpp4r/data_frame.hpp"  // for column_traits
+#include "cpp4r/function.hpp"    // for function, prepared_call
+#include "cpp4r/protect.hpp"     // for safe
+#include "cpp4r/r_vector.hpp"    // for r_vector
+#include "cpp4r/sexp.hpp"        // for sexp
+
+namespace cpp4r {
+
+namespace detail {
+
+/// Copy the `n` values of `result` to `out`, coercing them to the type of `Out` first
+/// if needed. Returns false if `result` does not have `n` values.
+template <typename Out>
+inline bool copy_batch_result(SEXP result, Out* out, R_xlen_t n) {
+  using traits = column_traits<Out>;
+  if (Rf_xlength(result) != n) {
+    return false;
+  }
+  sexp coerced = r_typeof(result) == traits::sexptype()
+                     ? result
+                     : safe[Rf_coerceVector](result, traits::sexptype());
+  if (n > 0) {
+    std::memcpy(out, traits::ptr(coerced), n * sizeof(Out));
+  }
+  return true;
+}
+
+/// `fn` called once per element of `in`, reusing a single call and argument
+template <typename In, typename Out>
+inline void map_elements(const function& fn, const In* in, R_xlen_t n, Out* out) {
+  sexp arg = safe[Rf_allocVector](column_traits<In>::sexptype(), 1);
+  In* p = column_traits<In>::mutable_ptr(arg);
+  prepared_call call(fn, static_cast<SEXP>(arg));
+  for (R_xlen_t i = 0; i < n; ++i) {
+    *p = in[i];
+    if (!copy_batch_result(call(), out + i, 1)) {
+      throw std::invalid_argument("`fn` must return a single value, element " +
+                                  std::to_string(i + 1));
+    }
+  }
+}
+
+}  // namespace detail
+
+/// Write `fn(in[i])` to `out[i]` for the `n` values of `in`, calling `fn` once per
+/// batch of `batch_size` values rather than once per value.
+///
+/// `In` and `Out` are `double` or `int`. Each batch is copied into a single reused
+/// vector, the call is evaluated once for the whole batch and its result, coerced to the
+/// type of `Out` if needed, is copied to `out`. `fn` must be vectorized, returning one
+/// value per input. If the first batch does not give one value per input, `fn` is
+/// assumed not to be vectorized and is called once per value instead, through a reused
+/// call. A later batch of the wrong length is an error.
+template <typename In, typename Out>
+inline void map_batched(const function& fn, const In* in, R_xlen_t n, Out* out,
+                        R_xlen_t batch_size = 4096) {
+  using traits = detail::column_traits<In>;
+  if (batch_size < 1) {
+    throw std::invalid_argument("`batch_size` must be positive");
+  }
+  if (n == 0) {
+    return;
+  }
+  R_xlen_t size = std::min(batch_size, n);
+  sexp batch = safe[Rf_allocVector](traits::sexptype(), size);
+  prepared_call call(fn, static_cast<SEXP>(batch));
+  for (R_xlen_t start = 0; start < n; start += size) {
+    if (n - start < size) {
+      // The last batch is shorter, so its argument is allocated at its own size
+      size = n - start;
+      batch = safe[Rf_allocVector](traits::sexptype(), size);
+      call.set_arg(0, batch);
+    }
+    std::memcpy(traits::mutable_ptr(batch), in + start, size * sizeof(In));
+    if (!detail::copy_batch_result(call(), out + start, size)) {
+      if (start > 0) {
+        throw std::invalid_argument("`fn` must return one value per input, batch at " +
+                                    std::to_string(start + 1) + " did not");
+      }
+      detail::map_elements(fn, in, n, out);
+      return;
+    }
+  }
+}
+
+/// `fn` applied to `inputs` in batches, see `map_batched()` above
+template <typename In, typename Out = In>
+inline std::vector<Out> map_batched(const function& fn, const std::vector<In>& inputs,
+                                    R_xlen_t batch_size = 4096) {
+  std::vector<Out> out(inputs.size());
+  map_batched(fn, inputs.data(), static_cast<R_xlen_t>(inputs.size()), out.data(),
+              batch_size);
+  return out;
+}
+
+/// `fn` applied to `inputs` in batches into a new vector of the same type, see
+/// `map_batched()` above
+template <typename T>
+inline writable::r_vector<T> map_batched(const function& fn, const r_vector<T>& inputs,
+                                         R_xlen_t batch_size = 4096) {
+  const R_xlen_t n = inputs.size();
+  writable::r_vector<T> out(n);
+  map_batched(fn, detail::column_traits<T>::ptr(inputs.data()), n,
+              detail::column_traits<T>::mutable_ptr(out.data()), batch_size);
+  return out;
+}
+
+}  // namespace cpp4r
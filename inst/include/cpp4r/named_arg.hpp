@@ -9,15 +9,20 @@
 #include <initializer_list>  // for initializer_list
 #include <utility>           // for forward
 
-#include "cpp4r/R.hpp"     // for SEXP, SEXPREC, literals
-#include "cpp4r/as.hpp"    // for as_sexp
-#include "cpp4r/sexp.hpp"  // for sexp
+#include "cpp4r/R.hpp"       // for SEXP, SEXPREC, literals
+#include "cpp4r/as.hpp"      // for as_sexp
+#include "cpp4r/sexp.hpp"    // for sexp
+#include "cpp4r/symbol.hpp"  // for symbol, literal_symbol
 
 namespace cpp4r {
 class named_arg {
  public:
   explicit named_arg(const char* name) noexcept : name_(name), value_(R_NilValue) {}
 
+  /// A name that is already a symbol, so calls don't need to install it
+  explicit named_arg(const symbol& name)
+      : name_(name.c_str()), tag_(name), value_(R_NilValue) {}
+
   // Copy constructor and assignment for efficient copying
   named_arg(const named_arg& other) = default;
   named_arg& operator=(const named_arg& other) = default;
@@ -31,6 +36,10 @@ class named_arg {
   explicit named_arg(const char* name, T&& value)
       : name_(name), value_(as_sexp(std::forward<T>(value))) {}
 
+  template <typename T>
+  explicit named_arg(const symbol& name, T&& value)
+      : name_(name.c_str()), tag_(name), value_(as_sexp(std::forward<T>(value))) {}
+
   // Specific overloads for common scalar types (non-explicit for convenience)
   named_arg(const char* name, double value) : name_(name), value_(as_sexp(value)) {}
   named_arg(const char* name, int value) : name_(name), value_(as_sexp(value)) {}
@@ -65,6 +74,9 @@ class named_arg {
   const char* name() const noexcept { return name_; }
   SEXP value() const noexcept { return value_; }
 
+  /// The name as a symbol, installed only if the name was not given as one
+  SEXP tag() const { return tag_ != nullptr ? tag_ : safe[Rf_install](name_); }
+
   // Comparison operators for efficient name-based comparison
   bool operator==(const named_arg& other) const noexcept {
     return std::strcmp(name_, other.name_) == 0;
@@ -82,12 +94,15 @@ class named_arg {
 
  private:
   const char* name_;
+  SEXP tag_ = nullptr;
   sexp value_;
 };
 
 namespace literals {
 
-inline named_arg operator""_nm(const char* name, std::size_t) { return named_arg(name); }
+inline named_arg operator""_nm(const char* name, std::size_t) {
+  return named_arg(symbol(detail::literal_symbol(name)));
+}
 
 }  // namespace literals
 
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>   // for atomic
+#include <chrono>   // for steady_clock, duration
+#include <cstdio>   // for snprintf
+#include <mutex>    // for mutex, lock_guard
+#include <string>   // for string
+#include <thread>   // for this_thread, thread::id
+#include <utility>  // for swap
+
+#include "R_ext/Print.h"       // for REprintf
+#include "cpp4r/R.hpp"         // for R_xlen_t
+#include "cpp4r/function.hpp"  // for r_message
+#include "cpp4r/protect.hpp"   // for safe, unwinding
+
+namespace cpp4r {
+
+namespace detail {
+
+/// Calls at most `per_second` times per second succeed, none if it is 0
+class rate_limit {
+ public:
+  explicit rate_limit(double per_second)
+      : interval_(per_second > 0 ? 1 / per_second : -1), last_(clock::now()) {}
+
+  bool ready() {
+    if (interval_ < 0) {
+      return false;
+    }
+    const clock::time_point now = clock::now();
+    if (std::chrono::duration<double>(now - last_).count() < interval_) {
+      return false;
+    }
+    last_ = now;
+    return true;
+  }
+
+ private:
+  using clock = std::chrono::steady_clock;
+
+  double interval_;
+  clock::time_point last_;
+};
+
+}  // namespace detail
+
+/// A progress report for `total` steps, printed to the console on one line.
+///
+/// `tick()` is cheap and can be called from any thread: it only counts, and the report
+/// is printed when `tick()` or `update()` is called on the thread that created the
+/// `progress`, which must be the R main thread, at most `updates_per_second` times per
+/// second. The final count is printed by `done()` or the destructor.
+class progress {
+ public:
+  explicit progress(R_xlen_t total, double updates_per_second = 10)
+      : total_(total), limit_(updates_per_second), owner_(std::this_thread::get_id()) {}
+
+  progress(const progress&) = delete;
+  progress& operator=(const progress&) = delete;
+
+  ~progress() { done(); }
+
+  void tick(R_xlen_t n = 1) {
+    current_ += n;
+    update();
+  }
+
+  /// Print the report if called on the main thread and an update is due
+  void update() {
+    if (std::this_thread::get_id() == owner_ && !done_ && limit_.ready()) {
+      print();
+    }
+  }
+
+  /// Print the final report and end its line, once
+  void done() {
+    if (std::this_thread::get_id() != owner_ || done_) {
+      return;
+    }
+    done_ = true;
+    print();
+    REprintf("\n");
+  }
+
+  R_xlen_t current() const noexcept { return current_; }
+  R_xlen_t total() const noexcept { return total_; }
+
+ private:
+  void print() const {
+    const R_xlen_t current = current_;
+    const int percent =
+        total_ > 0 ? static_cast<int>(100 * static_cast<double>(current) / total_) : 100;
+    REprintf("\r%3d%% (%lld/%lld)", percent, static_cast<long long>(current),
+             static_cast<long long>(total_));
+  }
+
+  const R_xlen_t total_;
+  std::atomic<R_xlen_t> current_{0};
+  detail::rate_limit limit_;
+  const std::thread::id owner_;
+  bool done_ = false;
+};
+
+/// Messages collected from any thread and shown with `message()` in batches.
+///
+/// `log()` only appends to a buffer under a lock. The buffer is shown as a single
+/// message, one line per logged message, by `flush()`, by `log()` on the thread that
+/// created the `logger` once `flush_interval` seconds have passed since the last flush,
+/// and by the destructor unless an exception is unwinding; a `flush_interval` of 0 only
+/// flushes explicitly. Showing messages needs R, so only the creating thread, which
+/// must be the R main thread, ever does it.
+class logger {
+ public:
+  explicit logger(double flush_interval = 1)
+      : limit_(flush_interval > 0 ? 1 / flush_interval : 0),
+        owner_(std::this_thread::get_id()) {}
+
+  logger(const logger&) = delete;
+  logger& operator=(const logger&) = delete;
+
+  /// Flushes the remaining messages. An R error or interrupt from `message()` is
+  /// passed on, so the messages are dropped instead while an exception unwinds.
+  ~logger() noexcept(false) {
+    if (!detail::unwinding()) {
+      flush();
+    }
+  }
+
+  void log(const std::string& msg) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!buffer_.empty()) {
+        buffer_ += '\n';
+      }
+      buffer_ += msg;
+    }
+    if (std::this_thread::get_id() == owner_ && limit_.ready()) {
+      flush();
+    }
+  }
+
+  /// Log a message formatted like `message()`, without truncating long messages
+  template <typename Arg, typename... Args>
+  void log(const char* fmt, Arg arg, Args... args) {
+    const int size = std::snprintf(nullptr, 0, fmt, arg, args...);
+    if (size < 0) {
+      return;
+    }
+    std::string msg(size + 1, '\0');
+    std::snprintf(&msg[0], msg.size(), fmt, arg, args...);
+    msg.resize(size);
+    log(msg);
+  }
+
+  /// Show the buffered messages, only on the creating thread
+  void flush() {
+    if (std::this_thread::get_id() != owner_) {
+      return;
+    }
+    std::string out;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::swap(out, buffer_);
+    }
+    if (!out.empty()) {
+      safe[detail::r_message](out.c_str());
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::string buffer_;
+  detail::rate_limit limit_;
+  const std::thread::id owner_;
+};
+
+}  // namespace cpp4r
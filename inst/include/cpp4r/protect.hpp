@@ -1,10 +1,14 @@
 #pragma once
 
-#include <csetjmp>    // for longjmp, setjmp, jmp_buf
-#include <exception>  // for exception
-#include <stdexcept>  // for std::runtime_error
-#include <string>     // for string, basic_string
-#include <tuple>      // for tuple, make_tuple
+#include <csetjmp>        // for longjmp, setjmp, jmp_buf
+#include <cstddef>        // for size_t
+#include <cstring>        // for strncpy
+#include <exception>      // for exception
+#include <stdexcept>      // for std::runtime_error
+#include <string>         // for string, basic_string, to_string
+#include <tuple>          // for tuple, make_tuple
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
 
 // NB: cpp4r/R.hpp must precede R_ext/Error.h to ensure R_NO_REMAP is defined
 #include "cpp4r/R.hpp"  // for SEXP, SEXPREC, CDR, R_NilValue, CAR, R_Pres...
@@ -236,6 +240,179 @@ void warning(const std::string& fmt, Args... args) {
 
 namespace detail {
 
+/// Summaries of warnings of `warning_collector`s destroyed by an exception, handled by
+/// `END_CPP4R` and dropped by the next `BEGIN_CPP4R`
+inline std::vector<std::string>& pending_warnings() {
+  static std::vector<std::string> pending;
+  return pending;
+}
+
+inline bool unwinding() noexcept {
+#if __cplusplus >= 201703L
+  return std::uncaught_exceptions() > 0;
+#else
+  return std::uncaught_exception();
+#endif
+}
+
+/// Emit and clear the pending warnings. Called outside of any `try` block, so the
+/// message being emitted is kept in a `static` in case a warning is turned into an error.
+inline void emit_pending_warnings() {
+  static std::string current;
+  std::vector<std::string>& pending = pending_warnings();
+  while (!pending.empty()) {
+    current.swap(pending.front());
+    pending.erase(pending.begin());
+    Rf_warningcall(R_NilValue, "%s", current.c_str());
+  }
+}
+
+/// Handle the pending warnings on the way out of `END_CPP4R`. They are appended to the
+/// C++ error message in `buf`, of `size` bytes, if there is one, dropped if an R
+/// condition is unwinding as `err`, and emitted otherwise. Signalling them before an
+/// error could turn them into the error, e.g. with `options(warn = 2)`.
+inline void finish_pending_warnings(char* buf, std::size_t size, SEXP err) {
+  std::vector<std::string>& pending = pending_warnings();
+  if (pending.empty()) {
+    return;
+  }
+  if (buf[0] == '\0' && err == R_NilValue) {
+    emit_pending_warnings();
+    return;
+  }
+  try {
+    if (buf[0] != '\0') {
+      std::string out(buf);
+      out += pending.size() == 1 ? "\nIn addition: Warning message:"
+                                 : "\nIn addition: Warning messages:";
+      for (const std::string& warning : pending) {
+        out += '\n';
+        out += warning;
+      }
+      std::strncpy(buf, out.c_str(), size - 1);
+    }
+  } catch (...) {
+    // Out of memory, the error is kept without the warnings
+  }
+  pending.clear();
+}
+
+}  // namespace detail
+
+/// Counts of warnings by message, to emit one summarized warning per message instead
+/// of one R warning per occurrence.
+///
+/// Look up the key of each message once with `key()`; `add()` then only increments a
+/// counter and keeps the first `max_examples` 0-based indices, reported 1-based. The
+/// summaries are emitted by `emit()` or when the collector goes out of scope. If it is
+/// destroyed by an exception that reaches `END_CPP4R`, they are added to the error
+/// message instead. Use it as a local variable, as its destructor can throw.
+class warning_collector {
+ public:
+  using key_type = std::size_t;
+
+  explicit warning_collector(std::size_t max_examples = 5)
+      : max_examples_(max_examples) {}
+
+  warning_collector(const warning_collector&) = delete;
+  warning_collector& operator=(const warning_collector&) = delete;
+
+  ~warning_collector() noexcept(false) {
+    if (!detail::unwinding()) {
+      emit();
+      return;
+    }
+    try {
+      std::vector<std::string> out = summaries();
+      std::vector<std::string>& pending = detail::pending_warnings();
+      pending.insert(pending.end(), out.begin(), out.end());
+    } catch (...) {
+      // Out of memory, the warnings are lost
+    }
+  }
+
+  /// The key of `message`, added on first use
+  key_type key(const std::string& message) {
+    auto it = keys_.find(message);
+    if (it != keys_.end()) {
+      return it->second;
+    }
+    const key_type out = entries_.size();
+    entries_.push_back(entry{message, 0, {}});
+    entries_.back().examples.reserve(max_examples_);
+    keys_.emplace(message, out);
+    return out;
+  }
+
+  void add(key_type key) noexcept { ++entries_[key].count; }
+
+  void add(key_type key, R_xlen_t index) {
+    entry& e = entries_[key];
+    if (e.examples.size() < max_examples_) {
+      e.examples.push_back(index);
+    }
+    ++e.count;
+  }
+
+  void add(const std::string& message) { add(key(message)); }
+  void add(const std::string& message, R_xlen_t index) { add(key(message), index); }
+
+  R_xlen_t count(key_type key) const noexcept { return entries_[key].count; }
+  bool empty() const noexcept { return entries_.empty(); }
+
+  /// One line per message, e.g. "NAs introduced (12 times, at 1, 4, 9, ...)"
+  std::vector<std::string> summaries() const {
+    std::vector<std::string> out;
+    for (const entry& e : entries_) {
+      if (e.count == 0) {
+        continue;
+      }
+      std::string details;
+      if (e.count > 1) {
+        details = std::to_string(e.count) + " times";
+      }
+      if (!e.examples.empty()) {
+        details += details.empty() ? "at " : ", at ";
+        for (std::size_t i = 0; i < e.examples.size(); ++i) {
+          details += (i == 0 ? "" : ", ") + std::to_string(e.examples[i] + 1);
+        }
+        if (static_cast<R_xlen_t>(e.examples.size()) < e.count) {
+          details += ", ...";
+        }
+      }
+      out.push_back(details.empty() ? e.message : e.message + " (" + details + ")");
+    }
+    return out;
+  }
+
+  void clear() noexcept {
+    entries_.clear();
+    keys_.clear();
+  }
+
+  /// Emit the summaries as R warnings now and clear them
+  void emit() {
+    std::vector<std::string> out = summaries();
+    clear();
+    for (const std::string& msg : out) {
+      safe[Rf_warningcall](R_NilValue, "%s", msg.c_str());
+    }
+  }
+
+ private:
+  struct entry {
+    std::string message;
+    R_xlen_t count;
+    std::vector<R_xlen_t> examples;
+  };
+
+  std::size_t max_examples_;
+  std::vector<entry> entries_;
+  std::unordered_map<std::string, key_type> keys_;
+};
+
+namespace detail {
+
 // A doubly-linked list of preserved objects, allowing O(1) insertion/release of objects
 // compared to O(N preserved) with `R_PreserveObject()` and `R_ReleaseObject()`.
 //
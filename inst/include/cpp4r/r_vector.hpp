@@ -9,10 +9,12 @@
 #include <exception>         // for exception
 #include <initializer_list>  // for initializer_list
 #include <iterator>          // for forward_iterator_tag, random_ac...
+#include <memory>            // for unique_ptr
 #include <stdexcept>         // for out_of_range
 #include <string>            // for string, basic_string
 #include <type_traits>       // for decay, is_same, enable_if, is_c...
-#include <utility>           // for declval
+#include <utility>           // for declval, pair
+#include <vector>            // for vector
 
 #include "cpp4r/R.hpp"                // for R_xlen_t, SEXP, SEXPREC, Rf_xle...
 #include "cpp4r/attribute_proxy.hpp"  // for attribute_proxy
@@ -30,6 +32,29 @@ template <typename T>
 class r_vector;
 }  // namespace writable
 
+template <typename T>
+class r_vector_view;
+
+namespace detail {
+
+/// The names given to `push_back()` on a writable vector, kept in a single buffer so
+/// that the names attribute is allocated and filled once, when the vector is converted
+/// to a `SEXP` or its attributes are accessed
+struct pending_names {
+  std::string chars;
+  /// The position of each named element and the end of its name in `chars`
+  std::vector<std::pair<R_xlen_t, size_t>> ends;
+};
+
+/// Read-only pointers to the data of a vector. Taking them may materialize an ALTREP
+/// vector, which allocates and can error, so they are taken under `safe[]`.
+inline const double* real_ptr(SEXP x) { return safe[REAL_RO](x); }
+inline const int* integer_ptr(SEXP x) { return safe[INTEGER_RO](x); }
+inline const int* logical_ptr(SEXP x) { return safe[LOGICAL_RO](x); }
+inline const SEXP* string_ptr(SEXP x) { return safe[STRING_PTR_RO](x); }
+
+}  // namespace detail
+
 // Declarations
 template <typename T>
 class r_vector {
@@ -164,6 +189,7 @@ class r_vector {
   static SEXP valid_length(SEXP x, R_xlen_t n);
 
   friend class writable::r_vector<T>;
+  friend class r_vector_view<T>;
 };
 
 namespace writable {
@@ -181,6 +207,7 @@ class r_vector : public cpp4r::r_vector<T> {
 
  private:
   R_xlen_t capacity_ = 0;
+  mutable std::unique_ptr<detail::pending_names> pending_names_;
 
   using cpp4r::r_vector<T>::data_;
   using cpp4r::r_vector<T>::data_p_;
@@ -273,6 +300,9 @@ class r_vector : public cpp4r::r_vector<T> {
   attribute_proxy<r_vector<T>> attr(SEXP name) const;
 
   attribute_proxy<r_vector<T>> names() const;
+  bool named() const;
+  bool contains(const r_string& name) const;
+  SEXP data() const;
 
   class proxy {
    private:
@@ -346,6 +376,9 @@ class r_vector : public cpp4r::r_vector<T> {
   static SEXP resize_data(SEXP x, bool is_altrep, R_xlen_t size);
   static SEXP resize_names(SEXP x, R_xlen_t size);
 
+  /// Attach the names in `pending_names_` to `data_`, keeping any existing names
+  void attach_names() const;
+
   using cpp4r::r_vector<T>::get_elt;
   using cpp4r::r_vector<T>::get_p;
   using cpp4r::r_vector<T>::get_const_p;
@@ -376,6 +409,16 @@ class r_vector : public cpp4r::r_vector<T> {
       set_elt(data_, i, elt);
     }
   }
+
+  // Used by `push_back(named_arg)`: lists take the value itself, other vectors the
+  // single element of the value
+  void push_back_value(SEXP value, std::true_type) { push_back(value); }
+
+  void push_back_value(SEXP value, std::false_type) {
+    valid_type(value);
+    valid_length(value, 1);
+    push_back(static_cast<T>(get_elt(value, 0)));
+  }
 };
 }  // namespace writable
 
@@ -864,6 +907,7 @@ inline r_vector<T>::r_vector(const r_vector& rhs) {
   // shallow duplicate to ensure that ALL attributes are copied over, including `dim` and
   // `dimnames`, which would be lost if we instead used `reserve_data()` to do a combined
   // duplicate + possible truncate. This is important for the `matrix` class.
+  rhs.attach_names();
   data_ = safe[Rf_shallow_duplicate](rhs.data_);
   protect_ = detail::store::insert(data_);
   is_altrep_ = ALTREP(data_);
@@ -887,6 +931,7 @@ inline r_vector<T>::r_vector(r_vector&& rhs) {
   data_p_ = rhs.data_p_;
   length_ = rhs.length_;
   capacity_ = rhs.capacity_;
+  pending_names_ = std::move(rhs.pending_names_);
 
   // Important for `rhs.protect_`, extra check for everything else
   rhs.data_ = R_NilValue;
@@ -996,12 +1041,14 @@ inline r_vector<T>& r_vector<T>::operator=(const r_vector& rhs) {
   // Unlike with move assignment operator, we can't just call the read only parent method.
   // We are in writable mode, so we must duplicate the `rhs` (since it isn't a temporary
   // we can just take ownership of) and recompute the properties from the duplicate.
+  rhs.attach_names();
   data_ = safe[Rf_shallow_duplicate](rhs.data_);
   protect_ = detail::store::insert(data_);
   is_altrep_ = ALTREP(data_);
   data_p_ = (data_ == R_NilValue) ? nullptr : get_p(is_altrep_, data_);
   length_ = rhs.length_;
   capacity_ = rhs.capacity_;
+  pending_names_.reset();
 
   detail::store::release(old_protect);
 
@@ -1020,6 +1067,7 @@ inline r_vector<T>& r_vector<T>::operator=(r_vector&& rhs) {
 
   // Handle fields specific to writable
   capacity_ = rhs.capacity_;
+  pending_names_ = std::move(rhs.pending_names_);
 
   rhs.capacity_ = 0;
 
@@ -1047,9 +1095,9 @@ inline r_vector<T>::operator SEXP() const {
     // `r_vector`. Importantly, going through `resize()` updates: `data_` and
     // protection of it, `data_p_`, and `capacity_`.
     p->resize(length_);
-    return data_;
   }
 
+  attach_names();
   return data_;
 }
 
@@ -1240,24 +1288,47 @@ inline T r_vector<T>::value(const size_type pos) const {
 
 template <typename T>
 inline attribute_proxy<r_vector<T>> r_vector<T>::attr(const char* name) const {
+  attach_names();
   return attribute_proxy<r_vector<T>>(*this, name);
 }
 
 template <typename T>
 inline attribute_proxy<r_vector<T>> r_vector<T>::attr(const std::string& name) const {
+  attach_names();
   return attribute_proxy<r_vector<T>>(*this, name.c_str());
 }
 
 template <typename T>
 inline attribute_proxy<r_vector<T>> r_vector<T>::attr(SEXP name) const {
+  attach_names();
   return attribute_proxy<r_vector<T>>(*this, name);
 }
 
 template <typename T>
 inline attribute_proxy<r_vector<T>> r_vector<T>::names() const {
+  attach_names();
   return attribute_proxy<r_vector<T>>(*this, R_NamesSymbol);
 }
 
+template <typename T>
+inline bool r_vector<T>::named() const {
+  attach_names();
+  return cpp4r::r_vector<T>::named();
+}
+
+template <typename T>
+inline bool r_vector<T>::contains(const r_string& name) const {
+  attach_names();
+  return cpp4r::r_vector<T>::contains(name);
+}
+
+/// The underlying data, with any names given by `push_back()` attached
+template <typename T>
+inline SEXP r_vector<T>::data() const {
+  attach_names();
+  return data_;
+}
+
 template <typename T>
 r_vector<T>::proxy::proxy(SEXP data, const R_xlen_t index,
                           typename r_vector::underlying_type* const p, bool is_altrep)
@@ -1380,12 +1451,12 @@ template <typename T>
 inline typename r_vector<T>::proxy r_vector<T>::iterator::operator*() const {
   if (__builtin_expect(use_buf(data_->is_altrep()), 0)) {
     return proxy(
-        data_->data(), pos_,
+        data_->data_, pos_,
         const_cast<typename r_vector::underlying_type*>(&buf_[pos_ - block_start_]),
         true);
   } else {
     return proxy(
-        data_->data(), pos_,
+        data_->data_, pos_,
         __builtin_expect(data_->data_p_ != nullptr, 1) ? &data_->data_p_[pos_] : nullptr,
         false);
   }
@@ -1472,6 +1543,36 @@ inline SEXP r_vector<T>::resize_data(SEXP x, bool is_altrep, R_xlen_t size) {
   return out;
 }
 
+template <typename T>
+inline void r_vector<T>::attach_names() const {
+  if (pending_names_ == nullptr || pending_names_->ends.empty()) {
+    return;
+  }
+  const R_xlen_t size = Rf_xlength(data_);
+  SEXP names = Rf_getAttrib(data_, R_NamesSymbol);
+  if (names == R_NilValue) {
+    // Elements pushed without a name get `""`, like in `c()`
+    names = safe[Rf_allocVector](STRSXP, size);
+  } else if (Rf_xlength(names) != size) {
+    names = resize_names(names, size);
+  }
+  PROTECT(names);
+
+  // Take the buffer first, so it is dropped even if making a name fails
+  std::unique_ptr<detail::pending_names> pending = std::move(pending_names_);
+  const char* chars = pending->chars.data();
+  size_t begin = 0;
+  for (const auto& end : pending->ends) {
+    if (end.first < size) {
+      SET_STRING_ELT(names, end.first,
+                     safe[Rf_mkCharLenCE](chars + begin, end.second - begin, CE_UTF8));
+    }
+    begin = end.second;
+  }
+  Rf_setAttrib(data_, R_NamesSymbol, names);
+  UNPROTECT(1);
+}
+
 template <typename T>
 inline SEXP r_vector<T>::resize_names(SEXP x, R_xlen_t size) {
   const SEXP* v_x = STRING_PTR_RO(x);
@@ -1496,12 +1597,15 @@ inline SEXP r_vector<T>::resize_names(SEXP x, R_xlen_t size) {
 
 }  // namespace writable
 
-// Ensure that C is not constructible from SEXP, and neither C nor T is a std::string
+// Ensure that C is not constructible from SEXP, neither C nor T is a std::string, and T
+// is neither a record (see record.hpp) nor a std::vector (see ragged.hpp)
 template <typename C, typename T = typename std::decay<C>::type::value_type>
 typename std::enable_if<
     !std::is_constructible<C, SEXP>::value &&
         !std::is_same<typename std::decay<C>::type, std::string>::value &&
-        !std::is_same<typename std::decay<T>::type, std::string>::value,
+        !std::is_same<typename std::decay<T>::type, std::string>::value &&
+        !record_traits<typename std::decay<T>::type>::value &&
+        !is_std_vector<typename std::decay<T>::type>::value,
     C>::type
 as_cpp(SEXP from) {
   auto obj = cpp4r::r_vector<T>(from);
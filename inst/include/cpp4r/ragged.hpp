@@ -0,0 +1,256 @@
+#pragma once
+
+#include <cstring>           // for memcpy
+#include <initializer_list>  // for initializer_list
+#include <iterator>          // for forward_iterator_tag
+#include <stdexcept>         // for invalid_argument, out_of_range
+#include <string>            // for to_string
+#include <type_traits>       // for conditional, is_floating_point
+#include <utility>           // for move
+#include <vector>            // for vector
+
+#include "cpp4r/R.hpp"           // for SEXP, SEXPREC, Rf_allocVector, VECTOR_ELT
+#include "cpp4r/as.hpp"          // for enable_if_t, is_std_vector
+#include "cpp4r/data_frame.hpp"  // for column_traits
+#include "cpp4r/list.hpp"        // for list
+#include "cpp4r/list_of.hpp"     // for list_of
+#include "cpp4r/protect.hpp"     // for safe
+#include "cpp4r/r_vector.hpp"    // for r_vector, type_error
+#include "cpp4r/sexp.hpp"        // for sexp
+
+namespace cpp4r {
+
+namespace detail {
+
+/// The vectors of the list `x`, which must all be of `type`, with their total length
+inline R_xlen_t ragged_total(SEXP x, SEXPTYPE type) {
+  if (r_typeof(x) != VECSXP) {
+    throw type_error(VECSXP, r_typeof(x));
+  }
+  R_xlen_t total = 0;
+  for (R_xlen_t i = 0, n = Rf_xlength(x); i < n; ++i) {
+    SEXP element = VECTOR_ELT(x, i);
+    if (r_typeof(element) != type) {
+      throw type_error(type, r_typeof(element));
+    }
+    total += Rf_xlength(element);
+  }
+  return total;
+}
+
+/// The type R stores the numbers of nested containers of `T` as
+template <typename T>
+using ragged_storage_t =
+    typename std::conditional<std::is_floating_point<T>::value, double, int>::type;
+
+template <typename T, typename R = void>
+using enable_if_ragged_value =
+    enable_if_t<std::is_floating_point<T>::value ||
+                    (std::is_integral<T>::value && !std::is_same<T, bool>::value),
+                R>;
+
+}  // namespace detail
+
+/// A list of numeric vectors in compressed sparse row layout: the values of all rows
+/// in one contiguous buffer and the `size() + 1` offsets of the rows into it.
+///
+/// `ragged<double>` and `ragged<int>` convert to and from lists of double or integer
+/// vectors in a single pass over the list, without a wrapper or protection per element,
+/// so kernels can work on contiguous memory and touch the R list only at the boundary.
+template <typename T>
+class ragged {
+  using traits = detail::column_traits<T>;
+
+ public:
+  /// A read only view of one row
+  class row {
+   public:
+    row(const T* begin, const T* end) noexcept : begin_(begin), end_(end) {}
+
+    R_xlen_t size() const noexcept { return end_ - begin_; }
+    bool empty() const noexcept { return begin_ == end_; }
+    const T& operator[](R_xlen_t i) const noexcept { return begin_[i]; }
+    const T* data() const noexcept { return begin_; }
+    const T* begin() const noexcept { return begin_; }
+    const T* end() const noexcept { return end_; }
+
+   private:
+    const T* begin_;
+    const T* end_;
+  };
+
+  class const_iterator {
+   public:
+    using difference_type = ptrdiff_t;
+    using value_type = row;
+    using pointer = row*;
+    using reference = row&;
+    using iterator_category = std::forward_iterator_tag;
+
+    const_iterator(const ragged* data, R_xlen_t pos) noexcept : data_(data), pos_(pos) {}
+
+    const_iterator& operator++() noexcept {
+      ++pos_;
+      return *this;
+    }
+    bool operator!=(const const_iterator& other) const noexcept {
+      return pos_ != other.pos_;
+    }
+    bool operator==(const const_iterator& other) const noexcept {
+      return pos_ == other.pos_;
+    }
+    row operator*() const noexcept { return (*data_)[pos_]; }
+
+   private:
+    const ragged* data_;
+    R_xlen_t pos_;
+  };
+
+  ragged() : offsets_(1, 0) {}
+
+  /// Take over `values` and `offsets`, which must start at 0, never decrease and end
+  /// at the number of values
+  ragged(std::vector<T> values, std::vector<R_xlen_t> offsets)
+      : values_(std::move(values)), offsets_(std::move(offsets)) {
+    if (offsets_.empty() || offsets_.front() != 0 ||
+        offsets_.back() != static_cast<R_xlen_t>(values_.size())) {
+      throw std::invalid_argument("`offsets` must run from 0 to the number of values");
+    }
+    for (size_t i = 1; i < offsets_.size(); ++i) {
+      if (offsets_[i] < offsets_[i - 1]) {
+        throw std::invalid_argument("`offsets` must be non-decreasing");
+      }
+    }
+  }
+
+  /// Copy the vectors of the list `x`, which must all be of the type of `T`. The total
+  /// length is summed first, so the values are allocated once.
+  explicit ragged(SEXP x) : offsets_(1, 0), names_(Rf_getAttrib(x, R_NamesSymbol)) {
+    values_.resize(detail::ragged_total(x, traits::sexptype()));
+    const R_xlen_t n = Rf_xlength(x);
+    offsets_.reserve(n + 1);
+    for (R_xlen_t i = 0; i < n; ++i) {
+      SEXP element = VECTOR_ELT(x, i);
+      const R_xlen_t size = Rf_xlength(element);
+      if (size > 0) {
+        std::memcpy(values_.data() + offsets_.back(), traits::ptr(element),
+                    size * sizeof(T));
+      }
+      offsets_.push_back(offsets_.back() + size);
+    }
+  }
+
+  /// The number of rows
+  R_xlen_t size() const noexcept { return offsets_.size() - 1; }
+  bool empty() const noexcept { return size() == 0; }
+
+  row operator[](R_xlen_t i) const noexcept {
+    return row(values_.data() + offsets_[i], values_.data() + offsets_[i + 1]);
+  }
+
+  row at(R_xlen_t i) const {
+    if (i < 0 || i >= size()) {
+      throw std::out_of_range("ragged: row " + std::to_string(i) + " of " +
+                              std::to_string(size()));
+    }
+    return operator[](i);
+  }
+
+  /// Mutable access to the values of row `i`, `row_size(i)` of them
+  T* row_data(R_xlen_t i) noexcept { return values_.data() + offsets_[i]; }
+  R_xlen_t row_size(R_xlen_t i) const noexcept { return offsets_[i + 1] - offsets_[i]; }
+
+  const_iterator begin() const noexcept { return const_iterator(this, 0); }
+  const_iterator end() const noexcept { return const_iterator(this, size()); }
+
+  /// All values, row after row
+  const std::vector<T>& values() const noexcept { return values_; }
+  std::vector<T>& values() noexcept { return values_; }
+  const std::vector<R_xlen_t>& offsets() const noexcept { return offsets_; }
+
+  /// The names of the rows, `R_NilValue` if they have none
+  SEXP names() const noexcept { return names_; }
+
+  void reserve(R_xlen_t rows, R_xlen_t values) {
+    offsets_.reserve(rows + 1);
+    values_.reserve(values);
+  }
+
+  /// Append a row with the values of `[first, last)`
+  template <typename It>
+  void push_back(It first, It last) {
+    values_.insert(values_.end(), first, last);
+    offsets_.push_back(static_cast<R_xlen_t>(values_.size()));
+  }
+
+  void push_back(std::initializer_list<T> il) { push_back(il.begin(), il.end()); }
+
+  /// A new list with one vector per row, each allocated at its exact size
+  list_of<r_vector<T>> to_list() const {
+    const R_xlen_t n = size();
+    sexp out = safe[Rf_allocVector](VECSXP, n);
+    for (R_xlen_t i = 0; i < n; ++i) {
+      const R_xlen_t size = row_size(i);
+      SEXP element = safe[Rf_allocVector](traits::sexptype(), size);
+      SET_VECTOR_ELT(out, i, element);
+      if (size > 0) {
+        std::memcpy(traits::mutable_ptr(element), values_.data() + offsets_[i],
+                    size * sizeof(T));
+      }
+    }
+    if (names_ != R_NilValue && Rf_xlength(names_) == n) {
+      Rf_setAttrib(out, R_NamesSymbol, names_);
+    }
+    return list(out);
+  }
+
+  operator SEXP() const { return to_list(); }
+
+ private:
+  std::vector<T> values_;
+  std::vector<R_xlen_t> offsets_;
+  sexp names_ = R_NilValue;
+};
+
+/// Convert a list of double or integer vectors to nested `std::vector`s, walking the
+/// list once
+template <typename C, typename Row = typename std::decay<C>::type::value_type,
+          typename T = typename Row::value_type>
+enable_if_t<is_std_vector<Row>::value, detail::enable_if_ragged_value<T, C>> as_cpp(
+    SEXP from) {
+  using traits = detail::column_traits<detail::ragged_storage_t<T>>;
+  detail::ragged_total(from, traits::sexptype());
+  const R_xlen_t n = Rf_xlength(from);
+  typename std::decay<C>::type out;
+  out.reserve(n);
+  for (R_xlen_t i = 0; i < n; ++i) {
+    SEXP element = VECTOR_ELT(from, i);
+    const auto* p = traits::ptr(element);
+    out.emplace_back(p, p + Rf_xlength(element));
+  }
+  return out;
+}
+
+/// Convert nested containers of numbers to a list of double or integer vectors
+template <typename Container, typename Row = typename Container::value_type,
+          typename T = typename Row::value_type>
+enable_if_t<is_std_vector<Row>::value, detail::enable_if_ragged_value<T, SEXP>> as_sexp(
+    const Container& from) {
+  using storage = detail::ragged_storage_t<T>;
+  using traits = detail::column_traits<storage>;
+  const R_xlen_t n = from.size();
+  sexp out = safe[Rf_allocVector](VECSXP, n);
+  auto it = from.begin();
+  for (R_xlen_t i = 0; i < n; ++i, ++it) {
+    const R_xlen_t size = it->size();
+    SEXP element = safe[Rf_allocVector](traits::sexptype(), size);
+    SET_VECTOR_ELT(out, i, element);
+    storage* p = traits::mutable_ptr(element);
+    for (const T& value : *it) {
+      *p++ = static_cast<storage>(value);
+    }
+  }
+  return out;
+}
+
+}  // namespace cpp4r
@@ -0,0 +1,810 @@
+#pragma once
+
+#include <limits.h>  // for INT_MAX
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint64_t
+
+#include <cstdlib>    // for strtod
+#include <cstring>    // for memchr, memcmp, memcpy
+#include <stdexcept>  // for invalid_argument, runtime_error
+#include <string>     // for string, to_string
+#include <vector>     // for vector
+
+#if defined(_WIN32)
+#include <cstdio>  // for fopen, fread, fclose
+#else
+#include <fcntl.h>     // for open, O_RDONLY
+#include <sys/mman.h>  // for mmap, munmap, posix_madvise
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close
+#endif
+
+#if defined(_OPENMP)
+#include <omp.h>  // for omp_get_max_threads
+#endif
+
+#include "R_ext/Arith.h"         // for NA_INTEGER, NA_LOGICAL, NA_REAL, R_NaN
+#include "cpp4r/R.hpp"           // for SEXP, SEXPREC, Rf_allocVector, SET_STRING_ELT
+#include "cpp4r/data_frame.hpp"  // for data_frame
+#include "cpp4r/factor.hpp"      // for hash_mix
+#include "cpp4r/list.hpp"        // for list
+#include "cpp4r/protect.hpp"     // for safe
+#include "cpp4r/sexp.hpp"        // for sexp
+#include "cpp4r/strings.hpp"     // for strings
+
+namespace cpp4r {
+
+/// The type of a column of a delimited file. `guess` infers the type from the first
+/// `delim_options::guess_rows` rows, `skip` leaves the column out of the result.
+enum class column_type { guess, logical, integer, real, string, skip };
+
+struct delim_options {
+  char delim = ',';
+  char quote = '"';
+  bool header = true;
+  /// Unquoted fields read as `NA`
+  std::vector<std::string> na = {"", "NA"};
+  R_xlen_t guess_rows = 1000;
+  /// Number of threads, 0 for the OpenMP default
+  int num_threads = 0;
+};
+
+namespace detail {
+
+/// A whole file, memory mapped where the platform allows and read otherwise
+class mapped_file {
+ public:
+  explicit mapped_file(const std::string& path) {
+#if defined(_WIN32)
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+      throw std::runtime_error("Can't open '" + path + "'");
+    }
+    char buffer[1 << 16];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+      data_.insert(data_.end(), buffer, buffer + n);
+    }
+    std::fclose(file);
+    begin_ = data_.data();
+    size_ = data_.size();
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+      if (fd >= 0) {
+        close(fd);
+      }
+      throw std::runtime_error("Can't open '" + path + "'");
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ > 0) {
+      void* map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error("Can't map '" + path + "'");
+      }
+      posix_madvise(map, size_, POSIX_MADV_SEQUENTIAL);
+      begin_ = static_cast<const char*>(map);
+    }
+    close(fd);
+#endif
+  }
+
+  ~mapped_file() {
+#if !defined(_WIN32)
+    if (begin_ != nullptr) {
+      munmap(const_cast<char*>(begin_), size_);
+    }
+#endif
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  const char* begin() const noexcept { return begin_; }
+  const char* end() const noexcept { return begin_ + size_; }
+
+ private:
+  const char* begin_ = nullptr;
+  size_t size_ = 0;
+#if defined(_WIN32)
+  std::vector<char> data_;
+#endif
+};
+
+/// A field of a delimited file, without its quotes
+struct delim_field {
+  const char* begin;
+  const char* end;
+  bool quoted;
+  /// Whether the quoted field contains doubled quotes
+  bool escaped;
+
+  size_t size() const noexcept { return static_cast<size_t>(end - begin); }
+};
+
+/// Splits rows of a delimited file into fields. Quoted fields may contain delimiters,
+/// newlines and doubled quotes, `\r\n` line endings are accepted.
+class delim_tokenizer {
+ public:
+  delim_tokenizer(const char* begin, const char* end, char delim, char quote) noexcept
+      : pos_(begin), end_(end), delim_(delim), quote_(quote) {}
+
+  /// Skip empty lines, false at the end of the input
+  bool next_row() noexcept {
+    while (pos_ < end_ && (*pos_ == '\n' || *pos_ == '\r')) {
+      ++pos_;
+    }
+    return pos_ < end_;
+  }
+
+  /// Read the next field into `field`, true if it was the last one of its row
+  bool next_field(delim_field& field) noexcept {
+    const char* p = pos_;
+    field.escaped = false;
+    if (p < end_ && *p == quote_) {
+      field.quoted = true;
+      field.begin = ++p;
+      for (;;) {
+        const char* q = static_cast<const char*>(std::memchr(p, quote_, end_ - p));
+        if (q == nullptr) {
+          // Unterminated quote, the field runs to the end of the input
+          field.end = end_;
+          pos_ = end_;
+          return true;
+        }
+        if (q + 1 < end_ && q[1] == quote_) {
+          field.escaped = true;
+          p = q + 2;
+          continue;
+        }
+        field.end = q;
+        p = q + 1;
+        break;
+      }
+      // Anything between the closing quote and the delimiter is dropped
+      while (p < end_ && *p != delim_ && *p != '\n') {
+        ++p;
+      }
+    } else {
+      field.quoted = false;
+      field.begin = p;
+      while (p < end_ && *p != delim_ && *p != '\n') {
+        ++p;
+      }
+      field.end = p;
+      if (field.end > field.begin && field.end[-1] == '\r' && (p == end_ || *p == '\n')) {
+        --field.end;
+      }
+    }
+
+    if (p < end_ && *p == delim_) {
+      pos_ = p + 1;
+      return false;
+    }
+    pos_ = p < end_ ? p + 1 : end_;
+    return true;
+  }
+
+  const char* position() const noexcept { return pos_; }
+
+ private:
+  const char* pos_;
+  const char* end_;
+  char delim_;
+  char quote_;
+};
+
+inline bool is_digit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+inline bool equal_ignore_case(const char* begin, const char* end, const char* lower) {
+  for (; begin < end; ++begin, ++lower) {
+    char c = *begin >= 'A' && *begin <= 'Z' ? *begin - 'A' + 'a' : *begin;
+    if (*lower == '\0' || c != *lower) {
+      return false;
+    }
+  }
+  return *lower == '\0';
+}
+
+/// Parse a decimal number. Numbers with at most 15 significant digits and a small
+/// exponent are computed exactly from a single multiplication or division, as in
+/// Clinger's fast path, the others fall back to `strtod()`.
+inline bool parse_double(const char* begin, const char* end, double& out) {
+  static const double powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                  1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                  1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  const char* p = begin;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    ++p;
+  }
+
+  uint64_t mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+  bool any = false;
+  bool exact = true;
+  for (; p < end && is_digit(*p); ++p) {
+    any = true;
+    if (digits < 19) {
+      mantissa = mantissa * 10 + (*p - '0');
+      digits += mantissa != 0;
+    } else {
+      ++exponent;
+      exact = false;
+    }
+  }
+  if (p < end && *p == '.') {
+    for (++p; p < end && is_digit(*p); ++p) {
+      any = true;
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (*p - '0');
+        digits += mantissa != 0;
+        --exponent;
+      } else {
+        exact = false;
+      }
+    }
+  }
+
+  if (!any) {
+    if (equal_ignore_case(p, end, "inf") || equal_ignore_case(p, end, "infinity")) {
+      out = negative ? R_NegInf : R_PosInf;
+      return true;
+    }
+    if (equal_ignore_case(p, end, "nan")) {
+      out = R_NaN;
+      return true;
+    }
+    return false;
+  }
+
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool negative_exponent = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+      negative_exponent = *p == '-';
+      ++p;
+    }
+    if (p == end || !is_digit(*p)) {
+      return false;
+    }
+    int e = 0;
+    for (; p < end && is_digit(*p); ++p) {
+      if (e < 100000) {
+        e = e * 10 + (*p - '0');
+      }
+    }
+    exponent += negative_exponent ? -e : e;
+  }
+  if (p != end) {
+    return false;
+  }
+
+  if (exact && digits <= 15 && exponent >= -22 && exponent <= 22) {
+    double value = static_cast<double>(mantissa);
+    value = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+    out = negative ? -value : value;
+    return true;
+  }
+
+  std::string copy(begin, end);
+  out = std::strtod(copy.c_str(), nullptr);
+  return true;
+}
+
+/// Parse an integer, values outside of the range of R integers are rejected
+inline bool parse_int(const char* begin, const char* end, int& out) {
+  const char* p = begin;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    ++p;
+  }
+  if (p == end) {
+    return false;
+  }
+  long long value = 0;
+  for (; p < end; ++p) {
+    if (!is_digit(*p)) {
+      return false;
+    }
+    value = value * 10 + (*p - '0');
+    if (value > INT_MAX) {
+      return false;
+    }
+  }
+  out = static_cast<int>(negative ? -value : value);
+  return true;
+}
+
+inline bool parse_logical(const char* begin, const char* end, int& out) {
+  const size_t n = static_cast<size_t>(end - begin);
+  if ((n == 1 && *begin == 'T') || (n == 4 && (std::memcmp(begin, "TRUE", 4) == 0 ||
+                                               std::memcmp(begin, "True", 4) == 0 ||
+                                               std::memcmp(begin, "true", 4) == 0))) {
+    out = TRUE;
+    return true;
+  }
+  if ((n == 1 && *begin == 'F') || (n == 5 && (std::memcmp(begin, "FALSE", 5) == 0 ||
+                                               std::memcmp(begin, "False", 5) == 0 ||
+                                               std::memcmp(begin, "false", 5) == 0))) {
+    out = FALSE;
+    return true;
+  }
+  return false;
+}
+
+inline size_t hash_bytes(const char* p, size_t n) noexcept {
+  uint64_t h = n;
+  for (; n >= 8; p += 8, n -= 8) {
+    uint64_t word;
+    std::memcpy(&word, p, 8);
+    h = hash_mix(h ^ word);
+  }
+  uint64_t tail = 0;
+  std::memcpy(&tail, p, n);
+  return hash_mix(h ^ tail);
+}
+
+/// A string field waiting to be interned on the main thread. `begin` is null for `NA`.
+struct string_field {
+  const char* begin;
+  size_t size;
+  size_t hash;
+  bool escaped;
+};
+
+/// The `CHARSXP`s of the string fields seen so far, keyed by their bytes in the file.
+/// Files tend to repeat a small number of strings, which are then only created once.
+class charsxp_cache {
+ public:
+  SEXP get(const string_field& field, char quote) {
+    if (2 * (size_ + 1) > entries_.size()) {
+      rehash();
+    }
+    size_t i = field.hash & mask_;
+    for (; entries_[i].value != nullptr; i = (i + 1) & mask_) {
+      const entry& e = entries_[i];
+      if (e.field.hash == field.hash && e.field.size == field.size &&
+          e.field.escaped == field.escaped &&
+          std::memcmp(e.field.begin, field.begin, field.size) == 0) {
+        return e.value;
+      }
+    }
+
+    SEXP value;
+    if (field.escaped) {
+      // Collapse doubled quotes
+      scratch_.clear();
+      for (size_t j = 0; j < field.size; ++j) {
+        scratch_.push_back(field.begin[j]);
+        j += field.begin[j] == quote;
+      }
+      value = safe[Rf_mkCharLenCE](scratch_.data(), static_cast<int>(scratch_.size()),
+                                   CE_UTF8);
+    } else {
+      value = safe[Rf_mkCharLenCE](field.begin, static_cast<int>(field.size), CE_UTF8);
+    }
+    // The CHARSXP is stored in a column right after, which keeps it alive
+    entries_[i] = {field, value};
+    ++size_;
+    return value;
+  }
+
+ private:
+  struct entry {
+    string_field field;
+    SEXP value;
+  };
+  std::vector<entry> entries_;
+  size_t mask_ = 0;
+  size_t size_ = 0;
+  std::string scratch_;
+
+  void rehash() {
+    std::vector<entry> entries(entries_.empty() ? 1024 : 2 * entries_.size(),
+                               entry{{nullptr, 0, 0, false}, nullptr});
+    entries.swap(entries_);
+    mask_ = entries_.size() - 1;
+    for (const entry& e : entries) {
+      if (e.value != nullptr) {
+        size_t i = e.field.hash & mask_;
+        while (entries_[i].value != nullptr) {
+          i = (i + 1) & mask_;
+        }
+        entries_[i] = e;
+      }
+    }
+  }
+};
+
+/// The values of one column parsed from one chunk of rows
+struct parsed_column {
+  std::vector<double> reals;
+  std::vector<int> ints;
+  std::vector<string_field> strings;
+};
+
+/// The rows of one chunk, or the first error found in it
+struct parsed_chunk {
+  R_xlen_t nrow = 0;
+  std::vector<parsed_column> columns;
+  std::string error;
+};
+
+class delim_reader {
+ public:
+  delim_reader(const char* begin, const char* end, std::vector<column_type> types,
+               const delim_options& options)
+      : begin_(begin), end_(end), types_(std::move(types)), options_(options) {
+    // Skip a UTF-8 byte order mark
+    if (end_ - begin_ >= 3 && std::memcmp(begin_, "\xEF\xBB\xBF", 3) == 0) {
+      begin_ += 3;
+    }
+    read_header();
+    guess_types();
+  }
+
+  writable::data_frame read() {
+    std::vector<const char*> bounds = chunk_bounds();
+    const R_xlen_t n_chunks = static_cast<R_xlen_t>(bounds.size()) - 1;
+    std::vector<parsed_chunk> chunks(n_chunks);
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) num_threads(thread_count())
+#endif
+    for (R_xlen_t i = 0; i < n_chunks; ++i) {
+      parse_chunk(bounds[i], bounds[i + 1], chunks[i]);
+    }
+
+    R_xlen_t nrow = 0;
+    for (const parsed_chunk& chunk : chunks) {
+      if (!chunk.error.empty()) {
+        throw std::invalid_argument(chunk.error + " in row " +
+                                    std::to_string(nrow + chunk.nrow + 1));
+      }
+      nrow += chunk.nrow;
+    }
+
+    R_xlen_t n_out = 0;
+    for (column_type type : types_) {
+      n_out += type != column_type::skip;
+    }
+    writable::list columns(n_out);
+    writable::strings names(n_out);
+    charsxp_cache cache;
+    R_xlen_t out = 0;
+    for (size_t j = 0; j < types_.size(); ++j) {
+      if (types_[j] == column_type::skip) {
+        continue;
+      }
+      columns[out] = assemble(j, chunks, nrow, cache);
+      SET_STRING_ELT(names, out, cache.get(names_[j], options_.quote));
+      ++out;
+    }
+    columns.names() = names;
+    return writable::data_frame(columns, false, nrow);
+  }
+
+ private:
+  const char* begin_;
+  const char* end_;
+  std::vector<column_type> types_;
+  const delim_options& options_;
+  std::vector<string_field> names_;
+  std::vector<std::string> generated_names_;
+
+  int thread_count() const {
+#if defined(_OPENMP)
+    return options_.num_threads > 0 ? options_.num_threads : omp_get_max_threads();
+#else
+    return 1;
+#endif
+  }
+
+  static string_field make_string(const delim_field& field) {
+    return {field.begin, field.size(), hash_bytes(field.begin, field.size()),
+            field.escaped};
+  }
+
+  bool is_na(const delim_field& field) const {
+    if (field.quoted) {
+      return false;
+    }
+    for (const std::string& na : options_.na) {
+      if (na.size() == field.size() &&
+          std::memcmp(na.data(), field.begin, field.size()) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // The column names, or X1, X2, ... without a header. Fixes the number of columns.
+  void read_header() {
+    delim_tokenizer tokenizer(begin_, end_, options_.delim, options_.quote);
+    std::vector<delim_field> fields;
+    if (tokenizer.next_row()) {
+      delim_field field;
+      bool row_end = false;
+      while (!row_end) {
+        row_end = tokenizer.next_field(field);
+        fields.push_back(field);
+      }
+    }
+
+    if (!types_.empty() && types_.size() != fields.size()) {
+      throw std::invalid_argument("Expected " + std::to_string(types_.size()) +
+                                  " column types, the file has " +
+                                  std::to_string(fields.size()) + " columns");
+    }
+    types_.resize(fields.size(), column_type::guess);
+
+    generated_names_.resize(fields.size());
+    for (size_t j = 0; j < fields.size(); ++j) {
+      if (options_.header) {
+        names_.push_back(make_string(fields[j]));
+      } else {
+        generated_names_[j] = "X" + std::to_string(j + 1);
+        const std::string& name = generated_names_[j];
+        names_.push_back({name.data(), name.size(), hash_bytes(name.data(), name.size()),
+                          false});
+      }
+    }
+    if (options_.header) {
+      begin_ = tokenizer.position();
+    }
+  }
+
+  // Guess the type of the `guess` columns from the values of the first rows. Numbers
+  // are read as doubles, as a later row may not fit an integer.
+  void guess_types() {
+    const size_t ncol = types_.size();
+    std::vector<bool> guess(ncol), seen(ncol);
+    std::vector<bool> can_logical(ncol, true), can_real(ncol, true);
+    bool any_guess = false;
+    for (size_t j = 0; j < ncol; ++j) {
+      guess[j] = types_[j] == column_type::guess;
+      any_guess = any_guess || guess[j];
+    }
+    if (!any_guess) {
+      return;
+    }
+
+    delim_tokenizer tokenizer(begin_, end_, options_.delim, options_.quote);
+    delim_field field;
+    for (R_xlen_t row = 0; row < options_.guess_rows && tokenizer.next_row(); ++row) {
+      bool row_end = false;
+      for (size_t j = 0; !row_end; ++j) {
+        row_end = tokenizer.next_field(field);
+        if (j >= ncol || !guess[j] || is_na(field)) {
+          continue;
+        }
+        seen[j] = true;
+        int lgl;
+        double dbl;
+        can_logical[j] = can_logical[j] && parse_logical(field.begin, field.end, lgl);
+        can_real[j] = can_real[j] && parse_double(field.begin, field.end, dbl);
+      }
+    }
+
+    for (size_t j = 0; j < ncol; ++j) {
+      if (!guess[j]) {
+        continue;
+      }
+      if (!seen[j] || can_logical[j]) {
+        types_[j] = column_type::logical;
+      } else if (can_real[j]) {
+        types_[j] = column_type::real;
+      } else {
+        types_[j] = column_type::string;
+      }
+    }
+  }
+
+  /// Split the data into about 4 chunks per thread, each starting at the beginning of
+  /// a row. Rows are found from raw offsets by tracking whether they are within quotes,
+  /// from the parity of the number of quotes before them.
+  std::vector<const char*> chunk_bounds() const {
+    const size_t size = static_cast<size_t>(end_ - begin_);
+    const size_t min_chunk = 1 << 20;
+    R_xlen_t n = 4 * thread_count();
+    if (static_cast<size_t>(n) > size / min_chunk + 1) {
+      n = static_cast<R_xlen_t>(size / min_chunk + 1);
+    }
+
+    std::vector<const char*> raw(n + 1);
+    for (R_xlen_t k = 0; k <= n; ++k) {
+      raw[k] = begin_ + size / n * k;
+    }
+    raw[n] = end_;
+
+    std::vector<int> parity(n);
+    const char quote = options_.quote;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) num_threads(thread_count())
+#endif
+    for (R_xlen_t k = 0; k < n; ++k) {
+      int count = 0;
+      const char* p = raw[k];
+      while (p < raw[k + 1] &&
+             (p = static_cast<const char*>(std::memchr(p, quote, raw[k + 1] - p)))) {
+        ++count;
+        ++p;
+      }
+      parity[k] = count & 1;
+    }
+
+    std::vector<const char*> bounds = {begin_};
+    bool in_quote = false;
+    for (R_xlen_t k = 1; k < n; ++k) {
+      in_quote = in_quote != static_cast<bool>(parity[k - 1]);
+      bool q = in_quote;
+      const char* p = raw[k];
+      while (p < end_ && (q || *p != '\n')) {
+        q = q != (*p == quote);
+        ++p;
+      }
+      p = p < end_ ? p + 1 : end_;
+      if (p > bounds.back()) {
+        bounds.push_back(p);
+      }
+    }
+    if (end_ > bounds.back() || bounds.size() == 1) {
+      bounds.push_back(end_);
+    }
+    return bounds;
+  }
+
+  // Runs on worker threads, so it must not call R or throw
+  void parse_chunk(const char* begin, const char* end, parsed_chunk& chunk) const {
+    const size_t ncol = types_.size();
+    chunk.columns.resize(ncol);
+    delim_tokenizer tokenizer(begin, end, options_.delim, options_.quote);
+    delim_field field;
+    while (tokenizer.next_row()) {
+      bool row_end = false;
+      size_t j = 0;
+      for (; !row_end; ++j) {
+        row_end = tokenizer.next_field(field);
+        if (j < ncol && !parse_field(types_[j], field, chunk.columns[j])) {
+          chunk.error = "Can't parse '" + std::string(field.begin, field.end) +
+                        "' as " + type_name(types_[j]) + " in column " +
+                        std::to_string(j + 1) + ",";
+          return;
+        }
+      }
+      if (j != ncol) {
+        chunk.error = "Expected " + std::to_string(ncol) + " fields, found " +
+                      std::to_string(j) + ",";
+        return;
+      }
+      ++chunk.nrow;
+    }
+  }
+
+  bool parse_field(column_type type, const delim_field& field,
+                   parsed_column& column) const {
+    const bool na = is_na(field);
+    switch (type) {
+      case column_type::real: {
+        double value = NA_REAL;
+        if (!na && !parse_double(field.begin, field.end, value)) {
+          return false;
+        }
+        column.reals.push_back(value);
+        return true;
+      }
+      case column_type::integer: {
+        int value = NA_INTEGER;
+        if (!na && !parse_int(field.begin, field.end, value)) {
+          return false;
+        }
+        column.ints.push_back(value);
+        return true;
+      }
+      case column_type::logical: {
+        int value = NA_LOGICAL;
+        if (!na && !parse_logical(field.begin, field.end, value)) {
+          return false;
+        }
+        column.ints.push_back(value);
+        return true;
+      }
+      case column_type::string:
+        column.strings.push_back(na ? string_field{nullptr, 0, 0, false}
+                                    : make_string(field));
+        return true;
+      default:
+        return true;
+    }
+  }
+
+  static const char* type_name(column_type type) {
+    switch (type) {
+      case column_type::real:
+        return "double";
+      case column_type::integer:
+        return "integer";
+      default:
+        return "logical";
+    }
+  }
+
+  // Gather the chunks of column `j` into one R vector
+  SEXP assemble(size_t j, const std::vector<parsed_chunk>& chunks, R_xlen_t nrow,
+                charsxp_cache& cache) const {
+    const column_type type = types_[j];
+    if (type == column_type::string) {
+      sexp out = safe[Rf_allocVector](STRSXP, nrow);
+      R_xlen_t i = 0;
+      for (const parsed_chunk& chunk : chunks) {
+        for (const string_field& field : chunk.columns[j].strings) {
+          SEXP value =
+              field.begin == nullptr ? NA_STRING : cache.get(field, options_.quote);
+          SET_STRING_ELT(out, i++, value);
+        }
+      }
+      return out;
+    }
+
+    if (type == column_type::real) {
+      sexp out = safe[Rf_allocVector](REALSXP, nrow);
+      double* p = REAL(out);
+      for (const parsed_chunk& chunk : chunks) {
+        const std::vector<double>& values = chunk.columns[j].reals;
+        if (!values.empty()) {
+          std::memcpy(p, values.data(), values.size() * sizeof(double));
+          p += values.size();
+        }
+      }
+      return out;
+    }
+
+    sexp out = safe[Rf_allocVector](type == column_type::integer ? INTSXP : LGLSXP, nrow);
+    int* p = static_cast<int*>(DATAPTR(out));
+    for (const parsed_chunk& chunk : chunks) {
+      const std::vector<int>& values = chunk.columns[j].ints;
+      if (!values.empty()) {
+        std::memcpy(p, values.data(), values.size() * sizeof(int));
+        p += values.size();
+      }
+    }
+    return out;
+  }
+};
+
+}  // namespace detail
+
+/// Parse delimited text, such as CSV or TSV, into a data frame.
+///
+/// `types` gives the type of each column, see `column_type`; an empty vector guesses
+/// all of them. The text is split into chunks of whole rows that are parsed in parallel
+/// when compiled with OpenMP. Strings are created on the calling thread afterwards,
+/// once per distinct value, and are assumed to be UTF-8.
+inline writable::data_frame parse_delim(const char* begin, const char* end,
+                                        std::vector<column_type> types = {},
+                                        const delim_options& options = delim_options()) {
+  return detail::delim_reader(begin, end, std::move(types), options).read();
+}
+
+inline writable::data_frame parse_delim(const std::string& text,
+                                        std::vector<column_type> types = {},
+                                        const delim_options& options = delim_options()) {
+  return parse_delim(text.data(), text.data() + text.size(), std::move(types), options);
+}
+
+/// Read the delimited file at `path` into a data frame, see `parse_delim()`. The file is
+/// memory mapped rather than read into memory.
+inline writable::data_frame read_delim(const std::string& path,
+                                       std::vector<column_type> types = {},
+                                       const delim_options& options = delim_options()) {
+  detail::mapped_file file(path);
+  return parse_delim(file.begin(), file.end(), std::move(types), options);
+}
+
+}  // namespace cpp4r
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <stddef.h>  // for size_t
+
+#include <string>       // for string
+#include <type_traits>  // for true_type
+#include <vector>       // for vector
+
+#include "R_ext/Arith.h"         // for NA_INTEGER
+#include "cpp4r/R.hpp"           // for SEXP, SEXPREC, REAL_RO, INTEGER_RO
+#include "cpp4r/as.hpp"          // for record_traits, enable_if_record
+#include "cpp4r/data_frame.hpp"  // for data_frame
+#include "cpp4r/doubles.hpp"     // for as_doubles
+#include "cpp4r/integers.hpp"    // for as_integers
+#include "cpp4r/list.hpp"        // for list
+#include "cpp4r/protect.hpp"     // for safe
+#include "cpp4r/r_bool.hpp"      // for r_bool
+#include "cpp4r/r_string.hpp"    // for r_string
+#include "cpp4r/r_vector.hpp"    // for type_error
+#include "cpp4r/sexp.hpp"        // for sexp
+#include "cpp4r/strings.hpp"     // for strings
+
+/// Declare the fields of a struct that maps to the rows of a data frame, one column per
+/// field, so that `as_cpp<std::vector<T>>()` and `as_sexp()` can convert between them.
+/// Fields can be floating point, integral, `bool`, `r_bool`, `std::string` or
+/// `r_string`. Use at global scope, with a fully qualified type name.
+///
+/// ```cpp
+/// struct Trade {
+///   double price;
+///   int qty;
+///   std::string sym;
+/// };
+/// CPP4R_RECORD(Trade, price, qty, sym)
+/// ```
+#define CPP4R_RECORD(TYPE, ...)                              \
+  namespace cpp4r {                                          \
+  template <>                                                \
+  struct record_traits<TYPE> : std::true_type {              \
+    template <typename F>                                    \
+    static void for_each_field(F&& f) {                      \
+      CPP4R_RECORD_MAP(CPP4R_RECORD_FIELD, TYPE, __VA_ARGS__) \
+    }                                                        \
+  };                                                         \
+  }
+
+#define CPP4R_RECORD_FIELD(TYPE, FIELD) f(#FIELD, &TYPE::FIELD);
+
+// Apply `m(t, x)` to each of up to 16 arguments `x`
+#define CPP4R_RECORD_NARGS_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, \
+                            _15, _16, N, ...)                                        \
+  N
+#define CPP4R_RECORD_NARGS(...) \
+  CPP4R_RECORD_NARGS_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)
+#define CPP4R_RECORD_CAT_(a, b) a##b
+#define CPP4R_RECORD_CAT(a, b) CPP4R_RECORD_CAT_(a, b)
+#define CPP4R_RECORD_MAP(m, t, ...) \
+  CPP4R_RECORD_CAT(CPP4R_RECORD_MAP_, CPP4R_RECORD_NARGS(__VA_ARGS__))(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_1(m, t, x) m(t, x)
+#define CPP4R_RECORD_MAP_2(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_1(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_3(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_2(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_4(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_3(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_5(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_4(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_6(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_5(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_7(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_6(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_8(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_7(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_9(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_8(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_10(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_9(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_11(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_10(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_12(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_11(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_13(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_12(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_14(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_13(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_15(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_14(m, t, __VA_ARGS__)
+#define CPP4R_RECORD_MAP_16(m, t, x, ...) m(t, x) CPP4R_RECORD_MAP_15(m, t, __VA_ARGS__)
+
+namespace cpp4r {
+
+namespace detail {
+
+/// Conversion of one field of a record from and to a data frame column
+template <typename M, typename = void>
+struct record_field;
+
+template <typename M>
+struct record_field<M, enable_if_floating_point<M>> {
+  template <typename C, typename T>
+  static void read(SEXP x, C& out, M T::*member) {
+    doubles col = as_doubles(x);
+    const double* p = REAL_RO(col.data());
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i].*member = static_cast<M>(p[i]);
+    }
+  }
+
+  template <typename C, typename T>
+  static SEXP write(const C& in, M T::*member) {
+    SEXP out = safe[Rf_allocVector](REALSXP, in.size());
+    double* p = REAL(out);
+    for (size_t i = 0; i < in.size(); ++i) {
+      p[i] = static_cast<double>(in[i].*member);
+    }
+    return out;
+  }
+};
+
+template <typename M>
+struct record_field<M, enable_if_integral<M>> {
+  template <typename C, typename T>
+  static void read(SEXP x, C& out, M T::*member) {
+    integers col = as_integers(x);
+    const int* p = INTEGER_RO(col.data());
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i].*member = static_cast<M>(p[i]);
+    }
+  }
+
+  template <typename C, typename T>
+  static SEXP write(const C& in, M T::*member) {
+    SEXP out = safe[Rf_allocVector](INTSXP, in.size());
+    int* p = INTEGER(out);
+    for (size_t i = 0; i < in.size(); ++i) {
+      p[i] = static_cast<int>(in[i].*member);
+    }
+    return out;
+  }
+};
+
+template <typename M>
+struct record_field<M, enable_if_t<std::is_same<M, bool>::value ||
+                                   std::is_same<M, r_bool>::value>> {
+  template <typename C, typename T>
+  static void read(SEXP x, C& out, M T::*member) {
+    if (detail::r_typeof(x) != LGLSXP) {
+      throw type_error(LGLSXP, detail::r_typeof(x));
+    }
+    // As in `as_cpp<bool>()`, `NA` is false for `bool` fields
+    const int* p = LOGICAL_RO(x);
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i].*member = std::is_same<M, bool>::value ? M(p[i] == 1) : M(p[i]);
+    }
+  }
+
+  template <typename C, typename T>
+  static SEXP write(const C& in, M T::*member) {
+    SEXP out = safe[Rf_allocVector](LGLSXP, in.size());
+    int* p = LOGICAL(out);
+    for (size_t i = 0; i < in.size(); ++i) {
+      p[i] = static_cast<int>(in[i].*member);
+    }
+    return out;
+  }
+};
+
+template <typename M>
+struct record_field<M, enable_if_t<std::is_same<M, std::string>::value ||
+                                   std::is_same<M, r_string>::value>> {
+  template <typename C, typename T>
+  static void read(SEXP x, C& out, M T::*member) {
+    if (detail::r_typeof(x) != STRSXP) {
+      throw type_error(STRSXP, detail::r_typeof(x));
+    }
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i].*member = static_cast<M>(r_string(STRING_ELT(x, i)));
+    }
+  }
+
+  template <typename C, typename T>
+  static SEXP write(const C& in, M T::*member) {
+    sexp out = safe[Rf_allocVector](STRSXP, in.size());
+    for (size_t i = 0; i < in.size(); ++i) {
+      SET_STRING_ELT(out, i, r_string(in[i].*member));
+    }
+    return out;
+  }
+};
+
+template <typename C>
+class record_reader {
+ public:
+  record_reader(const data_frame& df, C& out) : df_(df), out_(out) {}
+
+  template <typename M, typename T>
+  void operator()(const char* name, M T::*member) const {
+    SEXP col = VECTOR_ELT(df_.data(), df_.column_index(name));
+    record_field<M>::read(col, out_, member);
+  }
+
+ private:
+  const data_frame& df_;
+  C& out_;
+};
+
+/// Counts the fields of a record
+class record_field_counter {
+ public:
+  explicit record_field_counter(R_xlen_t& n) : n_(n) {}
+
+  template <typename M, typename T>
+  void operator()(const char*, M T::*) const {
+    ++n_;
+  }
+
+ private:
+  R_xlen_t& n_;
+};
+
+/// Writes each field to its column of `columns` and `names`, both pre-sized to the
+/// number of fields
+template <typename C>
+class record_writer {
+ public:
+  record_writer(const C& in, writable::list& columns, writable::strings& names)
+      : in_(in), columns_(columns), names_(names) {}
+
+  template <typename M, typename T>
+  void operator()(const char* name, M T::*member) const {
+    // Protected until stored, as setting the name can allocate
+    sexp column = record_field<M>::write(in_, member);
+    columns_[pos_] = column;
+    names_[pos_] = name;
+    ++pos_;
+  }
+
+ private:
+  const C& in_;
+  writable::list& columns_;
+  writable::strings& names_;
+  mutable R_xlen_t pos_ = 0;
+};
+
+}  // namespace detail
+
+/// Convert a data frame to a vector of records, filling one field at a time from its
+/// column. Columns are looked up by name once per call.
+template <typename C, typename T = typename std::decay<C>::type::value_type>
+enable_if_record<T, typename std::decay<C>::type> as_cpp(SEXP from) {
+  data_frame df(from);
+  typename std::decay<C>::type out(df.nrow());
+  record_traits<T>::for_each_field(detail::record_reader<decltype(out)>(df, out));
+  return out;
+}
+
+/// Convert a vector of records to a data frame with one column per field
+template <typename Container, typename T = typename Container::value_type>
+enable_if_record<T, SEXP> as_sexp(const Container& from) {
+  R_xlen_t n = 0;
+  record_traits<T>::for_each_field(detail::record_field_counter(n));
+  writable::list columns(n);
+  writable::strings names(n);
+  record_traits<T>::for_each_field(
+      detail::record_writer<Container>(from, columns, names));
+  columns.names() = names;
+  return writable::data_frame(columns, false, static_cast<R_xlen_t>(from.size()));
+}
+
+}  // namespace cpp4r
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <stdexcept>  // for invalid_argument, out_of_range
+#include <string>     // for to_string
+#include <utility>    // for pair
+#include <vector>     // for vector
+
+#include "cpp4r/R.hpp"           // for SEXP, SEXPREC, Rf_allocVector, INTEGER
+#include "cpp4r/data_frame.hpp"  // for data_frame
+#include "cpp4r/factor.hpp"      // for factor
+#include "cpp4r/integers.hpp"    // for integers
+#include "cpp4r/list.hpp"        // for list
+#include "cpp4r/protect.hpp"     // for safe
+#include "cpp4r/sexp.hpp"        // for sexp
+
+namespace cpp4r {
+
+namespace detail {
+
+/// The number of elements of each of the `n_groups` groups of `ids`, 1-based group ids
+/// with `NA` for elements in no group
+inline std::vector<R_xlen_t> count_groups(const int* ids, R_xlen_t n, int n_groups) {
+  if (n_groups < 0) {
+    throw std::invalid_argument("`n_groups` must be non-negative");
+  }
+  std::vector<R_xlen_t> sizes(n_groups, 0);
+  for (R_xlen_t i = 0; i < n; ++i) {
+    const int g = ids[i];
+    if (g == NA_INTEGER) {
+      continue;
+    }
+    if (g < 1 || g > n_groups) {
+      throw std::out_of_range("Group id " + std::to_string(g) + " at position " +
+                              std::to_string(i + 1) + " is not in [1, " +
+                              std::to_string(n_groups) + "]");
+    }
+    ++sizes[g - 1];
+  }
+  return sizes;
+}
+
+/// Write each element of `x` to the next free slot of its group in `out`
+template <typename T>
+inline void scatter_values(const T* x, const int* ids, R_xlen_t n, std::vector<T*> out) {
+  for (R_xlen_t i = 0; i < n; ++i) {
+    const int g = ids[i];
+    if (g != NA_INTEGER) {
+      *out[g - 1]++ = x[i];
+    }
+  }
+}
+
+template <typename T>
+inline std::vector<T*> group_pointers(const std::vector<SEXP>& out, T* (*ptr)(SEXP)) {
+  std::vector<T*> pointers(out.size());
+  for (size_t g = 0; g < out.size(); ++g) {
+    pointers[g] = ptr(out[g]);
+  }
+  return pointers;
+}
+
+inline double* real_data(SEXP x) { return REAL(x); }
+inline int* integer_data(SEXP x) { return INTEGER(x); }
+inline int* logical_data(SEXP x) { return LOGICAL(x); }
+inline Rcomplex* complex_data(SEXP x) { return COMPLEX(x); }
+inline Rbyte* raw_data(SEXP x) { return RAW(x); }
+
+/// Scatter the elements of `x` into `out`, one vector per group, each already
+/// allocated with the type of `x` and the exact size of its group
+inline void scatter_groups(SEXP x, const int* ids, const std::vector<SEXP>& out) {
+  const R_xlen_t n = Rf_xlength(x);
+  switch (r_typeof(x)) {
+    case REALSXP:
+      scatter_values(REAL_RO(x), ids, n, group_pointers(out, real_data));
+      break;
+    case INTSXP:
+      scatter_values(INTEGER_RO(x), ids, n, group_pointers(out, integer_data));
+      break;
+    case LGLSXP:
+      scatter_values(LOGICAL_RO(x), ids, n, group_pointers(out, logical_data));
+      break;
+    case CPLXSXP:
+      scatter_values<Rcomplex>(COMPLEX(x), ids, n, group_pointers(out, complex_data));
+      break;
+    case RAWSXP:
+      scatter_values<Rbyte>(RAW(x), ids, n, group_pointers(out, raw_data));
+      break;
+    case STRSXP:
+    case VECSXP: {
+      // Only the pointers to the existing elements are copied
+      const bool strings = r_typeof(x) == STRSXP;
+      std::vector<R_xlen_t> next(out.size(), 0);
+      for (R_xlen_t i = 0; i < n; ++i) {
+        const int g = ids[i];
+        if (g == NA_INTEGER) {
+          continue;
+        }
+        if (strings) {
+          SET_STRING_ELT(out[g - 1], next[g - 1]++, STRING_ELT(x, i));
+        } else {
+          SET_VECTOR_ELT(out[g - 1], next[g - 1]++, VECTOR_ELT(x, i));
+        }
+      }
+      break;
+    }
+    default:
+      throw std::invalid_argument(
+          "Can only split logical, integer, double, complex, raw, character or list "
+          "vectors");
+  }
+}
+
+/// Allocate one vector like `x` per group, each set with `set(g, vector)` before it is
+/// filled, scatter `x` into them and carry the attributes and names of `x`
+template <typename Set>
+inline void split_into(SEXP x, const int* ids, const std::vector<R_xlen_t>& sizes,
+                       Set set) {
+  const SEXPTYPE type = r_typeof(x);
+  const size_t n_groups = sizes.size();
+  std::vector<SEXP> out(n_groups);
+  for (size_t g = 0; g < n_groups; ++g) {
+    out[g] = safe[Rf_allocVector](type, sizes[g]);
+    set(g, out[g]);
+  }
+  scatter_groups(x, ids, out);
+
+  SEXP names = Rf_getAttrib(x, R_NamesSymbol);
+  std::vector<SEXP> out_names(names == R_NilValue ? 0 : n_groups);
+  for (size_t g = 0; g < out_names.size(); ++g) {
+    out_names[g] = safe[Rf_allocVector](STRSXP, sizes[g]);
+    Rf_setAttrib(out[g], R_NamesSymbol, out_names[g]);
+  }
+  if (names != R_NilValue) {
+    scatter_groups(names, ids, out_names);
+  }
+  for (size_t g = 0; g < n_groups; ++g) {
+    safe[Rf_copyMostAttrib](x, out[g]);
+  }
+}
+
+}  // namespace detail
+
+/// The elements of each group in a single permutation, without copying any values.
+///
+/// `first` holds the 1-based positions of the elements of `group_ids` ordered by group,
+/// stable within groups, and `second` the `n_groups + 1` 0-based offsets of the groups
+/// into `first`, so the elements of group `g` are `first[second[g - 1]]` up to
+/// `first[second[g] - 1]`. Group ids are 1-based, such as factor codes or
+/// `grouping::ids()`; elements with `NA` ids are left out.
+inline std::pair<integers, integers> split_index(const integers& group_ids,
+                                                 int n_groups) {
+  const R_xlen_t n = group_ids.size();
+  const int* ids = INTEGER_RO(group_ids.data());
+  const std::vector<R_xlen_t> sizes = detail::count_groups(ids, n, n_groups);
+
+  writable::integers starts(static_cast<R_xlen_t>(n_groups) + 1);
+  int* p_starts = INTEGER(starts.data());
+  p_starts[0] = 0;
+  for (int g = 0; g < n_groups; ++g) {
+    p_starts[g + 1] = p_starts[g] + static_cast<int>(sizes[g]);
+  }
+
+  writable::integers order(static_cast<R_xlen_t>(p_starts[n_groups]));
+  int* p_order = INTEGER(order.data());
+  std::vector<int> next(p_starts, p_starts + n_groups);
+  for (R_xlen_t i = 0; i < n; ++i) {
+    const int g = ids[i];
+    if (g != NA_INTEGER) {
+      p_order[next[g - 1]++] = static_cast<int>(i + 1);
+    }
+  }
+  return {integers(order), integers(starts)};
+}
+
+/// The rows of `x` divided into `n_groups` data frames by the 1-based `group_ids`, see
+/// `split()`. Columns keep their attributes, such as factor levels.
+inline writable::list split(const data_frame& x, const integers& group_ids,
+                            int n_groups) {
+  const R_xlen_t nrow = x.nrow();
+  if (group_ids.size() != nrow) {
+    throw std::invalid_argument("`group_ids` must have one id per row of `x`");
+  }
+  const int* ids = INTEGER_RO(group_ids.data());
+  const std::vector<R_xlen_t> sizes = detail::count_groups(ids, nrow, n_groups);
+
+  const R_xlen_t ncol = x.ncol();
+  std::vector<SEXP> frames(n_groups);
+  writable::list out(static_cast<R_xlen_t>(n_groups));
+  for (int g = 0; g < n_groups; ++g) {
+    frames[g] = safe[Rf_allocVector](VECSXP, ncol);
+    SET_VECTOR_ELT(out.data(), g, frames[g]);
+  }
+  for (R_xlen_t j = 0; j < ncol; ++j) {
+    detail::split_into(VECTOR_ELT(x, j), ids, sizes, [&](size_t g, SEXP piece) {
+      SET_VECTOR_ELT(frames[g], j, piece);
+    });
+  }
+
+  SEXP names = Rf_getAttrib(x, R_NamesSymbol);
+  sexp cls = safe[Rf_mkString]("data.frame");
+  for (int g = 0; g < n_groups; ++g) {
+    sexp row_names = safe[Rf_allocVector](INTSXP, 2);
+    INTEGER(row_names)[0] = NA_INTEGER;
+    INTEGER(row_names)[1] = -static_cast<int>(sizes[g]);
+    Rf_setAttrib(frames[g], R_NamesSymbol, names);
+    Rf_setAttrib(frames[g], R_RowNamesSymbol, row_names);
+    Rf_setAttrib(frames[g], R_ClassSymbol, cls);
+  }
+  return out;
+}
+
+/// The elements of `x` divided into `n_groups` vectors by the 1-based `group_ids`,
+/// which must have the same length as `x`. Like `split()` in R, elements with `NA` ids
+/// are dropped, and each vector keeps the names and other attributes of `x`.
+///
+/// Group sizes are counted first, so each vector is allocated once at its exact size
+/// and filled in a second pass.
+inline writable::list split(SEXP x, const integers& group_ids, int n_groups) {
+  if (Rf_inherits(x, "data.frame")) {
+    return split(data_frame(x), group_ids, n_groups);
+  }
+  const R_xlen_t n = Rf_xlength(x);
+  if (group_ids.size() != n) {
+    throw std::invalid_argument("`group_ids` must have the same length as `x`");
+  }
+  const int* ids = INTEGER_RO(group_ids.data());
+  const std::vector<R_xlen_t> sizes = detail::count_groups(ids, n, n_groups);
+
+  writable::list out(static_cast<R_xlen_t>(n_groups));
+  SEXP data = out.data();
+  detail::split_into(x, ids, sizes,
+                     [&](size_t g, SEXP piece) { SET_VECTOR_ELT(data, g, piece); });
+  return out;
+}
+
+/// The elements or rows of `x` divided by the levels of `f`, with the output named by
+/// the levels
+inline writable::list split(SEXP x, const factor& f) {
+  writable::list out = split(x, f, static_cast<int>(f.nlevels()));
+  out.names() = f.levels();
+  return out;
+}
+
+}  // namespace cpp4r
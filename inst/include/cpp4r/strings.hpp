@@ -150,25 +150,18 @@ inline r_vector<r_string>::r_vector(std::initializer_list<r_string> il)
 
 typedef r_vector<r_string> strings;
 
+/// Push `value.value()` and buffer its name. The names attribute is only allocated and
+/// filled when the vector is converted to a `SEXP` or its attributes are accessed, so
+/// building a named vector costs about the same as an unnamed one.
 template <typename T>
 inline void r_vector<T>::push_back(const named_arg& value) {
-  push_back(value.value());
+  push_back_value(value.value(), typename std::is_same<T, SEXP>::type{});
 
-  SEXP current_names = this->names();
-  R_xlen_t current_size = this->size();
-
-  if (Rf_xlength(current_names) == 0) {
-    // Create names vector only once
-    cpp4r::writable::strings new_nms(current_size);
-    this->names() = new_nms;
-    current_names = this->names();
+  if (pending_names_ == nullptr) {
+    pending_names_.reset(new detail::pending_names());
   }
-
-  // Direct access to avoid creating wrapper object
-  // value.name() returns const char*, so use it directly
-  const char* name_str = value.name();
-  SET_STRING_ELT(current_names, current_size - 1,
-                 Rf_mkCharLenCE(name_str, strlen(name_str), CE_UTF8));
+  pending_names_->chars += value.name();
+  pending_names_->ends.emplace_back(length_ - 1, pending_names_->chars.size());
 }
 
 }  // namespace writable
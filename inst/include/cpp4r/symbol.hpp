@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>        // for size_t
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+
+#include "cpp4r/R.hpp"        // for SEXP, SEXPREC, Rf_install, PRINTNAME
+#include "cpp4r/protect.hpp"  // for safe
+
+namespace cpp4r {
+
+/// An R symbol, such as the name of an attribute, a variable or an argument.
+///
+/// Symbols are never garbage collected, so a `symbol` needs no protection and can be
+/// kept for the lifetime of the process, e.g. in a `static` variable.
+class symbol {
+ public:
+  explicit symbol(const char* name) : data_(safe[Rf_install](name)) {}
+  explicit symbol(const std::string& name) : symbol(name.c_str()) {}
+
+  /// Wrap `x`, which must already be a symbol
+  explicit symbol(SEXP x) noexcept : data_(x) {}
+
+  const char* c_str() const { return CHAR(PRINTNAME(data_)); }
+  std::string str() const { return c_str(); }
+
+  operator SEXP() const noexcept { return data_; }
+  SEXP data() const noexcept { return data_; }
+
+  bool operator==(const symbol& other) const noexcept { return data_ == other.data_; }
+  bool operator!=(const symbol& other) const noexcept { return data_ != other.data_; }
+
+ private:
+  SEXP data_;
+};
+
+namespace detail {
+
+/// The symbol of the string literal `name`, installed on first use and cached by the
+/// address of the literal, which never changes, so later lookups hash a pointer instead
+/// of the characters and skip `Rf_install()` and its `unwind_protect()`
+inline SEXP literal_symbol(const char* name) {
+  static std::unordered_map<const char*, SEXP> cache;
+  auto it = cache.find(name);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  SEXP out = safe[Rf_install](name);
+  cache.emplace(name, out);
+  return out;
+}
+
+}  // namespace detail
+
+namespace literals {
+
+/// The symbol `name`, resolved once per literal and process
+inline symbol operator""_sym(const char* name, std::size_t) {
+  return symbol(detail::literal_symbol(name));
+}
+
+}  // namespace literals
+
+using namespace literals;
+
+}  // namespace cpp4r
@@ -0,0 +1,445 @@
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for int64_t
+
+#include <cmath>      // for fabs
+#include <cstdio>     // for snprintf, fopen, fwrite, fclose
+#include <cstdlib>    // for strtod
+#include <cstring>    // for strpbrk
+#include <stdexcept>  // for invalid_argument, runtime_error
+#include <string>     // for string
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#if defined(_WIN32)
+#include <io.h>  // for _write
+#else
+#include <errno.h>   // for errno, EINTR
+#include <fcntl.h>   // for open, O_WRONLY, O_CREAT, O_TRUNC
+#include <unistd.h>  // for write, close
+#endif
+
+#if defined(_OPENMP)
+#include <omp.h>  // for omp_get_max_threads, omp_get_thread_num
+#endif
+
+#ifdef CPP4R_USE_FMT
+#define FMT_HEADER_ONLY
+#include <iterator>  // for back_inserter
+
+#include "fmt/core.h"
+#endif
+
+#include "R_ext/Arith.h"         // for NA_INTEGER, NA_LOGICAL, ISNA, ISNAN, R_PosInf
+#include "cpp4r/R.hpp"           // for SEXP, SEXPREC, REAL_RO, INTEGER_RO
+#include "cpp4r/data_frame.hpp"  // for data_frame
+#include "cpp4r/factor.hpp"      // for charsxp_table
+#include "cpp4r/protect.hpp"     // for safe
+
+namespace cpp4r {
+
+struct write_delim_options {
+  char delim = ',';
+  char quote = '"';
+  bool header = true;
+  /// Written for missing values. Strings equal to it are quoted to tell them apart.
+  std::string na = "NA";
+  std::string eol = "\n";
+  /// Number of threads, 0 for the OpenMP default
+  int num_threads = 0;
+};
+
+namespace detail {
+
+inline void append_int(std::string& out, int64_t x) {
+  char buffer[24];
+  char* end = buffer + sizeof(buffer);
+  char* p = end;
+  uint64_t u = x < 0 ? 0 - static_cast<uint64_t>(x) : static_cast<uint64_t>(x);
+  do {
+    *--p = static_cast<char>('0' + u % 10);
+    u /= 10;
+  } while (u != 0);
+  if (x < 0) {
+    *--p = '-';
+  }
+  out.append(p, end - p);
+}
+
+/// Append the shortest decimal representation of `x` that reads back as `x`. Whole
+/// numbers are written as integers; with `CPP4R_USE_FMT` the other numbers use fmt's
+/// shortest round trip formatting, otherwise the first of 15, 16 or 17 significant
+/// digits that round trips.
+inline void append_double(std::string& out, double x) {
+  if (std::fabs(x) < 1e15 && x == static_cast<double>(static_cast<int64_t>(x))) {
+    append_int(out, static_cast<int64_t>(x));
+    return;
+  }
+  if (ISNAN(x)) {
+    out += "NaN";
+    return;
+  }
+  if (x == R_PosInf || x == R_NegInf) {
+    out += x > 0 ? "Inf" : "-Inf";
+    return;
+  }
+#ifdef CPP4R_USE_FMT
+  fmt::format_to(std::back_inserter(out), "{}", x);
+#else
+  char buffer[32];
+  int n = 0;
+  for (int digits = 15; digits <= 17; ++digits) {
+    n = std::snprintf(buffer, sizeof(buffer), "%.*g", digits, x);
+    if (std::strtod(buffer, nullptr) == x) {
+      break;
+    }
+  }
+  out.append(buffer, n);
+#endif
+}
+
+/// The characters of `x` in UTF-8, translating only when needed
+inline const char* utf8_chars(SEXP x) {
+  return Rf_getCharCE(x) == CE_UTF8 ? CHAR(x) : safe[Rf_translateCharUTF8](x);
+}
+
+/// Write all of `data` to the file descriptor `fd`, retrying interrupted writes
+inline bool write_fd(int fd, const char* data, size_t size) noexcept {
+  while (size > 0) {
+#if defined(_WIN32)
+    const size_t chunk = size < (1u << 30) ? size : 1u << 30;
+    int n = _write(fd, data, static_cast<unsigned int>(chunk));
+    if (n < 0) {
+      return false;
+    }
+#else
+    ssize_t n = ::write(fd, data, size);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+#endif
+    data += n;
+    size -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+/// A file written with large unbuffered writes
+class output_file {
+ public:
+  explicit output_file(const std::string& path) : path_(path) {
+#if defined(_WIN32)
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+      throw std::runtime_error("Can't open '" + path + "' for writing");
+    }
+#else
+    fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd_ < 0) {
+      throw std::runtime_error("Can't open '" + path + "' for writing");
+    }
+#endif
+  }
+
+  ~output_file() {
+#if defined(_WIN32)
+    if (file_ != nullptr) {
+      std::fclose(file_);
+    }
+#else
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+#endif
+  }
+
+  output_file(const output_file&) = delete;
+  output_file& operator=(const output_file&) = delete;
+
+  bool write(const char* data, size_t size) noexcept {
+#if defined(_WIN32)
+    return std::fwrite(data, 1, size, file_) == size;
+#else
+    return write_fd(fd_, data, size);
+#endif
+  }
+
+  void close() {
+#if defined(_WIN32)
+    bool ok = std::fclose(file_) == 0;
+    file_ = nullptr;
+#else
+    bool ok = ::close(fd_) == 0;
+    fd_ = -1;
+#endif
+    if (!ok) {
+      throw std::runtime_error("Can't write to '" + path_ + "'");
+    }
+  }
+
+  const std::string& path() const noexcept { return path_; }
+
+ private:
+  std::string path_;
+#if defined(_WIN32)
+  FILE* file_ = nullptr;
+#else
+  int fd_ = -1;
+#endif
+};
+
+class string_output {
+ public:
+  bool write(const char* data, size_t size) {
+    value_.append(data, size);
+    return true;
+  }
+
+  std::string& value() noexcept { return value_; }
+
+ private:
+  std::string value_;
+};
+
+/// Formats the rows of a data frame in blocks. Everything that needs R is done in the
+/// constructor on the calling thread, so that blocks can be formatted on any thread.
+class delim_formatter {
+ public:
+  static R_xlen_t block_rows() noexcept { return 8192; }
+
+  delim_formatter(const data_frame& x, const write_delim_options& options)
+      : options_(options), nrow_(x.nrow()) {
+    const R_xlen_t ncol = x.ncol();
+    SEXP names = Rf_getAttrib(x, R_NamesSymbol);
+    columns_.resize(ncol);
+    for (R_xlen_t j = 0; j < ncol; ++j) {
+      init_column(columns_[j], VECTOR_ELT(x, j));
+      if (options.header) {
+        if (j > 0) {
+          header_ += options.delim;
+        }
+        header_ += quoted(safe[Rf_translateCharUTF8](STRING_ELT(names, j)));
+      }
+    }
+    if (options.header) {
+      header_ += options.eol;
+    }
+  }
+
+  const std::string& header() const noexcept { return header_; }
+
+  R_xlen_t blocks() const noexcept { return (nrow_ + block_rows() - 1) / block_rows(); }
+
+  /// Format the rows of `block` into `out`, replacing its contents
+  void format(R_xlen_t block, std::string& out) const {
+    out.clear();
+    const R_xlen_t begin = block * block_rows();
+    const R_xlen_t end = begin + block_rows() < nrow_ ? begin + block_rows() : nrow_;
+    for (R_xlen_t i = begin; i < end; ++i) {
+      for (size_t j = 0; j < columns_.size(); ++j) {
+        if (j > 0) {
+          out += options_.delim;
+        }
+        format_cell(columns_[j], i, out);
+      }
+      out += options_.eol;
+    }
+  }
+
+ private:
+  enum class kind { real, integer, logical, string };
+
+  // Typed access to a column. Strings and factor levels are formatted once per
+  // distinct `CHARSXP` and referred to by their index into `cache`.
+  struct column {
+    kind type;
+    const double* reals;
+    const int* ints;
+    std::vector<int> ids;
+    std::vector<std::string> cache;
+  };
+
+  const write_delim_options& options_;
+  R_xlen_t nrow_;
+  std::vector<column> columns_;
+  std::string header_;
+
+  // Quote strings that contain the delimiter, quotes or newlines, or read as missing
+  std::string quoted(const char* value) const {
+    const char specials[] = {options_.delim, options_.quote, '\n', '\r', '\0'};
+    if (std::strpbrk(value, specials) == nullptr && value != options_.na) {
+      return value;
+    }
+    std::string out(1, options_.quote);
+    for (const char* p = value; *p != '\0'; ++p) {
+      if (*p == options_.quote) {
+        out += options_.quote;
+      }
+      out += *p;
+    }
+    out += options_.quote;
+    return out;
+  }
+
+  int cache_id(charsxp_table& table, column& col, SEXP value) {
+    if (value == NA_STRING) {
+      return -1;
+    }
+    int id = table.find(value);
+    if (id < 0) {
+      id = static_cast<int>(col.cache.size());
+      col.cache.push_back(quoted(safe[Rf_translateCharUTF8](value)));
+      table.insert(value, id);
+    }
+    return id;
+  }
+
+  void init_column(column& col, SEXP x) {
+    col.reals = nullptr;
+    col.ints = nullptr;
+    switch (r_typeof(x)) {
+      case REALSXP:
+        col.type = kind::real;
+        col.reals = real_ptr(x);
+        break;
+      case LGLSXP:
+        col.type = kind::logical;
+        col.ints = logical_ptr(x);
+        break;
+      case INTSXP:
+        if (Rf_inherits(x, "factor")) {
+          // Level codes are 1-based, id 0 is never used
+          col.type = kind::string;
+          SEXP levels = Rf_getAttrib(x, R_LevelsSymbol);
+          const R_xlen_t n_levels = Rf_xlength(levels);
+          col.cache.resize(1);
+          for (R_xlen_t i = 0; i < n_levels; ++i) {
+            const char* level = safe[Rf_translateCharUTF8](STRING_ELT(levels, i));
+            col.cache.push_back(quoted(level));
+          }
+          const int* codes = integer_ptr(x);
+          col.ids.resize(nrow_);
+          for (R_xlen_t i = 0; i < nrow_; ++i) {
+            const int code = codes[i];
+            col.ids[i] = code != NA_INTEGER && code >= 1 && code <= n_levels ? code : -1;
+          }
+        } else {
+          col.type = kind::integer;
+          col.ints = integer_ptr(x);
+        }
+        break;
+      case STRSXP: {
+        col.type = kind::string;
+        charsxp_table table(1024);
+        col.ids.resize(nrow_);
+        for (R_xlen_t i = 0; i < nrow_; ++i) {
+          col.ids[i] = cache_id(table, col, STRING_ELT(x, i));
+        }
+        break;
+      }
+      default:
+        throw std::invalid_argument(std::string("Can't write a column of type '") +
+                                    Rf_type2char(r_typeof(x)) + "'");
+    }
+  }
+
+  void format_cell(const column& col, R_xlen_t i, std::string& out) const {
+    switch (col.type) {
+      case kind::real:
+        if (ISNA(col.reals[i])) {
+          out += options_.na;
+        } else {
+          append_double(out, col.reals[i]);
+        }
+        break;
+      case kind::integer:
+        if (col.ints[i] == NA_INTEGER) {
+          out += options_.na;
+        } else {
+          append_int(out, col.ints[i]);
+        }
+        break;
+      case kind::logical:
+        if (col.ints[i] == NA_LOGICAL) {
+          out += options_.na;
+        } else {
+          out += col.ints[i] ? "TRUE" : "FALSE";
+        }
+        break;
+      case kind::string:
+        if (col.ids[i] < 0) {
+          out += options_.na;
+        } else {
+          out += col.cache[col.ids[i]];
+        }
+        break;
+    }
+  }
+};
+
+/// Format all blocks of `formatter` and hand them to `output` in order. Blocks are
+/// formatted in parallel when compiled with OpenMP; the ordered section then lets one
+/// thread at a time write its block while the others keep formatting, so each thread
+/// only holds one block.
+template <typename Output>
+inline bool write_blocks(const delim_formatter& formatter, Output& output,
+                         int num_threads) {
+  bool ok = output.write(formatter.header().data(), formatter.header().size());
+  const R_xlen_t n_blocks = formatter.blocks();
+#if defined(_OPENMP)
+  const int n_threads = num_threads > 0 ? num_threads : omp_get_max_threads();
+  std::vector<std::string> buffers(n_threads);
+#pragma omp parallel for schedule(dynamic, 1) ordered num_threads(n_threads)
+#else
+  (void)num_threads;
+  std::vector<std::string> buffers(1);
+#endif
+  for (R_xlen_t block = 0; block < n_blocks; ++block) {
+#if defined(_OPENMP)
+    std::string& buffer = buffers[omp_get_thread_num()];
+#else
+    std::string& buffer = buffers[0];
+#endif
+    formatter.format(block, buffer);
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+    {
+      ok = ok && output.write(buffer.data(), buffer.size());
+    }
+  }
+  return ok;
+}
+
+}  // namespace detail
+
+/// Write `x` as delimited text, such as CSV, to the file at `path`.
+///
+/// Strings are converted to UTF-8 and quoted once per distinct value up front, then
+/// blocks of rows are formatted in parallel when compiled with OpenMP and written in
+/// order with one `write()` call per block. Doubles are written with the fewest digits
+/// that read back to the same value.
+inline void write_delim(const data_frame& x, const std::string& path,
+                        const write_delim_options& options = write_delim_options()) {
+  detail::delim_formatter formatter(x, options);
+  detail::output_file file(path);
+  if (!detail::write_blocks(formatter, file, options.num_threads)) {
+    throw std::runtime_error("Can't write to '" + path + "'");
+  }
+  file.close();
+}
+
+/// `x` as delimited text, see `write_delim()`
+inline std::string format_delim(
+    const data_frame& x, const write_delim_options& options = write_delim_options()) {
+  detail::delim_formatter formatter(x, options);
+  detail::string_output output;
+  detail::write_blocks(formatter, output, options.num_threads);
+  return std::move(output.value());
+}
+
+}  // namespace cpp4r